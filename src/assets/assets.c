@@ -5,6 +5,7 @@
 #include "assets/xml.h"
 #include "core/dir.h"
 #include "core/log.h"
+#include "core/trace.h"
 #include "graphics/renderer.h"
 
 #include <stdlib.h>
@@ -23,6 +24,7 @@ void assets_init(int force_reload, color_t **main_images, int *main_image_widths
         return;
     }
 
+    TRACE_BEGIN("load extra assets");
     graphics_renderer()->free_image_atlas(ATLAS_EXTRA_ASSET);
 
     const dir_listing *xml_files = dir_find_files_with_extension(ASSETS_DIRECTORY, "xml");
@@ -50,6 +52,7 @@ void assets_init(int force_reload, color_t **main_images, int *main_image_widths
     data.asset_lookup[ASSET_AQUEDUCT_WITH_WATER] = assets_get_image_id("Logistics", "Aqueduct_Bridge_Left_Water");
     data.asset_lookup[ASSET_AQUEDUCT_WITHOUT_WATER] = assets_get_image_id("Logistics", "Aqueduct_Bridge_Left_Empty");
     data.asset_lookup[ASSET_GOLD_SHIELD] = assets_get_image_id("UI", "GoldShield");
+    TRACE_END();
 }
 
 int assets_load_single_group(const char *file_name, color_t **main_images, int *main_image_widths)
@@ -10,16 +10,20 @@
 #include "building/properties.h"
 #include "building/rotation.h"
 #include "building/storage.h"
+#include "building/tourism.h"
 #include "city/buildings.h"
 #include "city/finance.h"
+#include "city/labor.h"
 #include "city/population.h"
 #include "city/warning.h"
 #include "core/array.h"
 #include "core/calc.h"
+#include "core/hash.h"
 #include "core/log.h"
 #include "figure/figure.h"
 #include "figure/formation_legion.h"
 #include "game/difficulty.h"
+#include "game/replay.h"
 #include "game/save_version.h"
 #include "game/undo.h"
 #include "map/building_tiles.h"
@@ -31,12 +35,25 @@
 #include "map/terrain.h"
 #include "map/tiles.h"
 
+#include <stdlib.h>
+#include <string.h>
+
 #define BUILDING_ARRAY_SIZE_STEP 2000
+#define BUILDING_INDEX_SIZE_STEP 500
+
+typedef struct {
+    int *ids;
+    int size;
+    int capacity;
+    int valid;
+} building_index_list;
 
 static struct {
     array(building) buildings;
     building *first_of_type[BUILDING_TYPE_MAX];
     building *last_of_type[BUILDING_TYPE_MAX];
+    building_index_list indices[BUILDING_INDEX_MAX];
+    hash_cache state_hash;
 } data;
 
 static struct {
@@ -93,6 +110,137 @@ building *building_first_of_type(building_type type)
     return data.first_of_type[type];
 }
 
+static int is_tourism_type(building_type type)
+{
+    switch (type) {
+        case BUILDING_TAVERN:
+        case BUILDING_THEATER:
+        case BUILDING_AMPHITHEATER:
+        case BUILDING_ARENA:
+        case BUILDING_COLOSSEUM:
+        case BUILDING_HIPPODROME:
+        case BUILDING_GRAND_TEMPLE_CERES:
+        case BUILDING_GRAND_TEMPLE_NEPTUNE:
+        case BUILDING_GRAND_TEMPLE_MERCURY:
+        case BUILDING_GRAND_TEMPLE_MARS:
+        case BUILDING_GRAND_TEMPLE_VENUS:
+        case BUILDING_PANTHEON:
+            return 1;
+        default:
+            return 0;
+    }
+}
+
+static int belongs_to_index(building_index index, const building *b)
+{
+    building_type type = b->type;
+    switch (index) {
+        case BUILDING_INDEX_ALL:
+            return 1;
+        case BUILDING_INDEX_FLAMMABLE:
+            return type != BUILDING_BURNING_RUIN && !b->fire_proof;
+        case BUILDING_INDEX_WORKPLACES:
+            return city_labor_category_for_building_type(type) >= 0;
+        case BUILDING_INDEX_DESIRABILITY:
+            // Venus bonuses can give houses and statues desirability even if their base value is zero
+            return model_get_building(type)->desirability_value != 0 ||
+                building_is_house(type) || building_is_statue_garden_temple(type);
+        case BUILDING_INDEX_TOURISM:
+            return is_tourism_type(type);
+        default:
+            return 0;
+    }
+}
+
+static int index_position(const building_index_list *list, int building_id)
+{
+    int low = 0;
+    int high = list->size;
+    while (low < high) {
+        int middle = (low + high) / 2;
+        if (list->ids[middle] < building_id) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    return low;
+}
+
+static void add_to_indices(const building *b)
+{
+    if (belongs_to_index(BUILDING_INDEX_TOURISM, b)) {
+        building_tourism_invalidate_venues();
+    }
+    if (building_industry_is_producer(b->type)) {
+        building_industry_invalidate_production();
+    }
+    for (building_index index = 0; index < BUILDING_INDEX_MAX; index++) {
+        building_index_list *list = &data.indices[index];
+        if (!list->valid || !belongs_to_index(index, b)) {
+            continue;
+        }
+        int position = index_position(list, b->id);
+        if (position < list->size && list->ids[position] == b->id) {
+            continue;
+        }
+        if (list->size == list->capacity) {
+            int *ids = realloc(list->ids, sizeof(int) * (list->capacity + BUILDING_INDEX_SIZE_STEP));
+            if (!ids) {
+                log_error("Unable to grow a building index, falling back to a full scan", 0, 0);
+                list->valid = 0;
+                continue;
+            }
+            list->ids = ids;
+            list->capacity += BUILDING_INDEX_SIZE_STEP;
+        }
+        memmove(&list->ids[position + 1], &list->ids[position], sizeof(int) * (list->size - position));
+        list->ids[position] = b->id;
+        list->size++;
+    }
+}
+
+static void remove_from_indices(const building *b)
+{
+    if (belongs_to_index(BUILDING_INDEX_TOURISM, b)) {
+        building_tourism_invalidate_venues();
+    }
+    if (building_industry_is_producer(b->type)) {
+        building_industry_invalidate_production();
+    }
+    for (building_index index = 0; index < BUILDING_INDEX_MAX; index++) {
+        building_index_list *list = &data.indices[index];
+        if (!list->valid) {
+            continue;
+        }
+        int position = index_position(list, b->id);
+        if (position < list->size && list->ids[position] == b->id) {
+            list->size--;
+            memmove(&list->ids[position], &list->ids[position + 1], sizeof(int) * (list->size - position));
+        }
+    }
+}
+
+static void clear_indices(void)
+{
+    for (building_index index = 0; index < BUILDING_INDEX_MAX; index++) {
+        data.indices[index].size = 0;
+        data.indices[index].valid = 1;
+    }
+    building_tourism_invalidate_venues();
+    building_industry_invalidate_production();
+}
+
+int building_index_next(building_index index, int building_id)
+{
+    const building_index_list *list = &data.indices[index];
+    if (!list->valid) {
+        return building_id + 1 < data.buildings.size ? building_id + 1 : 0;
+    }
+    int position = index_position(list, building_id + 1);
+    return position < list->size ? list->ids[position] : 0;
+}
+
 building *building_main(building *b)
 {
     for (int guard = 0; guard < 9; guard++) {
@@ -111,6 +259,7 @@ building *building_next(building *b)
 
 static void fill_adjacent_types(building *b)
 {
+    add_to_indices(b);
     building *first = data.first_of_type[b->type];
     building *last = data.last_of_type[b->type];
     if (!first || !last) {
@@ -147,6 +296,7 @@ static void fill_adjacent_types(building *b)
 
 static void remove_adjacent_types(building *b)
 {
+    remove_from_indices(b);
     building *first = data.first_of_type[b->type];
     building *last = data.last_of_type[b->type];
     if (b == first && b == last) {
@@ -191,8 +341,6 @@ building *building_create(building_type type, int x, int y)
     b->sentiment.house_happiness = 100;
     b->distance_from_entry = 0;
 
-    fill_adjacent_types(b);
-
     // house size
     b->house_size = 0;
     if (type >= BUILDING_HOUSE_SMALL_TENT && type <= BUILDING_HOUSE_MEDIUM_INSULA) {
@@ -293,6 +441,8 @@ building *building_create(building_type type, int x, int y)
     b->fire_proof = props->fire_proof;
     b->is_adjacent_to_water = map_terrain_is_adjacent_to_water(x, y, b->size);
 
+    fill_adjacent_types(b);
+
     // init expanded data
     b->house_tavern_wine_access = 0;
     b->house_tavern_meat_access = 0;
@@ -545,6 +695,7 @@ int building_is_fort(building_type type)
 
 int building_mothball_toggle(building *b)
 {
+    game_replay_record_command(REPLAY_COMMAND_MOTHBALL_BUILDING, b->id, 0);
     if (b->state == BUILDING_STATE_IN_USE) {
         b->state = BUILDING_STATE_MOTHBALLED;
         b->num_workers = 0;
@@ -570,6 +721,7 @@ int building_mothball_set(building *b, int mothball)
 
 unsigned char building_stockpiling_toggle(building *b)
 {
+    game_replay_record_command(REPLAY_COMMAND_STOCKPILING_TOGGLE, b->id, 0);
     b->data.industry.is_stockpiling = !b->data.industry.is_stockpiling;
     return b->data.industry.is_stockpiling;
 }
@@ -652,6 +804,7 @@ void building_clear_all(void)
 {
     memset(data.first_of_type, 0, sizeof(data.first_of_type));
     memset(data.last_of_type, 0, sizeof(data.last_of_type));
+    clear_indices();
 
     if (!array_init(data.buildings, BUILDING_ARRAY_SIZE_STEP, initialize_new_building, building_in_use) ||
         !array_next(data.buildings)) { // Ignore first building
@@ -666,14 +819,16 @@ void building_clear_all(void)
 void building_save_state(buffer *buf, buffer *highest_id, buffer *highest_id_ever,
     buffer *sequence, buffer *corrupt_houses)
 {
-    int buf_size = 4 + data.buildings.size * BUILDING_STATE_CURRENT_BUFFER_SIZE;
-    uint8_t *buf_data = malloc(buf_size);
-    buffer_init(buf, buf_data, buf_size);
-    buffer_write_i32(buf, BUILDING_STATE_CURRENT_BUFFER_SIZE);
-    building *b;
-    array_foreach(data.buildings, b)
-    {
-        building_state_save_to_buffer(buf, b);
+    if (buf) {
+        int buf_size = 4 + data.buildings.size * BUILDING_STATE_CURRENT_BUFFER_SIZE;
+        uint8_t *buf_data = malloc(buf_size);
+        buffer_init(buf, buf_data, buf_size);
+        buffer_write_i32(buf, BUILDING_STATE_CURRENT_BUFFER_SIZE);
+        building *b;
+        array_foreach(data.buildings, b)
+        {
+            building_state_save_to_buffer(buf, b);
+        }
     }
     buffer_write_i32(highest_id, data.buildings.size);
     buffer_write_i32(highest_id_ever, data.buildings.size);
@@ -684,6 +839,23 @@ void building_save_state(buffer *buf, buffer *highest_id, buffer *highest_id_eve
     buffer_write_i32(corrupt_houses, extra.unfixable_houses);
 }
 
+static void write_building_state(buffer *buf, const void *item)
+{
+    building_state_save_to_buffer(buf, item);
+}
+
+uint64_t building_hash_state(uint64_t seed)
+{
+    if (!hash_cache_start(&data.state_hash, data.buildings.size, sizeof(building), BUILDING_STATE_CURRENT_BUFFER_SIZE)) {
+        log_error("Out of memory for the building state hash", 0, 0);
+        return 0;
+    }
+    for (int i = 0; i < data.buildings.size; i++) {
+        hash_cache_add_item(&data.state_hash, i, array_item(data.buildings, i), write_building_state);
+    }
+    return hash_cache_finish(&data.state_hash, seed);
+}
+
 void building_load_state(buffer *buf, buffer *sequence, buffer *corrupt_houses, int save_version)
 {
     int building_buf_size = BUILDING_STATE_ORIGINAL_BUFFER_SIZE;
@@ -703,6 +875,7 @@ void building_load_state(buffer *buf, buffer *sequence, buffer *corrupt_houses,
 
     memset(data.first_of_type, 0, sizeof(data.first_of_type));
     memset(data.last_of_type, 0, sizeof(data.last_of_type));
+    clear_indices();
 
     int highest_id_in_use = 0;
 
@@ -3,7 +3,6 @@
 
 #include "building/type.h"
 #include "core/buffer.h"
-#include "core/time.h"
 #include "game/resource.h"
 
 typedef struct building {
@@ -12,7 +11,7 @@ typedef struct building {
     struct building *prev_of_type;
     struct building *next_of_type;
 
-    time_millis last_update;
+    unsigned int last_update;
 
     unsigned char state;
     unsigned char faction_id;
@@ -20,9 +19,9 @@ typedef struct building {
     unsigned char size;
     unsigned char house_is_merged;
     unsigned char house_size;
-    unsigned char x;
-    unsigned char y;
-    short grid_offset;
+    unsigned short x;
+    unsigned short y;
+    int grid_offset;
     building_type type;
     union {
         short house_level;
@@ -41,8 +40,8 @@ typedef struct building {
     short distance_from_entry;
     short house_highest_population;
     short house_unreachable_ticks;
-    unsigned char road_access_x;
-    unsigned char road_access_y;
+    unsigned short road_access_x;
+    unsigned short road_access_y;
     short figure_id;
     short figure_id2; // labor seeker or market supplier
     short immigrant_figure_id;
@@ -179,6 +178,15 @@ typedef struct building {
     unsigned char accepted_goods[RESOURCE_MAX];
 } building;
 
+typedef enum {
+    BUILDING_INDEX_ALL = 0,
+    BUILDING_INDEX_FLAMMABLE = 1,
+    BUILDING_INDEX_WORKPLACES = 2,
+    BUILDING_INDEX_DESIRABILITY = 3,
+    BUILDING_INDEX_TOURISM = 4,
+    BUILDING_INDEX_MAX = 5
+} building_index;
+
 building *building_get(int id);
 
 int building_dist(int x, int y, int w, int h, building *b);
@@ -192,6 +200,16 @@ int building_find(building_type type);
 
 building *building_first_of_type(building_type type);
 
+/**
+ * Gets the next building in a category index, in building id order.
+ * Membership only depends on the building type and fire proofing, so callers still need to check the building state.
+ * The index may be changed while iterating: buildings that are added or removed are handled correctly.
+ * @param index The category to iterate over
+ * @param building_id The current building id, or 0 to get the first building
+ * @return The id of the next building in the category, or 0 if there are no more buildings
+ */
+int building_index_next(building_index index, int building_id);
+
 void building_change_type(building *b, building_type type);
 
 building *building_main(building *b);
@@ -255,4 +273,11 @@ void building_save_state(buffer *buf, buffer *highest_id, buffer *highest_id_eve
 
 void building_load_state(buffer *buf, buffer *sequence, buffer *corrupt_houses, int save_version);
 
+/**
+ * Hashes the saved state of all buildings. Only the buildings that changed since the last call are saved again.
+ * @param seed Seed of the hash
+ * @return Hash of the buildings
+ */
+uint64_t building_hash_state(uint64_t seed);
+
 #endif // BUILDING_BUILDING_H
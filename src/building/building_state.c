@@ -3,6 +3,7 @@
 #include "building/roadblock.h"
 #include "figure/figure.h"
 #include "game/save_version.h"
+#include "map/grid.h"
 
 #define TYPE_DATA_ORIGINAL_BUFFER_SIZE 42
 #define TYPE_DATA_CURRENT_BUFFER_SIZE 26
@@ -202,6 +203,13 @@ void building_state_save_to_buffer(buffer *buf, const building *b)
         buffer_write_u8(buf, b->accepted_goods[i]);
     }
 
+    // coordinates for grids larger than 162x162
+    buffer_write_u16(buf, b->x);
+    buffer_write_u16(buf, b->y);
+    buffer_write_i32(buf, b->grid_offset);
+    buffer_write_u16(buf, b->road_access_x);
+    buffer_write_u16(buf, b->road_access_y);
+
     // New building state code should always be added at the end to preserve savegame retrocompatibility
     // Also, don't forget to update BUILDING_STATE_CURRENT_BUFFER_SIZE and if possible, add a new macro like
     // BUILDING_STATE_NEW_FEATURE_BUFFER_SIZE with the full building state buffer size including all added features
@@ -414,7 +422,7 @@ void building_state_load_from_buffer(buffer *buf, building *b, int building_buf_
     b->house_size = buffer_read_u8(buf);
     b->x = buffer_read_u8(buf);
     b->y = buffer_read_u8(buf);
-    b->grid_offset = buffer_read_i16(buf);
+    b->grid_offset = map_grid_offset_from_saved(buffer_read_i16(buf));
     b->type = buffer_read_i16(buf);
     if (b->type == BUILDING_WAREHOUSE_SPACE) {
         b->subtype.warehouse_resource_id = resource_remap(buffer_read_i16(buf));
@@ -557,6 +565,14 @@ void building_state_load_from_buffer(buffer *buf, building *b, int building_buf_
         }
     }
 
+    if (save_version > SAVE_GAME_LAST_FIXED_GRID_SIZE) {
+        b->x = buffer_read_u16(buf);
+        b->y = buffer_read_u16(buf);
+        b->grid_offset = map_grid_offset_from_saved(buffer_read_i32(buf));
+        b->road_access_x = buffer_read_u16(buf);
+        b->road_access_y = buffer_read_u16(buf);
+    }
+
     if (
         (b->type == BUILDING_LIGHTHOUSE || b->type == BUILDING_CARAVANSERAI) && 
         b->figure_id2 && 
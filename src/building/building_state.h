@@ -13,7 +13,9 @@
 #define BUILDING_STATE_STRIKES (BUILDING_STATE_VARIANTS_AND_UPGRADES + 1) // 137
 #define BUILDING_STATE_SICKNESS (BUILDING_STATE_STRIKES + 5) // 142
 #define BUILDING_STATE_DYNAMIC_RESOURCES (BUILDING_STATE_SICKNESS - RESOURCE_MAX_LEGACY) // 126 (plus variable resource size)
-#define BUILDING_STATE_CURRENT_BUFFER_SIZE (BUILDING_STATE_DYNAMIC_RESOURCES + BUILDING_STATE_NONSTATIC_RESOURCE_SIZE)
+#define BUILDING_STATE_WIDE_COORDINATES_SIZE 12
+#define BUILDING_STATE_CURRENT_BUFFER_SIZE (BUILDING_STATE_DYNAMIC_RESOURCES + BUILDING_STATE_NONSTATIC_RESOURCE_SIZE + \
+    BUILDING_STATE_WIDE_COORDINATES_SIZE)
 
 void building_state_save_to_buffer(buffer *buf, const building *b);
 
@@ -24,6 +24,7 @@
 #include "core/config.h"
 #include "core/image.h"
 #include "figure/formation.h"
+#include "game/replay.h"
 #include "game/undo.h"
 #include "graphics/window.h"
 #include "map/aqueduct.h"
@@ -68,6 +69,8 @@ static struct {
     int in_progress;
     map_tile start;
     map_tile end;
+    map_tile requested_start;
+    map_tile requested_end;
     int cost_preview;
     struct {
         int meadow;
@@ -537,6 +540,11 @@ void building_construction_set_type(building_type type)
     }
 }
 
+void building_construction_set_sub_type(building_type sub_type)
+{
+    data.sub_type = sub_type;
+}
+
 void building_construction_clear_type(void)
 {
     data.cost_preview = 0;
@@ -584,6 +592,10 @@ int building_construction_in_progress(void)
 
 void building_construction_start(int x, int y, int grid_offset)
 {
+    data.requested_start.x = data.requested_end.x = x;
+    data.requested_start.y = data.requested_end.y = y;
+    data.requested_start.grid_offset = data.requested_end.grid_offset = grid_offset;
+
     if (data.type == BUILDING_HIGHWAY) {
         building_construction_offset_start_from_orientation(&x, &y, 2);
         grid_offset = map_grid_offset(x, y);
@@ -681,6 +693,9 @@ void building_construction_update(int x, int y, int grid_offset)
 {
     building_type type = building_construction_type();
     if (grid_offset) {
+        data.requested_end.x = x;
+        data.requested_end.y = y;
+        data.requested_end.grid_offset = grid_offset;
         if (type == BUILDING_HIGHWAY) {
             building_construction_offset_start_from_orientation(&x, &y, 2);
             grid_offset = map_grid_offset(x, y);
@@ -890,6 +905,7 @@ void building_construction_offset_start_from_orientation(int *x, int *y, int siz
 
 void building_construction_place(void)
 {
+    game_replay_record_construction(data.type, data.sub_type, &data.requested_start, &data.requested_end);
     data.cost_preview = 0;
     data.in_progress = 0;
     int x_start = data.start.x;
@@ -15,6 +15,8 @@ void building_construction_set_cost(int cost);
 
 void building_construction_set_type(building_type type);
 
+void building_construction_set_sub_type(building_type sub_type);
+
 void building_construction_clear_type(void);
 
 int building_construction_can_rotate(void);
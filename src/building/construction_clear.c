@@ -6,6 +6,7 @@
 #include "core/config.h"
 #include "figure/roamer_preview.h"
 #include "figuretype/migrant.h"
+#include "game/replay.h"
 #include "game/undo.h"
 #include "graphics/window.h"
 #include "map/aqueduct.h"
@@ -202,34 +203,33 @@ static int clear_land_confirmed(int measure_only, int x_start, int y_start, int
     return items_placed;
 }
 
-static void confirm_delete_fort(int accepted, int checked)
+void building_construction_clear_land_confirm(clear_land_confirmation confirmation, int accepted)
 {
-    if (accepted == 1) {
-        confirm.fort_confirmed = 1;
+    game_replay_record_command(REPLAY_COMMAND_CLEAR_LAND_CONFIRM, confirmation, accepted);
+    int confirmed = accepted == 1 ? 1 : -1;
+    if (confirmation == CLEAR_LAND_CONFIRM_FORT) {
+        confirm.fort_confirmed = confirmed;
+    } else if (confirmation == CLEAR_LAND_CONFIRM_BRIDGE) {
+        confirm.bridge_confirmed = confirmed;
     } else {
-        confirm.fort_confirmed = -1;
+        confirm.monument_confirmed = confirmed;
     }
     clear_land_confirmed(0, confirm.x_start, confirm.y_start, confirm.x_end, confirm.y_end);
 }
 
+static void confirm_delete_fort(int accepted, int checked)
+{
+    building_construction_clear_land_confirm(CLEAR_LAND_CONFIRM_FORT, accepted);
+}
+
 static void confirm_delete_bridge(int accepted, int checked)
 {
-    if (accepted == 1) {
-        confirm.bridge_confirmed = 1;
-    } else {
-        confirm.bridge_confirmed = -1;
-    }
-    clear_land_confirmed(0, confirm.x_start, confirm.y_start, confirm.x_end, confirm.y_end);
+    building_construction_clear_land_confirm(CLEAR_LAND_CONFIRM_BRIDGE, accepted);
 }
 
 static void confirm_delete_monument(int accepted, int checked)
 {
-    if (accepted == 1) {
-        confirm.monument_confirmed = 1;
-    } else {
-        confirm.monument_confirmed = -1;
-    }
-    clear_land_confirmed(0, confirm.x_start, confirm.y_start, confirm.x_end, confirm.y_end);
+    building_construction_clear_land_confirm(CLEAR_LAND_CONFIRM_MONUMENT, accepted);
 }
 
 int building_construction_clear_land(int measure_only, int x_start, int y_start, int x_end, int y_end)
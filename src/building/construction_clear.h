@@ -1,6 +1,12 @@
 #ifndef BUILDING_CONSTRUCTION_CLEAR_H
 #define BUILDING_CONSTRUCTION_CLEAR_H
 
+typedef enum {
+    CLEAR_LAND_CONFIRM_FORT = 0,
+    CLEAR_LAND_CONFIRM_BRIDGE = 1,
+    CLEAR_LAND_CONFIRM_MONUMENT = 2
+} clear_land_confirmation;
+
 /**
  * Clears land
  * @param measure_only Whether to measure only
@@ -12,4 +18,11 @@
  */
 int building_construction_clear_land(int measure_only, int x_start, int y_start, int x_end, int y_end);
 
+/**
+ * Answers the confirmation that clearing land asked for, and clears the land of the last request
+ * @param confirmation Confirmation that was asked
+ * @param accepted Whether the player accepted
+ */
+void building_construction_clear_land_confirm(clear_land_confirmation confirmation, int accepted);
+
 #endif // BUILDING_CONSTRUCTION_CLEAR_H
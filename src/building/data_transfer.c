@@ -2,6 +2,7 @@
 
 #include "building/storage.h"
 #include "city/warning.h"
+#include "game/replay.h"
 
 #include <string.h>
 
@@ -70,6 +71,7 @@ int building_data_transfer_copy(building *b)
 
 int building_data_transfer_paste(building *b)
 {
+    game_replay_record_unsupported_command("paste building settings");
     building_data_type data_type = building_data_transfer_data_type_from_building_type(b->type);
 
     if (!building_data_transfer_possible(b)) {
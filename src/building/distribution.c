@@ -5,6 +5,7 @@
 #include "building/warehouse.h"
 #include "city/resource.h"
 #include "core/calc.h"
+#include "game/replay.h"
 
 #include <string.h>
 
@@ -15,6 +16,7 @@ int building_distribution_is_good_accepted(resource_type resource, const buildin
 
 void building_distribution_toggle_good_accepted(resource_type resource, building *b)
 {
+    game_replay_record_command(REPLAY_COMMAND_MARKET_TOGGLE_GOOD, b->id, resource);
     if (b->accepted_goods[resource] == 0) {
         b->accepted_goods[resource] = 1;
     } else {
@@ -6,8 +6,8 @@
 #include "city/houses.h"
 #include "city/resource.h"
 #include "core/calc.h"
-#include "core/time.h"
 #include "game/resource.h"
+#include "game/tick.h"
 #include "game/time.h"
 #include "game/undo.h"
 #include "map/building.h"
@@ -558,7 +558,7 @@ void building_house_process_evolve_and_consume_goods(void)
         active_devolve_delay = DEVOLVE_DELAY;
     }
 
-    time_millis last_update = time_get_millis();
+    unsigned int last_update = game_tick_id();
 
     for (building_type type = BUILDING_HOUSE_VACANT_LOT; type <= BUILDING_HOUSE_LUXURY_PALACE; type++) {
         building *next_of_type = 0; // evolve_callback changes the building type
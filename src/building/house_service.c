@@ -63,7 +63,7 @@ void house_service_decay_tax_collector(void)
 
 void house_service_decay_houses_covered(void)
 {
-    for (int i = 1; i < building_count(); i++) {
+    for (int i = building_index_next(BUILDING_INDEX_ALL, 0); i; i = building_index_next(BUILDING_INDEX_ALL, i)) {
         building *b = building_get(i);
         if (b->state != BUILDING_STATE_UNUSED && b->type != BUILDING_TOWER && b->type != BUILDING_WATCHTOWER) {
             if (b->houses_covered <= 1) {
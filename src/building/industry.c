@@ -12,6 +12,8 @@
 #include "map/building_tiles.h"
 #include "scenario/property.h"
 
+#include <stdlib.h>
+
 #define MAX_PROGRESS_RAW 200
 #define MAX_PROGRESS_WORKSHOP 400
 #define MAX_STORAGE 16
@@ -34,6 +36,23 @@ enum {
     MAX_INDUSTRY_TYPES = 17
 };
 
+// Industry buildings in production order, with the values that do not change from day to day
+typedef struct {
+    building *b;
+    int max_progress;
+    int is_farm;
+    int is_marble_quarry;
+} production_building;
+
+// Rebuilt only after an industry building was added or removed, or changed its type
+static struct {
+    production_building *items;
+    int size;
+    int capacity;
+    int type_start[MAX_INDUSTRY_TYPES + 1];
+    int valid;
+} production;
+
 static const building_type INDUSTRY_TYPES[] = {
     BUILDING_WHEAT_FARM,
     BUILDING_VEGETABLE_FARM,
@@ -147,71 +166,154 @@ static void force_strike(int num_strikes)
     }
 }
 
-void building_industry_update_production(void)
+int building_industry_is_producer(building_type type)
 {
-    int striking_buildings = 0;
+    for (int i = 0; i < MAX_INDUSTRY_TYPES; i++) {
+        if (INDUSTRY_TYPES[i] == type) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+void building_industry_invalidate_production(void)
+{
+    production.valid = 0;
+}
+
+static void init_production_building(production_building *item, building *b)
+{
+    item->b = b;
+    item->max_progress = max_progress(b);
+    item->is_farm = building_is_farm(b->type);
+    item->is_marble_quarry = b->type == BUILDING_MARBLE_QUARRY;
+}
 
+static int rebuild_production_table(void)
+{
+    int total = 0;
     for (int i = 0; i < MAX_INDUSTRY_TYPES; i++) {
-        building_type type = INDUSTRY_TYPES[i];
-        for (building *b = building_first_of_type(type); b; b = b->next_of_type) {
-            if (b->state != BUILDING_STATE_IN_USE) {
-                continue;
-            }
+        for (building *b = building_first_of_type(INDUSTRY_TYPES[i]); b; b = b->next_of_type) {
+            total++;
+        }
+    }
+    if (total > production.capacity) {
+        production_building *items = realloc(production.items, sizeof(production_building) * total);
+        if (!items) {
+            return 0;
+        }
+        production.items = items;
+        production.capacity = total;
+    }
+    production.size = 0;
+    for (int i = 0; i < MAX_INDUSTRY_TYPES; i++) {
+        production.type_start[i] = production.size;
+        for (building *b = building_first_of_type(INDUSTRY_TYPES[i]); b; b = b->next_of_type) {
+            init_production_building(&production.items[production.size++], b);
+        }
+    }
+    production.type_start[MAX_INDUSTRY_TYPES] = production.size;
+    production.valid = 1;
+    return 1;
+}
 
-            if (b->strike_duration_days > 0) {
-                striking_buildings++;
-                b->strike_duration_days--;
-                if (city_data.sentiment.value > 50) {
-                    b->strike_duration_days -= 3;
-                }
-                if (city_data.sentiment.value > 65) {
-                    b->strike_duration_days = 0;
-                }
-                if (b->strike_duration_days == 0) {
-                    city_data.building.num_striking_industries--;
-                    striking_buildings--;
-                    // remove striker walker
-                    figure_delete(figure_get(b->figure_id4));
-                }
-            }
+static void advance_progress(const production_building *item)
+{
+    building *b = item->b;
+    if (b->data.industry.blessing_days_left) {
+        b->data.industry.blessing_days_left--;
+    }
+    b->data.industry.progress += item->is_marble_quarry ? b->num_workers / 2 : b->num_workers;
+    if (b->data.industry.blessing_days_left && item->is_farm) {
+        b->data.industry.progress += b->num_workers;
+    }
+    if (b->data.industry.progress > item->max_progress) {
+        b->data.industry.progress = item->max_progress;
+    }
+}
 
-            b->data.industry.has_raw_materials = 0;
-            if (b->houses_covered <= 0 || b->num_workers <= 0 || b->strike_duration_days > 0) {
-                continue;
-            }
+static void advance_production(const production_building *item)
+{
+    building *b = item->b;
+    if (b->data.industry.curse_days_left) {
+        b->data.industry.curse_days_left--;
+    } else {
+        advance_progress(item);
+    }
+    if (item->is_farm) {
+        update_farm_image(b);
+    }
+}
 
-            if (building_monument_gt_module_is_active(VENUS_MODULE_1_DISTRIBUTE_WINE) &&
-                b->type == BUILDING_GRAND_TEMPLE_VENUS) {
-                building_other_update_production(b);
-                continue;
-            }
+static void advance_wheat_production(const production_building *item)
+{
+    building *b = item->b;
+    b->data.industry.progress += b->num_workers;
+    if (b->data.industry.blessing_days_left) {
+        b->data.industry.progress += b->num_workers;
+    }
+    if (b->data.industry.progress > item->max_progress) {
+        b->data.industry.progress = item->max_progress;
+    }
+    update_farm_image(b);
+}
 
-            if (building_is_workshop(b->type) && !b->loads_stored) {
-                continue;
-            }
+static void update_industry_production(const production_building *item, int *striking_buildings)
+{
+    building *b = item->b;
+    if (b->state != BUILDING_STATE_IN_USE) {
+        return;
+    }
 
-            if (b->data.industry.curse_days_left) {
-                b->data.industry.curse_days_left--;
-                continue;
-            }
-            if (b->data.industry.blessing_days_left) {
-                b->data.industry.blessing_days_left--;
-            }
-            if (b->type == BUILDING_MARBLE_QUARRY) {
-                b->data.industry.progress += b->num_workers / 2;
-            } else {
-                b->data.industry.progress += b->num_workers;
-            }
-            if (b->data.industry.blessing_days_left && building_is_farm(b->type)) {
-                b->data.industry.progress += b->num_workers;
-            }
+    if (b->strike_duration_days > 0) {
+        (*striking_buildings)++;
+        b->strike_duration_days--;
+        if (city_data.sentiment.value > 50) {
+            b->strike_duration_days -= 3;
+        }
+        if (city_data.sentiment.value > 65) {
+            b->strike_duration_days = 0;
+        }
+        if (b->strike_duration_days == 0) {
+            city_data.building.num_striking_industries--;
+            (*striking_buildings)--;
+            // remove striker walker
+            figure_delete(figure_get(b->figure_id4));
+        }
+    }
 
-            int max = max_progress(b);
-            if (b->data.industry.progress > max) {
-                b->data.industry.progress = max;
-            }
-            if (building_is_farm(b->type)) {
-                update_farm_image(b);
+    b->data.industry.has_raw_materials = 0;
+    if (b->houses_covered <= 0 || b->num_workers <= 0 || b->strike_duration_days > 0) {
+        return;
+    }
+
+    if (building_monument_gt_module_is_active(VENUS_MODULE_1_DISTRIBUTE_WINE) &&
+        b->type == BUILDING_GRAND_TEMPLE_VENUS) {
+        building_other_update_production(b);
+        return;
+    }
+
+    if (building_is_workshop(b->type) && !b->loads_stored) {
+        return;
+    }
+
+    advance_production(item);
+}
+
+void building_industry_update_production(void)
+{
+    int striking_buildings = 0;
+
+    if (production.valid || rebuild_production_table()) {
+        for (int i = 0; i < production.size; i++) {
+            update_industry_production(&production.items[i], &striking_buildings);
+        }
+    } else {
+        for (int i = 0; i < MAX_INDUSTRY_TYPES; i++) {
+            for (building *b = building_first_of_type(INDUSTRY_TYPES[i]); b; b = b->next_of_type) {
+                production_building item;
+                init_production_building(&item, b);
+                update_industry_production(&item, &striking_buildings);
             }
         }
     }
@@ -220,24 +322,32 @@ void building_industry_update_production(void)
     force_strike(num_strikes);
 }
 
+static void update_wheat_production(const production_building *item)
+{
+    building *b = item->b;
+    if (b->state != BUILDING_STATE_IN_USE || b->houses_covered <= 0 ||
+        b->num_workers <= 0 || b->data.industry.curse_days_left) {
+        return;
+    }
+    advance_wheat_production(item);
+}
+
 void building_industry_update_wheat_production(void)
 {
     if (scenario_property_climate() == CLIMATE_NORTHERN) {
         return;
     }
-    for (building *b = building_first_of_type(BUILDING_WHEAT_FARM); b; b = b->next_of_type) {
-        if (b->state != BUILDING_STATE_IN_USE || b->houses_covered <= 0 ||
-            b->num_workers <= 0 || b->data.industry.curse_days_left) {
-            continue;
+    if (production.valid || rebuild_production_table()) {
+        // wheat farms come first in the production order
+        for (int i = production.type_start[0]; i < production.type_start[1]; i++) {
+            update_wheat_production(&production.items[i]);
         }
-        b->data.industry.progress += b->num_workers;
-        if (b->data.industry.blessing_days_left) {
-            b->data.industry.progress += b->num_workers;
+    } else {
+        for (building *b = building_first_of_type(BUILDING_WHEAT_FARM); b; b = b->next_of_type) {
+            production_building item;
+            init_production_building(&item, b);
+            update_wheat_production(&item);
         }
-        if (b->data.industry.progress > MAX_PROGRESS_RAW) {
-            b->data.industry.progress = MAX_PROGRESS_RAW;
-        }
-        update_farm_image(b);
     }
 }
 
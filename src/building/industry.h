@@ -7,6 +7,13 @@
 int building_is_farm(building_type type);
 int building_is_raw_resource_producer(building_type type);
 int building_is_workshop(building_type type);
+int building_industry_is_producer(building_type type);
+
+/**
+ * Marks the production table as outdated. Needs to be called whenever an industry building
+ * is added or removed, or changes its type.
+ */
+void building_industry_invalidate_production(void);
 
 void building_industry_update_production(void);
 void building_industry_update_wheat_production(void);
@@ -14,7 +14,7 @@ static struct {
 
 void building_list_small_clear(void)
 {
-    data.small.size = 0;
+    array_clear(data.small);
 }
 
 void building_list_small_add(int building_id)
@@ -41,7 +41,7 @@ int building_list_small_item(int index)
 
 void building_list_large_clear(void)
 {
-    data.large.size = 0;
+    array_clear(data.large);
 }
 
 void building_list_large_add(int building_id)
@@ -68,7 +68,7 @@ int building_list_large_item(int index)
 
 void building_list_burning_clear(void)
 {
-    data.burning.size = 0;
+    array_clear(data.burning);
 }
 
 void building_list_burning_add(int building_id)
@@ -131,9 +131,9 @@ void building_list_save_state(buffer *small, buffer *large, buffer *burning, buf
 
 void building_list_load_state(buffer *small, buffer *large, buffer *burning, buffer *burning_totals, int is_new_version)
 {
-    data.small.size = 0;
-    data.large.size = 0;
-    data.burning.size = 0;
+    array_clear(data.small);
+    array_clear(data.large);
+    array_clear(data.burning);
 
     if (!is_new_version) {
         int size = small->size / sizeof(int16_t);
@@ -164,7 +164,7 @@ void building_list_load_state(buffer *small, buffer *large, buffer *burning, buf
             building_list_burning_add(buffer_read_i32(burning));
         }
     }
-    data.small.size = 0;
-    data.large.size = 0;
+    array_clear(data.small);
+    array_clear(data.large);
     data.burning.size = buffer_read_i32(burning_totals);
 }
@@ -4,6 +4,7 @@
 #include "building/destruction.h"
 #include "building/list.h"
 #include "building/monument.h"
+#include "building/tourism.h"
 #include "city/buildings.h"
 #include "city/map.h"
 #include "city/message.h"
@@ -45,10 +46,8 @@ void building_maintenance_update_burning_ruins(void)
     scenario_climate climate = scenario_property_climate();
     int recalculate_terrain = 0;
     building_list_burning_clear();
-    for (int i = 1; i < building_count(); i++) {
-        building *b = building_get(i);
-        if ((b->state != BUILDING_STATE_IN_USE && b->state != BUILDING_STATE_MOTHBALLED) ||
-            b->type != BUILDING_BURNING_RUIN) {
+    for (building *b = building_first_of_type(BUILDING_BURNING_RUIN); b; b = b->next_of_type) {
+        if (b->state != BUILDING_STATE_IN_USE && b->state != BUILDING_STATE_MOTHBALLED) {
             continue;
         }
         if (b->fire_duration < 0) {
@@ -58,14 +57,14 @@ void building_maintenance_update_burning_ruins(void)
         if (b->fire_duration > 32) {
             game_undo_disable();
             b->state = BUILDING_STATE_RUBBLE;
-            map_building_tiles_set_rubble(i, b->x, b->y, b->size);
+            map_building_tiles_set_rubble(b->id, b->x, b->y, b->size);
             recalculate_terrain = 1;
             continue;
         }
         if (b->has_plague) {
             continue;
         }
-        building_list_burning_add(i);
+        building_list_burning_add(b->id);
         if (climate == CLIMATE_DESERT) {
             if (b->fire_duration & 3) { // check spread every 4 ticks
                 continue;
@@ -175,7 +174,8 @@ void building_maintenance_check_fire_collapse(void)
     int recalculate_terrain = 0;
     int random_global = random_byte() & 7;
 
-    for (int i = 1; i < building_count(); i++) {
+    for (int i = building_index_next(BUILDING_INDEX_FLAMMABLE, 0); i;
+        i = building_index_next(BUILDING_INDEX_FLAMMABLE, i)) {
         building *b = building_get(i);
         if (b->state != BUILDING_STATE_IN_USE || b->fire_proof) {
             continue;
@@ -386,6 +386,7 @@ void building_maintenance_check_rome_access(void)
             }
         }
     }
+    building_tourism_invalidate_venues();
     const map_tile *exit_point = city_map_exit_point();
 
     if (!map_routing_distance(exit_point->grid_offset)) {
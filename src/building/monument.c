@@ -584,6 +584,7 @@ void building_monument_remove_delivery(int figure_id)
     {
         if (delivery->walker_id == figure_id) {
             delivery->destination_id = 0;
+            array_release_item(monument_deliveries, i);
         }
     }
     array_trim(monument_deliveries);
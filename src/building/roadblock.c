@@ -2,6 +2,7 @@
 
 #include "building/building.h"
 #include "building/type.h"
+#include "map/routing_terrain.h"
 
 
 
@@ -11,6 +12,7 @@ void building_roadblock_set_permission(roadblock_permission p, building* b) {
     if (building_type_is_roadblock(b->type)) {
         int permission_bit = 1 << p;
         b->data.roadblock.exceptions ^= permission_bit;
+        map_routing_citizen_mark_changed(b->grid_offset);
     }
 }
 
@@ -140,6 +140,20 @@ void building_rotation_rotate_backward(void)
     }
 }
 
+void building_rotation_get_state(int *rotation, int *extra_rotation, int *road_orientation)
+{
+    *rotation = data.rotation;
+    *extra_rotation = data.extra_rotation;
+    *road_orientation = data.road_orientation;
+}
+
+void building_rotation_set_state(int rotation, int extra_rotation, int road_orientation)
+{
+    data.rotation = rotation;
+    data.extra_rotation = extra_rotation;
+    data.road_orientation = road_orientation;
+}
+
 void building_rotation_reset_rotation(void)
 {
     data.rotation = 0;
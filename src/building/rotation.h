@@ -17,6 +17,8 @@ int building_rotation_get_corner(int rot);
 
 void building_rotation_rotate_forward(void);
 void building_rotation_rotate_backward(void);
+void building_rotation_get_state(int *rotation, int *extra_rotation, int *road_orientation);
+void building_rotation_set_state(int rotation, int extra_rotation, int road_orientation);
 void building_rotation_reset_rotation(void);
 void building_rotation_setup_rotation(void);
 void building_rotation_remove_rotation(void);
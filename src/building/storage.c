@@ -5,6 +5,7 @@
 #include "core/array.h"
 #include "core/calc.h"
 #include "core/log.h"
+#include "game/replay.h"
 #include "game/resource.h"
 #include "game/save_version.h"
 
@@ -95,6 +96,7 @@ int building_storage_restore(int storage_id)
 void building_storage_delete(int storage_id)
 {
     array_item(storages, storage_id)->in_use = 0;
+    array_release_item(storages, storage_id);
     array_trim(storages);
 }
 
@@ -111,11 +113,13 @@ void building_storage_set_data(int storage_id, building_storage new_data)
 
 void building_storage_toggle_empty_all(int storage_id)
 {
+    game_replay_record_command(REPLAY_COMMAND_STORAGE_TOGGLE_EMPTY_ALL, storage_id, 0);
     array_item(storages, storage_id)->storage.empty_all ^= 1;
 }
 
 void building_storage_cycle_resource_state(int storage_id, resource_type resource_id)
 {
+    game_replay_record_command(REPLAY_COMMAND_STORAGE_CYCLE_RESOURCE, storage_id, resource_id);
     int state = array_item(storages, storage_id)->storage.resource_state[resource_id];
     if (state == BUILDING_STORAGE_STATE_ACCEPTING) {
         state = BUILDING_STORAGE_STATE_NOT_ACCEPTING;
@@ -147,6 +151,7 @@ void building_storage_cycle_resource_state(int storage_id, resource_type resourc
 
 void building_storage_set_permission(building_storage_permission_states p, building *b)
 {
+    game_replay_record_command(REPLAY_COMMAND_STORAGE_TOGGLE_PERMISSION, b->id, p);
     int permission_bit = 1 << p;
     array_item(storages, b->storage_id)->storage.permissions ^= permission_bit;
 }
@@ -160,6 +165,7 @@ int building_storage_get_permission(building_storage_permission_states p, buildi
 
 void building_storage_cycle_partial_resource_state(int storage_id, resource_type resource_id)
 {
+    game_replay_record_command(REPLAY_COMMAND_STORAGE_CYCLE_PARTIAL_RESOURCE, storage_id, resource_id);
     int state = array_item(storages, storage_id)->storage.resource_state[resource_id];
     if (state == BUILDING_STORAGE_STATE_ACCEPTING) {
         state = BUILDING_STORAGE_STATE_ACCEPTING_3QUARTERS;
@@ -0,0 +1,99 @@
+#include "tourism.h"
+
+#include "building/building.h"
+#include "building/list.h"
+#include "city/festival.h"
+#include "core/log.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define MAX_ROAD_NETWORKS 256
+#define VENUES_SIZE_STEP 100
+
+static struct {
+    int valid;
+    int *ids;
+    int size;
+    int capacity;
+    int network_start[MAX_ROAD_NETWORKS + 1];
+} data;
+
+static int is_registered_venue(const building *b)
+{
+    if (!b->is_tourism_venue || b->tourism_disabled || !b->distance_from_entry) {
+        return 0;
+    }
+    return b->type != BUILDING_HIPPODROME || !b->prev_part_building_id;
+}
+
+static int can_visit(const building *b, int road_network_id)
+{
+    if (b->state != BUILDING_STATE_IN_USE || b->road_network_id != road_network_id || !is_registered_venue(b)) {
+        return 0;
+    }
+    return !city_festival_games_active() || b->type == city_festival_games_active_venue_type();
+}
+
+static int grow_venues(int capacity)
+{
+    int *ids = realloc(data.ids, sizeof(int) * capacity);
+    if (!ids) {
+        return 0;
+    }
+    data.ids = ids;
+    data.capacity = capacity;
+    return 1;
+}
+
+static int rebuild_venues(void)
+{
+    int network_size[MAX_ROAD_NETWORKS] = { 0 };
+    int total = 0;
+    for (int i = building_index_next(BUILDING_INDEX_TOURISM, 0); i; i = building_index_next(BUILDING_INDEX_TOURISM, i)) {
+        building *b = building_get(i);
+        if (b->state != BUILDING_STATE_UNUSED && is_registered_venue(b)) {
+            network_size[b->road_network_id]++;
+            total++;
+        }
+    }
+    if (total > data.capacity && !grow_venues(total + VENUES_SIZE_STEP)) {
+        log_error("Unable to grow the tourism venue list", 0, total);
+        return 0;
+    }
+    data.network_start[0] = 0;
+    for (int network = 0; network < MAX_ROAD_NETWORKS; network++) {
+        data.network_start[network + 1] = data.network_start[network] + network_size[network];
+    }
+    int position[MAX_ROAD_NETWORKS];
+    memcpy(position, data.network_start, sizeof(position));
+    for (int i = building_index_next(BUILDING_INDEX_TOURISM, 0); i; i = building_index_next(BUILDING_INDEX_TOURISM, i)) {
+        building *b = building_get(i);
+        if (b->state != BUILDING_STATE_UNUSED && is_registered_venue(b)) {
+            data.ids[position[b->road_network_id]++] = i;
+        }
+    }
+    data.size = total;
+    data.valid = 1;
+    return 1;
+}
+
+void building_tourism_invalidate_venues(void)
+{
+    data.valid = 0;
+}
+
+int building_tourism_list_venues(int road_network_id)
+{
+    building_list_large_clear();
+    if (road_network_id < 0 || road_network_id >= MAX_ROAD_NETWORKS || (!data.valid && !rebuild_venues())) {
+        return 0;
+    }
+    // Venues may have been damaged or mothballed since the registry was built, so check them again
+    for (int i = data.network_start[road_network_id]; i < data.network_start[road_network_id + 1]; i++) {
+        if (can_visit(building_get(data.ids[i]), road_network_id)) {
+            building_list_large_add(data.ids[i]);
+        }
+    }
+    return building_list_large_size();
+}
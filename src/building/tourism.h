@@ -0,0 +1,25 @@
+#ifndef BUILDING_TOURISM_H
+#define BUILDING_TOURISM_H
+
+/**
+ * @file
+ * Registry of the tourism venues that tourists can visit, grouped by road network.
+ * The registry is rebuilt lazily after it has been invalidated.
+ */
+
+/**
+ * Marks the venue registry as outdated. Needs to be called whenever a tourism building is added or removed,
+ * changes its type or road access, or changes whether it accepts tourists.
+ */
+void building_tourism_invalidate_venues(void);
+
+/**
+ * Fills the large building list with the venues that a tourist on the given road network can visit right now,
+ * in building id order. During games, only venues of the games' venue type are listed.
+ * The large building list is part of saved games, so it keeps holding the last tourist's choices.
+ * @param road_network_id The road network the tourist is on
+ * @return The number of venues in the large building list
+ */
+int building_tourism_list_venues(int road_network_id);
+
+#endif // BUILDING_TOURISM_H
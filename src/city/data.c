@@ -6,6 +6,7 @@
 #include "game/difficulty.h"
 #include "game/resource.h"
 #include "game/save_version.h"
+#include "map/grid.h"
 #include "scenario/property.h"
 
 #include <string.h>
@@ -113,9 +114,10 @@ static void save_main_data(buffer *main)
     buffer_write_u8(main, city_data.map.exit_point.x);
     buffer_write_u8(main, city_data.map.exit_point.y);
     buffer_write_i16(main, city_data.map.exit_point.grid_offset);
-    for (int i = 0; i < 8; i++) {
-        buffer_write_u8(main, 0);
-    }
+    buffer_write_u16(main, city_data.map.entry_point.x);
+    buffer_write_u16(main, city_data.map.entry_point.y);
+    buffer_write_u16(main, city_data.map.exit_point.x);
+    buffer_write_u16(main, city_data.map.exit_point.y);
     buffer_write_u8(main, city_data.trade.land_policy);
     buffer_write_u8(main, city_data.trade.sea_policy);
     for (int i = 0; i < RESOURCE_MAX; i++) {
@@ -568,7 +570,18 @@ static void load_main_data(buffer *main, int version)
     city_data.map.exit_point.x = buffer_read_u8(main);
     city_data.map.exit_point.y = buffer_read_u8(main);
     city_data.map.exit_point.grid_offset = buffer_read_i16(main);
-    buffer_skip(main, 8);
+    if (version > SAVE_GAME_LAST_FIXED_GRID_SIZE) {
+        city_data.map.entry_point.x = buffer_read_u16(main);
+        city_data.map.entry_point.y = buffer_read_u16(main);
+        city_data.map.exit_point.x = buffer_read_u16(main);
+        city_data.map.exit_point.y = buffer_read_u16(main);
+        city_data.map.entry_point.grid_offset = map_grid_offset(city_data.map.entry_point.x, city_data.map.entry_point.y);
+        city_data.map.exit_point.grid_offset = map_grid_offset(city_data.map.exit_point.x, city_data.map.exit_point.y);
+    } else {
+        city_data.map.entry_point.grid_offset = map_grid_offset_from_saved(city_data.map.entry_point.grid_offset);
+        city_data.map.exit_point.grid_offset = map_grid_offset_from_saved(city_data.map.exit_point.grid_offset);
+        buffer_skip(main, 8);
+    }
     city_data.trade.land_policy = buffer_read_u8(main);
     city_data.trade.sea_policy = buffer_read_u8(main);
     for (int i = 0; i < resource_total_mapped(); i++) {
@@ -1020,8 +1033,8 @@ static void load_entry_exit(buffer *entry_exit_xy, buffer *entry_exit_grid_offse
     city_data.map.exit_flag.x = buffer_read_i32(entry_exit_xy);
     city_data.map.exit_flag.y = buffer_read_i32(entry_exit_xy);
 
-    city_data.map.entry_flag.grid_offset = buffer_read_i32(entry_exit_grid_offset);
-    city_data.map.exit_flag.grid_offset = buffer_read_i32(entry_exit_grid_offset);
+    city_data.map.entry_flag.grid_offset = map_grid_offset_from_saved(buffer_read_i32(entry_exit_grid_offset));
+    city_data.map.exit_flag.grid_offset = map_grid_offset_from_saved(buffer_read_i32(entry_exit_grid_offset));
 }
 
 void city_data_save_state(buffer *main, buffer *graph_order,
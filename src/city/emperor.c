@@ -7,6 +7,7 @@
 #include "core/calc.h"
 #include "figure/formation.h"
 #include "game/difficulty.h"
+#include "game/replay.h"
 #include "game/time.h"
 #include "scenario/property.h"
 #include "scenario/invasion.h"
@@ -209,6 +210,7 @@ void city_emperor_calculate_gift_costs(void)
 
 void city_emperor_send_gift(void)
 {
+    game_replay_record_command(REPLAY_COMMAND_SEND_GIFT, city_data.emperor.selected_gift_size, 0);
     int size = city_data.emperor.selected_gift_size;
     if (size < GIFT_MODEST || size > GIFT_LAVISH) {
         return;
@@ -333,6 +335,7 @@ void city_emperor_change_donation_amount(int change)
 
 void city_emperor_donate_savings_to_city(void)
 {
+    game_replay_record_command(REPLAY_COMMAND_DONATE, city_data.emperor.donate_amount, 0);
     city_finance_process_donation(city_data.emperor.donate_amount);
     city_data.emperor.personal_savings -= city_data.emperor.donate_amount;
     city_finance_calculate_totals();
@@ -10,6 +10,7 @@
 #include "city/message.h"
 #include "city/sentiment.h"
 #include "core/config.h"
+#include "game/replay.h"
 #include "game/time.h"
 
 auto_festival autofestivals[5] = {
@@ -133,6 +134,7 @@ int city_festival_select_size(int size)
 
 void city_festival_schedule(void)
 {
+    game_replay_record_command(REPLAY_COMMAND_FESTIVAL, city_data.festival.selected.god, city_data.festival.selected.size);
     city_data.festival.planned.god = city_data.festival.selected.god;
     city_data.festival.planned.size = city_data.festival.selected.size;
     int cost;
@@ -4,12 +4,14 @@
 #include "building/count.h"
 #include "building/model.h"
 #include "building/monument.h"
+#include "building/tourism.h"
 #include "city/data_private.h"
 #include "city/culture.h"
 #include "city/festival.h"
 #include "core/calc.h"
 #include "core/random.h"
 #include "game/difficulty.h"
+#include "game/replay.h"
 #include "game/time.h"
 #include "figuretype/entertainer.h"
 #include "map/data.h"
@@ -91,6 +93,7 @@ int city_finance_tax_percentage(void)
 
 void city_finance_change_tax_percentage(int change)
 {
+    game_replay_record_command(REPLAY_COMMAND_CHANGE_TAXES, change, 0);
     city_data.finance.tax_percentage = calc_bound(city_data.finance.tax_percentage + change, 0, 25);
 }
 
@@ -384,6 +387,7 @@ static void activate_monthly_tourism(void)
             }
         }
     }
+    building_tourism_invalidate_venues();
 }
 
 void city_finance_handle_month_change(void)
@@ -8,13 +8,18 @@
 #include "city/gods.h"
 #include "city/message.h"
 #include "city/population.h"
+#include "core/array.h"
 #include "core/calc.h"
+#include "core/job.h"
 #include "core/random.h"
+#include "game/replay.h"
 #include "game/time.h"
 #include "scenario/data.h"
 #include "scenario/property.h"
 
 #define MAX_CATS 10
+#define CATEGORY_BUILDINGS_SIZE_STEP 100
+#define MIN_BUILDINGS_PER_CHUNK 256
 
 typedef enum {
     LABOR_CATEGORY_INDUSTRY_COMMERCE = 0,
@@ -51,6 +56,16 @@ static const int CATEGORY_FOR_BUILDING_TYPE[] = {
     -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, // 190
 };
 
+typedef struct {
+    int workers_needed;
+    int total_houses_covered;
+    int buildings;
+} category_totals;
+
+static struct {
+    array(building *) buildings[MAX_CATS];
+} data;
+
 static struct {
     labor_category category;
     int workers;
@@ -98,6 +113,7 @@ int city_labor_wages(void)
 
 void city_labor_change_wages(int amount)
 {
+    game_replay_record_command(REPLAY_COMMAND_CHANGE_WAGES, amount, 0);
     city_data.labor.wages += amount;
     city_data.labor.wages = calc_bound(city_data.labor.wages, 0, 100);
 }
@@ -136,6 +152,11 @@ const labor_category_data *city_labor_category(int category)
     return &city_data.labor.categories[category];
 }
 
+int city_labor_category_for_building_type(building_type type)
+{
+    return CATEGORY_FOR_BUILDING_TYPE[type];
+}
+
 void city_labor_calculate_workers(int num_plebs, int num_patricians)
 {
     int venus_blessing_modifier = 0;
@@ -190,29 +211,61 @@ static int should_have_workers(building *b, int category, int check_access)
     return 1;
 }
 
-static void calculate_workers_needed_per_category(void)
+static void sum_workers_needed(category_totals *totals, int start_id, int end_id)
 {
-    for (int cat = 0; cat < MAX_CATS; cat++) {
-        city_data.labor.categories[cat].buildings = 0;
-        city_data.labor.categories[cat].total_houses_covered = 0;
-        city_data.labor.categories[cat].workers_allocated = 0;
-        city_data.labor.categories[cat].workers_needed = 0;
-    }
-    for (int i = 1; i < building_count(); i++) {
+    for (int i = building_index_next(BUILDING_INDEX_WORKPLACES, start_id - 1); i && i < end_id;
+        i = building_index_next(BUILDING_INDEX_WORKPLACES, i)) {
         building *b = building_get(i);
         if (b->state != BUILDING_STATE_IN_USE) {
             continue;
         }
         int category = CATEGORY_FOR_BUILDING_TYPE[b->type];
-        b->labor_category = category;
         if (!should_have_workers(b, category, 1)) {
             continue;
         }
+        totals[category].workers_needed += building_get_laborers(b->type);
+        totals[category].total_houses_covered += b->houses_covered;
+        totals[category].buildings++;
+    }
+}
 
-        city_data.labor.categories[category].workers_needed += (building_get_laborers(b->type));
+static void sum_workers_needed_for_chunk(int chunk, int start, int end, void *data)
+{
+    category_totals (*chunk_totals)[MAX_CATS] = data;
+    // building ids start at 1
+    sum_workers_needed(chunk_totals[chunk], start + 1, end + 1);
+}
 
-        city_data.labor.categories[category].total_houses_covered += b->houses_covered;
-        city_data.labor.categories[category].buildings++;
+static void set_labor_categories(void)
+{
+    // Buildings without workers are skipped when summing, but their saved category still follows their type
+    for (int i = building_index_next(BUILDING_INDEX_ALL, 0); i; i = building_index_next(BUILDING_INDEX_ALL, i)) {
+        building *b = building_get(i);
+        if (b->state == BUILDING_STATE_IN_USE) {
+            b->labor_category = CATEGORY_FOR_BUILDING_TYPE[b->type];
+        }
+    }
+}
+
+static void calculate_workers_needed_per_category(void)
+{
+    set_labor_categories();
+    category_totals chunk_totals[JOB_MAX_CHUNKS][MAX_CATS] = { 0 };
+    int num_buildings = building_count() - 1;
+    job_parallel_for(num_buildings, MIN_BUILDINGS_PER_CHUNK, sum_workers_needed_for_chunk, chunk_totals);
+
+    int num_chunks = job_parallel_for_num_chunks(num_buildings, MIN_BUILDINGS_PER_CHUNK);
+    for (int cat = 0; cat < MAX_CATS; cat++) {
+        labor_category_data *category = &city_data.labor.categories[cat];
+        category->buildings = 0;
+        category->total_houses_covered = 0;
+        category->workers_allocated = 0;
+        category->workers_needed = 0;
+        for (int chunk = 0; chunk < num_chunks; chunk++) {
+            category->buildings += chunk_totals[chunk][cat].buildings;
+            category->total_houses_covered += chunk_totals[chunk][cat].total_houses_covered;
+            category->workers_needed += chunk_totals[chunk][cat].workers_needed;
+        }
     }
 }
 
@@ -311,9 +364,24 @@ static void check_employment(void)
     }
 }
 
+static void add_building_to_category(int category, building *b)
+{
+    if (!data.buildings[category].blocks &&
+        !array_init(data.buildings[category], CATEGORY_BUILDINGS_SIZE_STEP, 0, 0)) {
+        return;
+    }
+    building **item = array_advance(data.buildings[category]);
+    if (item) {
+        *item = b;
+    }
+}
+
 static void set_building_worker_weight(void)
 {
     int water_per_10k_per_building = calc_percentage(100, city_data.labor.categories[LABOR_CATEGORY_WATER].buildings);
+    for (int cat = 0; cat < MAX_CATS; cat++) {
+        array_clear(data.buildings[cat]);
+    }
     for (building_type type = 0; type < BUILDING_TYPE_MAX; type++) {
         int cat = CATEGORY_FOR_BUILDING_TYPE[type];
         if (cat < 0) {
@@ -326,6 +394,7 @@ static void set_building_worker_weight(void)
             if (cat == LABOR_CATEGORY_WATER) {
                 b->percentage_houses_covered = water_per_10k_per_building;
             } else {
+                add_building_to_category(cat, b);
                 b->percentage_houses_covered = 0;
                 if (b->houses_covered) {
                     b->percentage_houses_covered =
@@ -335,6 +404,14 @@ static void set_building_worker_weight(void)
             }
         }
     }
+    // water buildings get their workers in id order, which the list by type does not keep across types
+    for (int i = building_index_next(BUILDING_INDEX_WORKPLACES, 0); i;
+        i = building_index_next(BUILDING_INDEX_WORKPLACES, i)) {
+        building *b = building_get(i);
+        if (b->state == BUILDING_STATE_IN_USE && CATEGORY_FOR_BUILDING_TYPE[b->type] == LABOR_CATEGORY_WATER) {
+            add_building_to_category(LABOR_CATEGORY_WATER, b);
+        }
+    }
 }
 
 static void allocate_workers_to_water(void)
@@ -352,16 +429,17 @@ static void allocate_workers_to_water(void)
     } else {
         workers_per_building = water_cat->workers_allocated / (water_cat->buildings - buildings_to_skip);
     }
-    int building_id = start_building_id;
+    // water buildings are sorted by id: start at the first one at or after start_building_id and wrap around
+    int num_buildings = data.buildings[LABOR_CATEGORY_WATER].size;
+    int first = 0;
+    while (first < num_buildings &&
+        (*array_item(data.buildings[LABOR_CATEGORY_WATER], first))->id < start_building_id) {
+        first++;
+    }
     start_building_id = 0;
-    for (int guard = 1; guard < building_count(); guard++, building_id++) {
-        if (building_id >= building_count()) {
-            building_id = 1;
-        }
-        building *b = building_get(building_id);
-        if (b->state != BUILDING_STATE_IN_USE || CATEGORY_FOR_BUILDING_TYPE[b->type] != LABOR_CATEGORY_WATER) {
-            continue;
-        }
+    for (int i = 0; i < num_buildings; i++) {
+        building *b = *array_item(data.buildings[LABOR_CATEGORY_WATER], (first + i) % num_buildings);
+        int building_id = b->id;
         b->num_workers = 0;
         if (b->percentage_houses_covered > 0) {
             if (percentage_not_filled > 0) {
@@ -394,16 +472,14 @@ static void allocate_workers_to_non_water_buildings(void)
             city_data.labor.categories[i].workers_allocated < city_data.labor.categories[i].workers_needed
             ? 1 : 0;
     }
-    for (building_type type = 0; type < BUILDING_TYPE_MAX; type++) {
-        int cat = CATEGORY_FOR_BUILDING_TYPE[type];
-        if (cat == LABOR_CATEGORY_WATER || cat < 0) {
+    for (int cat = 0; cat < MAX_CATS; cat++) {
+        if (cat == LABOR_CATEGORY_WATER) {
             // water is handled by allocate_workers_to_water(void)
             continue;
         }
-        for (building *b = building_first_of_type(type); b; b = b->next_of_type) {
-            if (b->state != BUILDING_STATE_IN_USE) {
-                continue;
-            }
+        building **item;
+        array_foreach(data.buildings[cat], item) {
+            building *b = *item;
             b->num_workers = 0;
             if (!should_have_workers(b, cat, 0) || b->percentage_houses_covered <= 0) {
                 continue;
@@ -435,15 +511,13 @@ static void allocate_workers_to_non_water_buildings(void)
             }
         }
     }
-    for (building_type type = 0; type < BUILDING_TYPE_MAX; type++) {
-        int cat = CATEGORY_FOR_BUILDING_TYPE[type];
-        if (cat < 0 || cat == LABOR_CATEGORY_WATER || cat == LABOR_CATEGORY_MILITARY) {
+    for (int cat = 0; cat < MAX_CATS; cat++) {
+        if (cat == LABOR_CATEGORY_WATER || cat == LABOR_CATEGORY_MILITARY || !category_workers_needed[cat]) {
             continue;
         }
-        for (building *b = building_first_of_type(type); b; b = b->next_of_type) {
-            if (b->state != BUILDING_STATE_IN_USE) {
-                continue;
-            }
+        building **item;
+        array_foreach(data.buildings[cat], item) {
+            building *b = *item;
             if (!should_have_workers(b, cat, 0)) {
                 continue;
             }
@@ -486,6 +560,7 @@ void city_labor_update(void)
 
 void city_labor_set_priority(int category, int new_priority)
 {
+    game_replay_record_command(REPLAY_COMMAND_LABOR_PRIORITY, category, new_priority);
     int old_priority = city_data.labor.categories[category].priority;
     if (old_priority == new_priority) {
         return;
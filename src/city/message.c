@@ -12,6 +12,7 @@
 #include "game/settings.h"
 #include "game/time.h"
 #include "graphics/window.h"
+#include "map/grid.h"
 #include "sound/effect.h"
 #include "window/message_dialog.h"
 
@@ -224,7 +225,7 @@ void city_message_post(int use_popup, int message_type, int param1, int param2)
     should_play_sound = 1;
 }
 
-void city_message_post_with_popup_delay(message_category category, int message_type, int param1, short param2)
+void city_message_post_with_popup_delay(message_category category, int message_type, int param1, int param2)
 {
     int use_popup = 0;
     if (data.message_delay[category] <= 0) {
@@ -650,7 +651,7 @@ void city_message_save_state(buffer *messages, buffer *extra, buffer *counts, bu
         buffer_write_i16(messages, msg->sequence);
         buffer_write_u8(messages, msg->is_read);
         buffer_write_u8(messages, msg->month);
-        buffer_write_i16(messages, 0);
+        buffer_write_i16(messages, msg->param2 >> 16);
     }
 
     buffer_write_i32(extra, data.next_message_sequence);
@@ -674,7 +675,7 @@ void city_message_save_state(buffer *messages, buffer *extra, buffer *counts, bu
     buffer_write_u8(population, data.population_shown.pop25000);
 }
 
-static void update_message_param_if_resource(city_message *msg)
+static void update_message_param(city_message *msg)
 {
     switch (msg->message_type) {
         case MESSAGE_INCREASED_TRADING:
@@ -685,11 +686,14 @@ static void update_message_param_if_resource(city_message *msg)
             msg->param2 = resource_remap(msg->param2);
             break;
         default:
+            // all other messages store their location in param2
+            msg->param2 = map_grid_offset_from_saved(msg->param2);
             break;
     }
 }
 
-void city_message_load_state(buffer *messages, buffer *extra, buffer *counts, buffer *delays, buffer *population)
+void city_message_load_state(buffer *messages, buffer *extra, buffer *counts, buffer *delays, buffer *population,
+    int has_wide_params)
 {
     for (int i = 0; i < MAX_MESSAGES; i++) {
         city_message *msg = &data.messages[i];
@@ -700,8 +704,12 @@ void city_message_load_state(buffer *messages, buffer *extra, buffer *counts, bu
         msg->sequence = buffer_read_i16(messages);
         msg->is_read = buffer_read_u8(messages);
         msg->month = buffer_read_u8(messages);
-        update_message_param_if_resource(msg);
-        buffer_skip(messages, 2);
+        if (has_wide_params) {
+            msg->param2 = (int) (((uint32_t) msg->param2 & 0xffff) | ((uint32_t) buffer_read_u16(messages) << 16));
+        } else {
+            buffer_skip(messages, 2);
+        }
+        update_message_param(msg);
     }
 
     data.next_message_sequence = buffer_read_i32(extra);
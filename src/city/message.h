@@ -209,7 +209,7 @@ void city_message_apply_sound_interval(message_category category);
 
 void city_message_post(int use_popup, int message_type, int param1, int param2);
 
-void city_message_post_with_popup_delay(message_category category, int message_type, int param1, short param2);
+void city_message_post_with_popup_delay(message_category category, int message_type, int param1, int param2);
 
 void city_message_post_with_message_delay(message_category category, int use_popup, int message_type, int delay);
 
@@ -253,6 +253,7 @@ void city_message_set_scroll_position(int scroll_position);
 
 void city_message_save_state(buffer *messages, buffer *extra, buffer *counts, buffer *delays, buffer *population);
 
-void city_message_load_state(buffer *messages, buffer *extra, buffer *counts, buffer *delays, buffer *population);
+void city_message_load_state(buffer *messages, buffer *extra, buffer *counts, buffer *delays, buffer *population,
+    int has_wide_params);
 
 #endif // CITY_MESSAGE_H
@@ -16,6 +16,7 @@
 #include "figure/figure.h"
 #include "figure/formation.h"
 #include "game/difficulty.h"
+#include "game/replay.h"
 #include "game/tutorial.h"
 #include "map/road_access.h"
 #include "scenario/building.h"
@@ -130,6 +131,7 @@ resource_trade_status city_resource_trade_status(resource_type resource)
 
 void city_resource_cycle_trade_status(resource_type resource, resource_trade_status status)
 {
+    game_replay_record_command(REPLAY_COMMAND_RESOURCE_TRADE_STATUS, resource, status);
     if (status == TRADE_STATUS_IMPORT && !empire_can_import_resource(resource)) {
         city_data.resource.trade_status[resource] &= ~TRADE_STATUS_IMPORT;
         return;
@@ -152,6 +154,7 @@ int city_resource_import_over(resource_type resource)
 
 void city_resource_change_import_over(resource_type resource, int change)
 {
+    game_replay_record_command(REPLAY_COMMAND_RESOURCE_IMPORT_OVER, resource, change);
     city_data.resource.import_over[resource] = calc_bound(city_data.resource.import_over[resource] + change, 0, 100);
 }
 
@@ -162,6 +165,7 @@ int city_resource_export_over(resource_type resource)
 
 void city_resource_change_export_over(resource_type resource, int change)
 {
+    game_replay_record_command(REPLAY_COMMAND_RESOURCE_EXPORT_OVER, resource, change);
     city_data.resource.export_over[resource] = calc_bound(city_data.resource.export_over[resource] + change, 0, 100);
 }
 
@@ -172,6 +176,7 @@ int city_resource_is_stockpiled(resource_type resource)
 
 void city_resource_toggle_stockpiled(resource_type resource)
 {
+    game_replay_record_command(REPLAY_COMMAND_STOCKPILE_RESOURCE, resource, 0);
     if (city_data.resource.stockpiled[resource]) {
         city_data.resource.stockpiled[resource] = 0;
         city_data.resource.trade_status[resource] |= city_data.resource.export_status_before_stockpiling[resource];
@@ -189,6 +194,7 @@ int city_resource_is_mothballed(resource_type resource)
 
 void city_resource_toggle_mothballed(resource_type resource)
 {
+    game_replay_record_command(REPLAY_COMMAND_MOTHBALL_RESOURCE, resource, 0);
     city_data.resource.mothballed[resource] = city_data.resource.mothballed[resource] ? 0 : 1;
 }
 
@@ -1,6 +1,7 @@
 #include "trade_policy.h"
 
 #include "city/data_private.h"
+#include "game/replay.h"
 
 trade_policy city_trade_policy_get(trade_policy_type type)
 {
@@ -15,6 +16,7 @@ trade_policy city_trade_policy_get(trade_policy_type type)
 
 void city_trade_policy_set(trade_policy_type type, trade_policy policy)
 {
+    game_replay_record_command(REPLAY_COMMAND_TRADE_POLICY, type, policy);
     switch (type) {
         case LAND_TRADE_POLICY:
             city_data.trade.land_policy = policy;
@@ -28,3 +28,55 @@ void array_free(void **data, int blocks)
     }
     free(data);
 }
+
+int array_reserve_free_items(uint32_t **free_items, int *capacity, int size)
+{
+    if (size <= *capacity) {
+        return 1;
+    }
+    int old_words = *capacity >> 5;
+    int new_words = (size + 31) >> 5;
+    if (new_words < 2 * old_words) {
+        new_words = 2 * old_words;
+    }
+    uint32_t *new_free_items = realloc(*free_items, sizeof(uint32_t) * new_words);
+    if (!new_free_items) {
+        return 0;
+    }
+    memset(new_free_items + old_words, 0, sizeof(uint32_t) * (new_words - old_words));
+    *free_items = new_free_items;
+    *capacity = new_words << 5;
+    return 1;
+}
+
+static int lowest_bit(uint32_t value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctz(value);
+#else
+    int bit = 0;
+    while (!(value & 1)) {
+        value >>= 1;
+        bit++;
+    }
+    return bit;
+#endif
+}
+
+int array_next_free_item(const uint32_t *free_items, int start, int end)
+{
+    if (start >= end) {
+        return end;
+    }
+    int word = start >> 5;
+    int last_word = (end - 1) >> 5;
+    uint32_t bits = free_items[word] & (0xffffffffu << (start & 31));
+    while (!bits) {
+        if (++word > last_word) {
+            return end;
+        }
+        bits = free_items[word];
+    }
+    int position = (word << 5) + lowest_bit(bits);
+    return position < end ? position : end;
+}
@@ -1,6 +1,7 @@
 #ifndef CORE_ARRAY_H
 #define CORE_ARRAY_H
 
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -17,6 +18,10 @@ struct { \
     int bit_offset; \
     void (*constructor)(T *, int); \
     int (*in_use)(const T *); \
+    uint32_t *free_items; \
+    int free_items_tracked; \
+    int free_items_capacity; \
+    int first_free_item; \
 }
 
 /**
@@ -36,6 +41,7 @@ struct { \
 #define array_init(a, size, new_item_callback, in_use_callback) \
 ( \
     array_free((void **)(a).items, (a).blocks), \
+    free((a).free_items), \
     memset(&(a), 0, sizeof(a)), \
     (a).constructor = new_item_callback, \
     (a).in_use = in_use_callback, \
@@ -46,6 +52,8 @@ struct { \
 
 /**
  * Creates a new item for the array, either by finding an available empty item or by expanding the array.
+ * The empty item with the lowest position is used. Once array_release_item was called for the array,
+ * empty items are found using a bitmap instead of checking every item.
  * @param a The array structure
  * @param index The index upon which to start searching for a free slot. If index is greater than the arrray size,
  *        the array will be expanded.
@@ -61,7 +69,29 @@ struct { \
             break; \
         } \
     } \
-    if (!error && (a).in_use) { \
+    if (!error && (a).in_use && (a).free_items) { \
+        array_track_free_items(a); \
+    } \
+    if (!error && (a).in_use && (a).free_items) { \
+        int from_first_free = (index) <= (a).first_free_item; \
+        int i = from_first_free ? (a).first_free_item : (index); \
+        while ((i = array_next_free_item((a).free_items, i, (a).size)) < (a).size) { \
+            if (!(a).in_use(array_item(a, i))) { \
+                /* The bit stays set, as the caller may leave the item unused */ \
+                ptr = array_item(a, i); \
+                memset(ptr, 0, sizeof(**(a).items)); \
+                if ((a).constructor) { \
+                    (a).constructor(ptr, i); \
+                } \
+                break; \
+            } \
+            (a).free_items[i >> 5] &= ~(1u << (i & 31)); \
+            i++; \
+        } \
+        if (from_first_free) { \
+            (a).first_free_item = i; \
+        } \
+    } else if (!error && (a).in_use) { \
         for (int i = index; i < (a).size; i++) { \
             if (!(a).in_use(array_item(a, i))) { \
                 ptr = array_item(a, i); \
@@ -78,6 +108,25 @@ struct { \
     } \
 }
 
+/**
+ * Tells the array that an item is no longer in use, so that array_new_item can find it without searching.
+ * After the first call, this must be called every time an item of the array stops being in use,
+ * until the array is initiated again.
+ * The array must have an in_use callback.
+ * @param a The array structure
+ * @param position The position of the item that is no longer in use
+ */
+#define array_release_item(a, position) \
+{ \
+    array_track_free_items(a); \
+    if ((a).free_items && (position) < (a).free_items_tracked) { \
+        (a).free_items[(position) >> 5] |= 1u << ((position) & 31); \
+        if ((position) < (a).first_free_item) { \
+            (a).first_free_item = (position); \
+        } \
+    } \
+}
+
 /**
  * Advances an array, creating a new item, incrementing size and increasing the memory buffer if needed
  * @param a The array structure
@@ -139,6 +188,21 @@ struct { \
     } \
 }
 
+/**
+ * Removes every item from an array while keeping its memory, so that it can be filled again.
+ * The free items bitmap is reset as well. Use this instead of setting the size directly.
+ * @param a The array structure
+ */
+#define array_clear(a) \
+{ \
+    (a).size = 0; \
+    if ((a).free_items) { \
+        memset((a).free_items, 0, sizeof(uint32_t) * ((a).free_items_capacity >> 5)); \
+    } \
+    (a).free_items_tracked = 0; \
+    (a).first_free_item = 0; \
+}
+
 /**
  * Expands an array to fit the specified amount of items. The array may become larger than size, but never smaller.
  * @param a The array structure
@@ -164,6 +228,32 @@ struct { \
     array_item(a, (a).size - 1) \
 )
 
+/**
+ * This definition is private and should not be used.
+ * Adds the items that were added to the array since the last call to the free items bitmap.
+ */
+#define array_track_free_items(a) \
+{ \
+    if ((a).free_items_tracked < (a).size) { \
+        if (array_reserve_free_items(&(a).free_items, &(a).free_items_capacity, (a).size)) { \
+            for (int free_index = (a).free_items_tracked; free_index < (a).size; free_index++) { \
+                if (!(a).in_use(array_item(a, free_index))) { \
+                    (a).free_items[free_index >> 5] |= 1u << (free_index & 31); \
+                    if (free_index < (a).first_free_item) { \
+                        (a).first_free_item = free_index; \
+                    } \
+                } \
+            } \
+            (a).free_items_tracked = (a).size; \
+        } else { \
+            free((a).free_items); \
+            (a).free_items = 0; \
+            (a).free_items_tracked = 0; \
+            (a).free_items_capacity = 0; \
+        } \
+    } \
+}
+
 /**
  * This definition is private and should not be used
  */
@@ -182,6 +272,16 @@ int array_add_blocks(void ***data, int *blocks, int items_per_block, int item_si
  */
 void array_free(void **data, int blocks);
 
+/**
+ * This function is private and should not be used
+ */
+int array_reserve_free_items(uint32_t **free_items, int *capacity, int size);
+
+/**
+ * This function is private and should not be used
+ */
+int array_next_free_item(const uint32_t *free_items, int start, int end);
+
 /**
  * Private helper compile-time functions for finding the next power of two into which a number fits
  */
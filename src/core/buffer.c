@@ -2,6 +2,11 @@
 
 #include <string.h>
 
+// Saved data is little endian, so on little endian machines arrays are copied as they are
+#if defined(__BYTE_ORDER__) && defined(__ORDER_BIG_ENDIAN__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+#define BUFFER_BIG_ENDIAN
+#endif
+
 void buffer_init(buffer *buf, void *data, int size)
 {
     buf->data = data;
@@ -88,6 +93,64 @@ void buffer_write_raw(buffer *buf, const void *value, int size)
     }
 }
 
+// Limits an array to the whole elements that fit in the buffer, like element by element access would
+static int array_count_that_fits(buffer *buf, int count, int element_size)
+{
+    if (check_size(buf, count * element_size)) {
+        return count;
+    }
+    int available = buf->size - buf->index;
+    return available > 0 ? available / element_size : 0;
+}
+
+void buffer_write_u16_array(buffer *buf, const uint16_t *values, int count)
+{
+    int fits = array_count_that_fits(buf, count, 2);
+    uint8_t *data = &buf->data[buf->index];
+#ifdef BUFFER_BIG_ENDIAN
+    for (int i = 0; i < fits; i++) {
+        data[2 * i] = values[i] & 0xff;
+        data[2 * i + 1] = (values[i] >> 8) & 0xff;
+    }
+#else
+    memcpy(data, values, fits * 2);
+#endif
+    buf->index += fits * 2;
+}
+
+void buffer_write_u32_array(buffer *buf, const uint32_t *values, int count)
+{
+    int fits = array_count_that_fits(buf, count, 4);
+    uint8_t *data = &buf->data[buf->index];
+#ifdef BUFFER_BIG_ENDIAN
+    for (int i = 0; i < fits; i++) {
+        data[4 * i] = values[i] & 0xff;
+        data[4 * i + 1] = (values[i] >> 8) & 0xff;
+        data[4 * i + 2] = (values[i] >> 16) & 0xff;
+        data[4 * i + 3] = (values[i] >> 24) & 0xff;
+    }
+#else
+    memcpy(data, values, fits * 4);
+#endif
+    buf->index += fits * 4;
+}
+
+void buffer_write_u32_array_as_u16(buffer *buf, const uint32_t *values, int count)
+{
+    int fits = array_count_that_fits(buf, count, 2);
+    uint8_t *data = &buf->data[buf->index];
+    for (int i = 0; i < fits; i++) {
+#ifdef BUFFER_BIG_ENDIAN
+        data[2 * i] = values[i] & 0xff;
+        data[2 * i + 1] = (values[i] >> 8) & 0xff;
+#else
+        uint16_t value = (uint16_t) values[i];
+        memcpy(&data[2 * i], &value, 2);
+#endif
+    }
+    buf->index += fits * 2;
+}
+
 uint8_t buffer_read_u8(buffer *buf)
 {
     if (check_size(buf, 1)) {
@@ -154,6 +217,54 @@ int32_t buffer_read_i32(buffer *buf)
     }
 }
 
+void buffer_read_u16_array(buffer *buf, uint16_t *values, int count)
+{
+    int fits = array_count_that_fits(buf, count, 2);
+    const uint8_t *data = &buf->data[buf->index];
+#ifdef BUFFER_BIG_ENDIAN
+    for (int i = 0; i < fits; i++) {
+        values[i] = (uint16_t) (data[2 * i] | (data[2 * i + 1] << 8));
+    }
+#else
+    memcpy(values, data, fits * 2);
+#endif
+    memset(&values[fits], 0, (count - fits) * 2);
+    buf->index += fits * 2;
+}
+
+void buffer_read_u32_array(buffer *buf, uint32_t *values, int count)
+{
+    int fits = array_count_that_fits(buf, count, 4);
+    const uint8_t *data = &buf->data[buf->index];
+#ifdef BUFFER_BIG_ENDIAN
+    for (int i = 0; i < fits; i++) {
+        values[i] = data[4 * i] | (data[4 * i + 1] << 8) | (data[4 * i + 2] << 16) |
+            ((uint32_t) data[4 * i + 3] << 24);
+    }
+#else
+    memcpy(values, data, fits * 4);
+#endif
+    memset(&values[fits], 0, (count - fits) * 4);
+    buf->index += fits * 4;
+}
+
+void buffer_read_u16_array_as_u32(buffer *buf, uint32_t *values, int count)
+{
+    int fits = array_count_that_fits(buf, count, 2);
+    const uint8_t *data = &buf->data[buf->index];
+    for (int i = 0; i < fits; i++) {
+#ifdef BUFFER_BIG_ENDIAN
+        values[i] = (uint32_t) (data[2 * i] | (data[2 * i + 1] << 8));
+#else
+        uint16_t value;
+        memcpy(&value, &data[2 * i], 2);
+        values[i] = value;
+#endif
+    }
+    memset(&values[fits], 0, (count - fits) * 4);
+    buf->index += fits * 2;
+}
+
 int buffer_read_raw(buffer *buf, void *value, int max_size)
 {
     int size = buf->size - buf->index;
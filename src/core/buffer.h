@@ -89,6 +89,30 @@ void buffer_write_i32(buffer *buffer, int32_t value);
  */
 void buffer_write_raw(buffer *buffer, const void *value, int size);
 
+/**
+ * Writes an array of unsigned 16-bit integers, as if buffer_write_u16 was called for each of them
+ * @param buffer Buffer
+ * @param values Values to write
+ * @param count Number of values
+ */
+void buffer_write_u16_array(buffer *buffer, const uint16_t *values, int count);
+
+/**
+ * Writes an array of unsigned 32-bit integers, as if buffer_write_u32 was called for each of them
+ * @param buffer Buffer
+ * @param values Values to write
+ * @param count Number of values
+ */
+void buffer_write_u32_array(buffer *buffer, const uint32_t *values, int count);
+
+/**
+ * Writes an array of unsigned 32-bit integers as 16-bit integers, dropping the upper 16 bits of each value
+ * @param buffer Buffer
+ * @param values Values to write
+ * @param count Number of values
+ */
+void buffer_write_u32_array_as_u16(buffer *buffer, const uint32_t *values, int count);
+
 /**
  * Reads an unsigned 8-bit integer
  * @param buffer Buffer
@@ -131,6 +155,30 @@ int16_t buffer_read_i16(buffer *buffer);
  */
 int32_t buffer_read_i32(buffer *buffer);
 
+/**
+ * Reads an array of unsigned 16-bit integers, as if buffer_read_u16 was called for each of them
+ * @param buffer Buffer
+ * @param values Values to read into
+ * @param count Number of values
+ */
+void buffer_read_u16_array(buffer *buffer, uint16_t *values, int count);
+
+/**
+ * Reads an array of unsigned 32-bit integers, as if buffer_read_u32 was called for each of them
+ * @param buffer Buffer
+ * @param values Values to read into
+ * @param count Number of values
+ */
+void buffer_read_u32_array(buffer *buffer, uint32_t *values, int count);
+
+/**
+ * Reads an array of unsigned 16-bit integers into 32-bit integers
+ * @param buffer Buffer
+ * @param values Values to read into
+ * @param count Number of values
+ */
+void buffer_read_u16_array_as_u32(buffer *buffer, uint32_t *values, int count);
+
 /**
  * Reads raw data
  * @param buffer Buffer
@@ -5,15 +5,36 @@
 #include "core/string.h"
 #include "platform/file_manager.h"
 
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 
 #define BASE_MAX_FILES 100
+#define INDEX_MIN_BUCKETS 16
+
+typedef struct index_entry {
+    struct index_entry *next;
+    uint32_t hash;
+    int type;
+    char name[];
+} index_entry;
+
+typedef struct dir_index {
+    struct dir_index *next;
+    index_entry **buckets;
+    uint32_t bucket_mask;
+    int num_entries;
+    char path[];
+} dir_index;
 
 static struct {
     dir_listing listing;
     int max_files;
-    char *cased_filename;
+    struct {
+        dir_index *first;
+        dir_index *building;
+        int building_type;
+    } index;
 } data;
 
 static void allocate_listing_files(int min, int max)
@@ -80,19 +101,194 @@ const dir_listing *dir_find_all_subdirectories(void)
     return &data.listing;
 }
 
-static int compare_case(const char *filename)
+static uint32_t hash_name(const char *name)
+{
+    // FNV-1a over the lower-cased name, so that names that only differ in case share a bucket
+    uint32_t hash = 2166136261u;
+    while (*name) {
+        uint8_t c = (uint8_t) *name++;
+        if (c >= 'A' && c <= 'Z') {
+            c += 'a' - 'A';
+        }
+        hash ^= c;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static const char *get_index_key(const char *dir)
 {
-    if (platform_file_manager_compare_filename(filename, data.cased_filename) == 0) {
-        strcpy(data.cased_filename, filename);
-        return LIST_MATCH;
+    while (dir[0] == '.' && dir[1] == '/') {
+        dir += 2;
     }
-    return LIST_NO_MATCH;
+    return *dir ? dir : ".";
+}
+
+static void append_to_bucket(dir_index *index, index_entry *entry)
+{
+    // Appending keeps the listing order, so the first listed match wins just like before
+    index_entry **slot = &index->buckets[entry->hash & index->bucket_mask];
+    while (*slot) {
+        slot = &(*slot)->next;
+    }
+    entry->next = 0;
+    *slot = entry;
+}
+
+static void grow_index(dir_index *index)
+{
+    uint32_t old_size = index->bucket_mask + 1;
+    index_entry **old_buckets = index->buckets;
+    index_entry **buckets = calloc(2 * old_size, sizeof(index_entry *));
+    if (!buckets) {
+        return;
+    }
+    index->buckets = buckets;
+    index->bucket_mask = 2 * old_size - 1;
+    for (uint32_t i = 0; i < old_size; i++) {
+        index_entry *entry = old_buckets[i];
+        while (entry) {
+            index_entry *next = entry->next;
+            append_to_bucket(index, entry);
+            entry = next;
+        }
+    }
+    free(old_buckets);
+}
+
+static void add_index_entry(dir_index *index, const char *name, int type)
+{
+    uint32_t hash = hash_name(name);
+    for (index_entry *entry = index->buckets[hash & index->bucket_mask]; entry; entry = entry->next) {
+        if (entry->hash == hash && strcmp(entry->name, name) == 0) {
+            entry->type |= type;
+            return;
+        }
+    }
+    if ((uint32_t) index->num_entries > index->bucket_mask) {
+        grow_index(index);
+    }
+    size_t length = strlen(name) + 1;
+    index_entry *entry = malloc(sizeof(index_entry) + length);
+    if (!entry) {
+        return;
+    }
+    entry->hash = hash;
+    entry->type = type;
+    memcpy(entry->name, name, length);
+    append_to_bucket(index, entry);
+    index->num_entries++;
+}
+
+static int add_listed_entry(const char *name)
+{
+    add_index_entry(data.index.building, name, data.index.building_type);
+    return LIST_CONTINUE;
+}
+
+static void free_index(dir_index *index)
+{
+    for (uint32_t i = 0; i <= index->bucket_mask; i++) {
+        index_entry *entry = index->buckets[i];
+        while (entry) {
+            index_entry *next = entry->next;
+            free(entry);
+            entry = next;
+        }
+    }
+    free(index->buckets);
+    free(index);
+}
+
+static dir_index *find_index(const char *dir)
+{
+    const char *key = get_index_key(dir);
+    for (dir_index *index = data.index.first; index; index = index->next) {
+        if (strcmp(index->path, key) == 0) {
+            return index;
+        }
+    }
+    return 0;
+}
+
+static dir_index *create_index(const char *dir)
+{
+    const char *key = get_index_key(dir);
+    size_t length = strlen(key) + 1;
+    dir_index *index = malloc(sizeof(dir_index) + length);
+    if (!index) {
+        return 0;
+    }
+    index->buckets = calloc(INDEX_MIN_BUCKETS, sizeof(index_entry *));
+    if (!index->buckets) {
+        free(index);
+        return 0;
+    }
+    index->bucket_mask = INDEX_MIN_BUCKETS - 1;
+    index->num_entries = 0;
+    memcpy(index->path, key, length);
+
+    // Directories and files are listed separately, because the type filter of the listing is what decides
+    // whether a name counts as a directory or as a file
+    static const int TYPES[] = { TYPE_DIR, TYPE_FILE };
+    data.index.building = index;
+    for (int i = 0; i < 2; i++) {
+        data.index.building_type = TYPES[i];
+        if (platform_file_manager_list_directory_contents(dir, TYPES[i], 0, add_listed_entry) == LIST_ERROR) {
+            data.index.building = 0;
+            free_index(index);
+            return 0;
+        }
+    }
+    data.index.building = 0;
+    index->next = data.index.first;
+    data.index.first = index;
+    return index;
 }
 
 static int correct_case(const char *dir, char *filename, int type)
 {
-    data.cased_filename = filename;
-    return platform_file_manager_list_directory_contents(dir, type, 0, compare_case) == LIST_MATCH;
+    dir_index *index = find_index(dir);
+    if (!index) {
+        index = create_index(dir);
+        if (!index) {
+            return 0;
+        }
+    }
+    uint32_t hash = hash_name(filename);
+    for (index_entry *entry = index->buckets[hash & index->bucket_mask]; entry; entry = entry->next) {
+        if (entry->hash == hash && (entry->type & type) &&
+            platform_file_manager_compare_filename(entry->name, filename) == 0) {
+            strcpy(filename, entry->name);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static dir_index *find_index_of_file(const char *filepath, const char **name)
+{
+    const char *separator = strrchr(filepath, '/');
+    const char *backslash = strrchr(filepath, '\\');
+    if (!separator || (backslash && backslash > separator)) {
+        separator = backslash;
+    }
+    if (!separator) {
+        *name = filepath;
+        return find_index(".");
+    }
+    *name = separator + 1;
+    if (separator == filepath) {
+        return find_index("/");
+    }
+    char dir[2 * FILE_NAME_MAX];
+    size_t length = separator - filepath;
+    if (length >= sizeof(dir)) {
+        return 0;
+    }
+    memcpy(dir, filepath, length);
+    dir[length] = 0;
+    return find_index(dir);
 }
 
 static void move_left(char *str)
@@ -194,3 +390,29 @@ const char *dir_get_asset(const char *asset_path, const char *filepath)
 {
     return get_case_corrected_file(asset_path, filepath);
 }
+
+void dir_add_file_to_index(const char *filepath)
+{
+    const char *name;
+    dir_index *index = find_index_of_file(filepath, &name);
+    if (index && *name) {
+        add_index_entry(index, name, TYPE_FILE);
+    }
+}
+
+void dir_remove_file_from_index(const char *filepath)
+{
+    const char *name;
+    dir_index *index = find_index_of_file(filepath, &name);
+    if (!index) {
+        return;
+    }
+    // Another file may only differ in case from the removed one, so the directory is listed again when needed
+    for (dir_index **slot = &data.index.first; *slot; slot = &(*slot)->next) {
+        if (*slot == index) {
+            *slot = index->next;
+            break;
+        }
+    }
+    free_index(index);
+}
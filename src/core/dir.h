@@ -52,4 +52,17 @@ const char *dir_get_file(const char *filepath, int localizable);
  */
 const char *dir_get_asset(const char *asset_path, const char *filepath);
 
+/**
+ * Adds a newly written file to the index that is used to find files regardless of case.
+ * Does nothing when the directory of the file has not been indexed yet.
+ * @param filepath Path of the file
+ */
+void dir_add_file_to_index(const char *filepath);
+
+/**
+ * Removes the index of the directory of a deleted file, so the directory is listed again when needed
+ * @param filepath Path of the file
+ */
+void dir_remove_file_from_index(const char *filepath);
+
 #endif // CORE_DIR_H
@@ -9,7 +9,11 @@
 
 FILE *file_open(const char *filename, const char *mode)
 {
-    return platform_file_manager_open_file(filename, mode);
+    FILE *fp = platform_file_manager_open_file(filename, mode);
+    if (fp && (strchr(mode, 'w') || strchr(mode, 'a'))) {
+        dir_add_file_to_index(filename);
+    }
+    return fp;
 }
 
 FILE *file_open_asset(const char *asset, const char *mode)
@@ -91,5 +95,7 @@ int file_exists(const char *filename, int localizable)
 
 int file_remove(const char *filename)
 {
-    return platform_file_manager_remove_file(filename);
+    int result = platform_file_manager_remove_file(filename);
+    dir_remove_file_from_index(filename);
+    return result;
 }
@@ -0,0 +1,162 @@
+#include "core/hash.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define PRIME64_1 0x9E3779B185EBCA87ULL
+#define PRIME64_2 0xC2B2AE3D27D4EB4FULL
+#define PRIME64_3 0x165667B19E3779F9ULL
+#define PRIME64_4 0x85EBCA77C2B2AE63ULL
+#define PRIME64_5 0x27D4EB2F165667C5ULL
+
+static inline uint64_t rotate_left(uint64_t value, int bits)
+{
+    return (value << bits) | (value >> (64 - bits));
+}
+
+static inline uint64_t read_u64(const uint8_t *p)
+{
+    return (uint64_t) p[0] | (uint64_t) p[1] << 8 | (uint64_t) p[2] << 16 | (uint64_t) p[3] << 24 |
+        (uint64_t) p[4] << 32 | (uint64_t) p[5] << 40 | (uint64_t) p[6] << 48 | (uint64_t) p[7] << 56;
+}
+
+static inline uint32_t read_u32(const uint8_t *p)
+{
+    return (uint32_t) p[0] | (uint32_t) p[1] << 8 | (uint32_t) p[2] << 16 | (uint32_t) p[3] << 24;
+}
+
+static inline uint64_t round64(uint64_t acc, uint64_t input)
+{
+    acc += input * PRIME64_2;
+    acc = rotate_left(acc, 31);
+    return acc * PRIME64_1;
+}
+
+static inline uint64_t merge_round(uint64_t acc, uint64_t value)
+{
+    acc ^= round64(0, value);
+    return acc * PRIME64_1 + PRIME64_4;
+}
+
+uint64_t hash_bytes(const void *data, size_t length, uint64_t seed)
+{
+    const uint8_t *p = data;
+    const uint8_t *end = p + length;
+    uint64_t hash;
+
+    if (length >= 32) {
+        // Four independent lanes, which the compiler can keep in separate registers or vectorize
+        uint64_t lanes[4] = {
+            seed + PRIME64_1 + PRIME64_2,
+            seed + PRIME64_2,
+            seed,
+            seed - PRIME64_1
+        };
+        const uint8_t *limit = end - 32;
+        do {
+            for (int i = 0; i < 4; i++) {
+                lanes[i] = round64(lanes[i], read_u64(p + i * 8));
+            }
+            p += 32;
+        } while (p <= limit);
+
+        hash = rotate_left(lanes[0], 1) + rotate_left(lanes[1], 7) +
+            rotate_left(lanes[2], 12) + rotate_left(lanes[3], 18);
+        for (int i = 0; i < 4; i++) {
+            hash = merge_round(hash, lanes[i]);
+        }
+    } else {
+        hash = seed + PRIME64_5;
+    }
+    hash += (uint64_t) length;
+
+    while (p + 8 <= end) {
+        hash ^= round64(0, read_u64(p));
+        hash = rotate_left(hash, 27) * PRIME64_1 + PRIME64_4;
+        p += 8;
+    }
+    if (p + 4 <= end) {
+        hash ^= (uint64_t) read_u32(p) * PRIME64_1;
+        hash = rotate_left(hash, 23) * PRIME64_2 + PRIME64_3;
+        p += 4;
+    }
+    while (p < end) {
+        hash ^= *p * PRIME64_5;
+        hash = rotate_left(hash, 11) * PRIME64_1;
+        p++;
+    }
+
+    hash ^= hash >> 33;
+    hash *= PRIME64_2;
+    hash ^= hash >> 29;
+    hash *= PRIME64_3;
+    hash ^= hash >> 32;
+    return hash;
+}
+
+static void *resize(void *memory, size_t size)
+{
+    void *resized = realloc(memory, size);
+    if (!resized) {
+        free(memory);
+    }
+    return resized;
+}
+
+int hash_cache_start(hash_cache *cache, int num_items, size_t item_size, int state_size)
+{
+    if (!cache->state || cache->item_size != item_size || cache->state_size < state_size) {
+        hash_cache_free(cache);
+        cache->item_size = item_size;
+        cache->state_size = state_size;
+        cache->state = malloc(state_size);
+        if (!cache->state) {
+            return 0;
+        }
+    }
+    if (num_items > cache->capacity) {
+        cache->copies = resize(cache->copies, num_items * item_size);
+        cache->hashes = resize(cache->hashes, num_items * sizeof(uint64_t));
+        if (!cache->copies || !cache->hashes) {
+            hash_cache_free(cache);
+            return 0;
+        }
+        cache->capacity = num_items;
+    }
+    cache->num_items = num_items;
+    return 1;
+}
+
+void hash_cache_add_item(hash_cache *cache, int index, const void *item, hash_item_writer writer)
+{
+    uint8_t *copy = &cache->copies[index * cache->item_size];
+    if (index < cache->valid_items && memcmp(copy, item, cache->item_size) == 0) {
+        return;
+    }
+    buffer buf;
+    buffer_init(&buf, cache->state, cache->state_size);
+    writer(&buf, item);
+    uint64_t hash = hash_bytes(cache->state, buf.index, 0);
+    memcpy(copy, item, cache->item_size);
+
+    // Stored in little endian order, so that the combined hash is the same on every platform
+    buffer_init(&buf, &cache->hashes[index * sizeof(uint64_t)], sizeof(uint64_t));
+    buffer_write_u32(&buf, (uint32_t) hash);
+    buffer_write_u32(&buf, (uint32_t) (hash >> 32));
+    if (index == cache->valid_items) {
+        cache->valid_items++;
+    }
+}
+
+uint64_t hash_cache_finish(hash_cache *cache, uint64_t seed)
+{
+    return hash_bytes(cache->hashes, cache->num_items * sizeof(uint64_t), seed);
+}
+
+void hash_cache_free(hash_cache *cache)
+{
+    free(cache->copies);
+    free(cache->hashes);
+    free(cache->state);
+    memset(cache, 0, sizeof(hash_cache));
+}
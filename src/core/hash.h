@@ -0,0 +1,77 @@
+#ifndef CORE_HASH_H
+#define CORE_HASH_H
+
+#include "core/buffer.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @file
+ * Fast non-cryptographic hashing of memory blocks.
+ */
+
+/**
+ * Calculates a 64-bit hash of a block of memory, using the XXH64 algorithm.
+ * The result does not depend on the endianness of the platform.
+ * @param data Data to hash
+ * @param length Length of the data in bytes
+ * @param seed Seed, can be used to chain hashes of several blocks
+ * @return Hash of the data
+ */
+uint64_t hash_bytes(const void *data, size_t length, uint64_t seed);
+
+/**
+ * Function that writes the saved state of one item to a buffer
+ */
+typedef void (*hash_item_writer)(buffer *buf, const void *item);
+
+/**
+ * Remembers the hash of the saved state of each item of an array, so that only changed items are written again
+ */
+typedef struct {
+    uint8_t *copies;
+    uint8_t *hashes;
+    uint8_t *state;
+    size_t item_size;
+    int state_size;
+    int num_items;
+    int valid_items;
+    int capacity;
+} hash_cache;
+
+/**
+ * Prepares the cache for hashing a number of items
+ * @param cache Cache
+ * @param num_items Number of items that will be hashed
+ * @param item_size Size of an item in memory
+ * @param state_size Maximum size of the saved state of an item
+ * @return Boolean true if the cache has room for the items, false if out of memory
+ */
+int hash_cache_start(hash_cache *cache, int num_items, size_t item_size, int state_size);
+
+/**
+ * Hashes an item. The item is only written again if its memory changed since it was last hashed.
+ * The saved state of an item must only depend on the item itself.
+ * @param cache Cache
+ * @param index Index of the item
+ * @param item Item
+ * @param writer Function that writes the saved state of the item
+ */
+void hash_cache_add_item(hash_cache *cache, int index, const void *item, hash_item_writer writer);
+
+/**
+ * Calculates the combined hash of all items
+ * @param cache Cache
+ * @param seed Seed, can be used to chain hashes of several blocks
+ * @return Hash of the items
+ */
+uint64_t hash_cache_finish(hash_cache *cache, uint64_t seed);
+
+/**
+ * Frees the memory of the cache
+ * @param cache Cache
+ */
+void hash_cache_free(hash_cache *cache);
+
+#endif // CORE_HASH_H
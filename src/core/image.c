@@ -6,6 +6,7 @@
 #include "core/image_packer.h"
 #include "core/io.h"
 #include "core/log.h"
+#include "core/trace.h"
 #include "graphics/font.h"
 #include "graphics/renderer.h"
 
@@ -605,7 +606,7 @@ static void release_external_buffers(void)
     }
 }
 
-int image_load_climate(int climate_id, int is_editor, int force_reload, int keep_atlas_buffers)
+static int load_climate(int climate_id, int is_editor, int force_reload, int keep_atlas_buffers)
 {
     if (climate_id == data.current_climate && is_editor == data.is_editor && !force_reload &&
         graphics_renderer()->has_image_atlas(ATLAS_MAIN)) {
@@ -625,11 +626,10 @@ int image_load_climate(int climate_id, int is_editor, int force_reload, int keep
 
     const char *filename_bmp = is_editor ? EDITOR_GRAPHICS_555[climate_id] : MAIN_GRAPHICS_555[climate_id];
     const char *filename_idx = is_editor ? EDITOR_GRAPHICS_SG2[climate_id] : MAIN_GRAPHICS_SG2[climate_id];
-    uint8_t *tmp_data = malloc(MAIN_DATA_SIZE * sizeof(uint8_t));
+    io_file_contents file;
     image_draw_data *draw_data = malloc((IMAGE_MAIN_ENTRIES + data.images_with_tops) * sizeof(image_draw_data));
-    if (!tmp_data || !draw_data ||
-        MAIN_INDEX_SIZE != io_read_file_into_buffer(filename_idx, MAY_BE_LOCALIZED, tmp_data, MAIN_INDEX_SIZE)) {
-        free(tmp_data);
+    if (MAIN_INDEX_SIZE != io_map_file(filename_idx, MAY_BE_LOCALIZED, MAIN_INDEX_SIZE, &file) || !draw_data) {
+        io_unmap_file(&file);
         free(draw_data);
         return 0;
     }
@@ -637,18 +637,19 @@ int image_load_climate(int climate_id, int is_editor, int force_reload, int keep
     memset(draw_data, 0, IMAGE_MAIN_ENTRIES * sizeof(image_draw_data));
 
     buffer buf;
-    buffer_init(&buf, tmp_data, HEADER_SIZE);
+    buffer_init(&buf, file.data, HEADER_SIZE);
     read_header(&buf);
-    buffer_init(&buf, &tmp_data[HEADER_SIZE], ENTRY_SIZE * IMAGE_MAIN_ENTRIES);
-    if (!prepare_images(&buf, data.main, draw_data, IMAGE_MAIN_ENTRIES, ATLAS_MAIN)) {
-        free(tmp_data);
+    buffer_init(&buf, &file.data[HEADER_SIZE], ENTRY_SIZE * IMAGE_MAIN_ENTRIES);
+    int prepared = prepare_images(&buf, data.main, draw_data, IMAGE_MAIN_ENTRIES, ATLAS_MAIN);
+    io_unmap_file(&file);
+    if (!prepared) {
         free(draw_data);
         return 0;
     }
 
-    int data_size = io_read_file_into_buffer(filename_bmp, MAY_BE_LOCALIZED, tmp_data, MAIN_DATA_SIZE);
+    int data_size = io_map_file(filename_bmp, MAY_BE_LOCALIZED, MAIN_DATA_SIZE, &file);
     if (!data_size) {
-        free(tmp_data);
+        io_unmap_file(&file);
         free_draw_data(draw_data, IMAGE_MAIN_ENTRIES);
         release_external_buffers();
         free(data.external_draw_data);
@@ -656,9 +657,9 @@ int image_load_climate(int climate_id, int is_editor, int force_reload, int keep
         return 0;
     }
 
-    buffer_init(&buf, tmp_data, data_size);
+    buffer_init(&buf, file.data, data_size);
     if (!crop_and_pack_images(&buf, data.main, draw_data, IMAGE_MAIN_ENTRIES, ATLAS_MAIN)) {
-        free(tmp_data);
+        io_unmap_file(&file);
         free_draw_data(draw_data, IMAGE_MAIN_ENTRIES);
         release_external_buffers();
         free(data.external_draw_data);
@@ -670,7 +671,7 @@ int image_load_climate(int climate_id, int is_editor, int force_reload, int keep
         data.packer.result.images_needed, data.packer.result.last_image_width, data.packer.result.last_image_height);
     if (!atlas_data) {
         image_packer_free(&data.packer);
-        free(tmp_data);
+        io_unmap_file(&file);
         free_draw_data(draw_data, IMAGE_MAIN_ENTRIES);
         release_external_buffers();
         free(data.external_draw_data);
@@ -680,7 +681,7 @@ int image_load_climate(int climate_id, int is_editor, int force_reload, int keep
 
     convert_images(data.main, draw_data, IMAGE_MAIN_ENTRIES, &buf, atlas_data);
     free_draw_data(draw_data, IMAGE_MAIN_ENTRIES);
-    free(tmp_data);
+    io_unmap_file(&file);
     make_plain_fonts_white(data.main, atlas_data, image_group(GROUP_FONT));
     if (!keep_atlas_buffers) {
         assets_init(data.is_editor != is_editor, atlas_data->buffers, atlas_data->image_widths);
@@ -701,6 +702,14 @@ int image_load_climate(int climate_id, int is_editor, int force_reload, int keep
     return 1;
 }
 
+int image_load_climate(int climate_id, int is_editor, int force_reload, int keep_atlas_buffers)
+{
+    TRACE_BEGIN("load climate images");
+    int result = load_climate(climate_id, is_editor, force_reload, keep_atlas_buffers);
+    TRACE_END();
+    return result;
+}
+
 static void free_font_memory(void)
 {
     graphics_renderer()->free_image_atlas(ATLAS_FONT);
@@ -722,43 +731,43 @@ static int alloc_font_memory(int font_entries)
 
 static int load_cyrillic_fonts(void)
 {
-    uint8_t *tmp_data = malloc(CYRILLIC_FONT_DATA_SIZE * sizeof(uint8_t));
     image_draw_data *draw_data = malloc(CYRILLIC_FONT_ENTRIES * sizeof(image_draw_data));
-    if (!tmp_data || !draw_data || !alloc_font_memory(CYRILLIC_FONT_ENTRIES)) {
-        free(tmp_data);
+    if (!draw_data || !alloc_font_memory(CYRILLIC_FONT_ENTRIES)) {
         free_draw_data(draw_data, CYRILLIC_FONT_ENTRIES);
         return 0;
     }
     memset(draw_data, 0, CYRILLIC_FONT_ENTRIES * sizeof(image_draw_data));
 
-    if (CYRILLIC_FONT_INDEX_SIZE != io_read_file_part_into_buffer(CYRILLIC_FONTS_SG2, MAY_BE_LOCALIZED,
-        tmp_data, CYRILLIC_FONT_INDEX_SIZE, CYRILLIC_FONT_INDEX_OFFSET)) {
+    io_file_contents file;
+    int index_end = CYRILLIC_FONT_INDEX_OFFSET + CYRILLIC_FONT_INDEX_SIZE;
+    if (index_end != io_map_file(CYRILLIC_FONTS_SG2, MAY_BE_LOCALIZED, index_end, &file)) {
+        io_unmap_file(&file);
         free_font_memory();
-        free(tmp_data);
         free_draw_data(draw_data, CYRILLIC_FONT_ENTRIES);
         return 0;
     }
     buffer buf;
-    buffer_init(&buf, tmp_data, CYRILLIC_FONT_INDEX_SIZE);
-    if (!prepare_images(&buf, data.font, draw_data, CYRILLIC_FONT_ENTRIES, ATLAS_FONT)) {
+    buffer_init(&buf, &file.data[CYRILLIC_FONT_INDEX_OFFSET], CYRILLIC_FONT_INDEX_SIZE);
+    int prepared = prepare_images(&buf, data.font, draw_data, CYRILLIC_FONT_ENTRIES, ATLAS_FONT);
+    io_unmap_file(&file);
+    if (!prepared) {
         free_font_memory();
-        free(tmp_data);
         free_draw_data(draw_data, CYRILLIC_FONT_ENTRIES);
         return 0;
     }
 
-    int data_size = io_read_file_into_buffer(CYRILLIC_FONTS_555, MAY_BE_LOCALIZED, tmp_data, CYRILLIC_FONT_DATA_SIZE);
+    int data_size = io_map_file(CYRILLIC_FONTS_555, MAY_BE_LOCALIZED, CYRILLIC_FONT_DATA_SIZE, &file);
     if (!data_size) {
+        io_unmap_file(&file);
         free_font_memory();
-        free(tmp_data);
         free_draw_data(draw_data, CYRILLIC_FONT_ENTRIES);
         return 0;
     }
 
-    buffer_init(&buf, tmp_data, data_size);
+    buffer_init(&buf, file.data, data_size);
     if (!crop_and_pack_images(&buf, data.font, draw_data, CYRILLIC_FONT_ENTRIES, ATLAS_FONT)) {
         free_font_memory();
-        free(tmp_data);
+        io_unmap_file(&file);
         free_draw_data(draw_data, CYRILLIC_FONT_ENTRIES);
         return 0;
     }
@@ -768,13 +777,13 @@ static int load_cyrillic_fonts(void)
     if (!atlas_data) {
         image_packer_free(&data.packer);
         free_font_memory();
-        free(tmp_data);
+        io_unmap_file(&file);
         free_draw_data(draw_data, CYRILLIC_FONT_ENTRIES);
         return 0;
     }
 
     convert_images(data.font, draw_data, CYRILLIC_FONT_ENTRIES, &buf, atlas_data);
-    free(tmp_data);
+    io_unmap_file(&file);
     free_draw_data(draw_data, CYRILLIC_FONT_ENTRIES);
     make_plain_fonts_white(data.font, atlas_data, CYRILLIC_FONT_BASE_OFFSET);
     graphics_renderer()->create_image_atlas(atlas_data, 1);
@@ -917,38 +926,38 @@ static int load_multibyte_font(multibyte_font_type type)
 
     int entries = FONT_STYLES * font_info->chars;
 
-    uint8_t *tmp_data = malloc(font_info->data_size * sizeof(uint8_t));
-    if (!tmp_data || !alloc_font_memory(entries)) {
-        free(tmp_data);
+    if (!alloc_font_memory(entries)) {
         return 0;
     }
 
     log_info("Parsing multibyte font", font_info->name, 0);
 
     int file_version = 2;
-    int data_size = io_read_file_into_buffer(font_info->file_v2, MAY_BE_LOCALIZED, tmp_data, font_info->data_size);
+    io_file_contents file;
+    int data_size = io_map_file(font_info->file_v2, MAY_BE_LOCALIZED, font_info->data_size, &file);
     if (!data_size) {
         if (font_info->file_v1) {
             file_version = 1;
-            data_size = io_read_file_into_buffer(font_info->file_v1, MAY_BE_LOCALIZED, tmp_data, font_info->data_size);
+            io_unmap_file(&file);
+            data_size = io_map_file(font_info->file_v1, MAY_BE_LOCALIZED, font_info->data_size, &file);
         }
         if (!data_size) {
             free_font_memory();
-            free(tmp_data);
+            io_unmap_file(&file);
             log_error("Augustus requires extra files for the characters:", font_info->file_v2, 0);
             return 0;
         }
     }
 
     buffer input;
-    buffer_init(&input, tmp_data, data_size);
+    buffer_init(&input, file.data, data_size);
     int num_chars = font_info->chars;
     int num_half_width = font_info->half_width_chars;
     int num_full_width = num_chars - num_half_width;
 
     if (image_packer_init(&data.packer, entries, data.max_image_width, data.max_image_height) != IMAGE_PACKER_OK) {
         free_font_memory();
-        free(tmp_data);
+        io_unmap_file(&file);
         log_error("Internal error loading font", 0, 0);
         return 0;
     }
@@ -977,7 +986,7 @@ static int load_multibyte_font(multibyte_font_type type)
     if (!font_data) {
         image_packer_free(&data.packer);
         free_font_memory();
-        free(tmp_data);
+        io_unmap_file(&file);
         return 0;
     }
 
@@ -987,6 +996,7 @@ static int load_multibyte_font(multibyte_font_type type)
         font_offset += parse_multibyte_font(&input, font_offset, &font_sizes[i], font_info->letter_spacing,
             num_chars, num_half_width, num_chars * i);
     }
+    io_unmap_file(&file);
 
     image_packer_pack(&data.packer);
     const image_atlas_data *atlas_data = graphics_renderer()->prepare_image_atlas(ATLAS_FONT,
@@ -995,7 +1005,6 @@ static int load_multibyte_font(multibyte_font_type type)
         free(font_data);
         image_packer_free(&data.packer);
         free_font_memory();
-        free(tmp_data);
         return 0;
     }
 
@@ -1027,7 +1036,6 @@ static int load_multibyte_font(multibyte_font_type type)
 
     image_packer_free(&data.packer);
     free(font_data);
-    free(tmp_data);
     data.fonts_enabled = MULTIBYTE_IN_FONT;
     data.font_base_offset = 0;
     return 1;
@@ -1053,7 +1061,7 @@ int image_load_fonts(encoding_type encoding)
     }
 }
 
-int image_load_enemy(int enemy_id)
+static int load_enemy(int enemy_id)
 {
     if (enemy_id == data.current_enemy && graphics_renderer()->has_image_atlas(ATLAS_ENEMY)) {
         return 1;
@@ -1071,35 +1079,36 @@ int image_load_enemy(int enemy_id)
 
     memset(data.enemy, 0, sizeof(data.enemy));
 
-    uint8_t *tmp_data = malloc(ENEMY_DATA_SIZE * sizeof(uint8_t));
     image_draw_data *draw_data = malloc(ENEMY_ENTRIES * sizeof(image_draw_data));
     memset(draw_data, 0, ENEMY_ENTRIES * sizeof(image_draw_data));
 
-    if (!tmp_data || ENEMY_INDEX_SIZE != io_read_file_part_into_buffer(
-        filename_idx, MAY_BE_LOCALIZED, tmp_data, ENEMY_INDEX_SIZE, ENEMY_INDEX_OFFSET)) {
-        free(tmp_data);
+    io_file_contents file;
+    int index_end = ENEMY_INDEX_OFFSET + ENEMY_INDEX_SIZE;
+    if (index_end != io_map_file(filename_idx, MAY_BE_LOCALIZED, index_end, &file)) {
+        io_unmap_file(&file);
         free_draw_data(draw_data, ENEMY_ENTRIES);
         return 0;
     }
 
     buffer buf;
-    buffer_init(&buf, tmp_data, ENEMY_INDEX_SIZE);
-    if (!prepare_images(&buf, data.enemy, draw_data, ENEMY_ENTRIES, ATLAS_ENEMY)) {
-        free(tmp_data);
+    buffer_init(&buf, &file.data[ENEMY_INDEX_OFFSET], ENEMY_INDEX_SIZE);
+    int prepared = prepare_images(&buf, data.enemy, draw_data, ENEMY_ENTRIES, ATLAS_ENEMY);
+    io_unmap_file(&file);
+    if (!prepared) {
         free_draw_data(draw_data, ENEMY_ENTRIES);
         return 0;
     }
 
-    int data_size = io_read_file_into_buffer(filename_bmp, MAY_BE_LOCALIZED, tmp_data, ENEMY_DATA_SIZE);
+    int data_size = io_map_file(filename_bmp, MAY_BE_LOCALIZED, ENEMY_DATA_SIZE, &file);
     if (!data_size) {
-        free(tmp_data);
+        io_unmap_file(&file);
         free_draw_data(draw_data, ENEMY_ENTRIES);
         return 0;
     }
 
-    buffer_init(&buf, tmp_data, data_size);
+    buffer_init(&buf, file.data, data_size);
     if (!crop_and_pack_images(&buf, data.enemy, draw_data, ENEMY_ENTRIES, ATLAS_ENEMY)) {
-        free(tmp_data);
+        io_unmap_file(&file);
         free_draw_data(draw_data, ENEMY_ENTRIES);
         return 0;
     }
@@ -1107,14 +1116,14 @@ int image_load_enemy(int enemy_id)
     const image_atlas_data *atlas_data = graphics_renderer()->prepare_image_atlas(ATLAS_ENEMY,
         data.packer.result.images_needed, data.packer.result.last_image_width, data.packer.result.last_image_height);
     if (!atlas_data) {
-        free(tmp_data);
+        io_unmap_file(&file);
         free_draw_data(draw_data, ENEMY_ENTRIES);
         image_packer_free(&data.packer);
         return 0;
     }
 
     convert_images(data.enemy, draw_data, ENEMY_ENTRIES, &buf, atlas_data);
-    free(tmp_data);
+    io_unmap_file(&file);
     free_draw_data(draw_data, ENEMY_ENTRIES);
     data.current_enemy = enemy_id;
     graphics_renderer()->create_image_atlas(atlas_data, 1);
@@ -1123,6 +1132,14 @@ int image_load_enemy(int enemy_id)
     return 1;
 }
 
+int image_load_enemy(int enemy_id)
+{
+    TRACE_BEGIN("load enemy images");
+    int result = load_enemy(enemy_id);
+    TRACE_END();
+    return result;
+}
+
 int image_is_external(const image *img)
 {
     return (img->atlas.id >> IMAGE_ATLAS_BIT_OFFSET) == ATLAS_EXTERNAL;
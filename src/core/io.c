@@ -1,9 +1,20 @@
 #include "core/io.h"
 
 #include <stdio.h>
+#include <stdlib.h>
 
 #include "core/file.h"
 
+#if defined(_WIN32)
+#define USE_MMAP
+#include <io.h>
+#include <windows.h>
+#elif (defined(__unix__) || defined(__APPLE__)) && !defined(__vita__) && !defined(__SWITCH__) && \
+    !defined(__EMSCRIPTEN__)
+#define USE_MMAP
+#include <sys/mman.h>
+#endif
+
 int io_read_file_into_buffer(const char *filepath, int localizable, void *buffer, int max_size)
 {
     const char *cased_file = dir_get_file(filepath, localizable);
@@ -43,6 +54,82 @@ int io_read_file_part_into_buffer(const char *filepath, int localizable, void *b
     return bytes_read;
 }
 
+static uint8_t *map_contents(FILE *fp, int size)
+{
+#if defined(USE_MMAP) && defined(_WIN32)
+    HANDLE file = (HANDLE) _get_osfhandle(_fileno(fp));
+    if (file == INVALID_HANDLE_VALUE) {
+        return 0;
+    }
+    HANDLE mapping = CreateFileMapping(file, 0, PAGE_WRITECOPY, 0, 0, 0);
+    if (!mapping) {
+        return 0;
+    }
+    void *data = MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, (SIZE_T) size);
+    // The view keeps the mapping alive
+    CloseHandle(mapping);
+    return data;
+#elif defined(USE_MMAP)
+    void *data = mmap(0, (size_t) size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fileno(fp), 0);
+    return data == MAP_FAILED ? 0 : data;
+#else
+    return 0;
+#endif
+}
+
+int io_map_file(const char *filepath, int localizable, int max_size, io_file_contents *contents)
+{
+    contents->data = 0;
+    contents->size = 0;
+    contents->is_mapped = 0;
+    const char *cased_file = dir_get_file(filepath, localizable);
+    if (!cased_file) {
+        return 0;
+    }
+    FILE *fp = file_open(cased_file, "rb");
+    if (!fp) {
+        return 0;
+    }
+    fseek(fp, 0, SEEK_END);
+    long size = ftell(fp);
+    if (size > max_size) {
+        size = max_size;
+    }
+    if (size <= 0) {
+        file_close(fp);
+        return 0;
+    }
+    contents->data = map_contents(fp, (int) size);
+    if (contents->data) {
+        contents->is_mapped = 1;
+        contents->size = (int) size;
+    } else {
+        contents->data = malloc((size_t) size);
+        if (contents->data) {
+            fseek(fp, 0, SEEK_SET);
+            contents->size = (int) fread(contents->data, 1, (size_t) size, fp);
+        }
+    }
+    file_close(fp);
+    return contents->size;
+}
+
+void io_unmap_file(io_file_contents *contents)
+{
+    if (contents->is_mapped) {
+#if defined(USE_MMAP) && defined(_WIN32)
+        UnmapViewOfFile(contents->data);
+#elif defined(USE_MMAP)
+        munmap(contents->data, (size_t) contents->size);
+#endif
+    } else {
+        free(contents->data);
+    }
+    contents->data = 0;
+    contents->size = 0;
+    contents->is_mapped = 0;
+}
+
 int io_write_buffer_to_file(const char *filepath, const void *buffer, int size)
 {
     // Find existing file to overwrite
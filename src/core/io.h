@@ -3,11 +3,22 @@
 
 #include "core/dir.h"
 
+#include <stdint.h>
+
 /**
  * @file
  * I/O functions.
  */
 
+/**
+ * Contents of a file that is mapped into memory
+ */
+typedef struct {
+    uint8_t *data; /**< Read-only: contents of the file, changes are not written back */
+    int size; /**< Read-only: number of bytes available */
+    int is_mapped; /**< Read-only: whether the contents are mapped or read into allocated memory */
+} io_file_contents;
+
 /**
  * Reads the entire file into the buffer
  * @param filepath File to read
@@ -28,6 +39,23 @@ int io_read_file_into_buffer(const char *filepath, int localizable, void *buffer
  */
 int io_read_file_part_into_buffer(const char *filepath, int localizable, void *buffer, int size, int offset_in_file);
 
+/**
+ * Maps the file into memory, so it can be parsed without copying it first.
+ * When the file cannot be mapped, it is read into allocated memory instead.
+ * @param filepath File to map
+ * @param localizable Whether the file may be localized (see core/dir.h)
+ * @param max_size Max size to map
+ * @param contents Contents of the file, must be released using io_unmap_file, even when mapping fails
+ * @return Number of bytes available
+ */
+int io_map_file(const char *filepath, int localizable, int max_size, io_file_contents *contents);
+
+/**
+ * Releases the contents of a mapped file
+ * @param contents Contents to release
+ */
+void io_unmap_file(io_file_contents *contents);
+
 /**
  * Writes the entire buffer to the file
  * @param filepath File to write
@@ -0,0 +1,378 @@
+#include "job.h"
+
+#include "core/log.h"
+#include "platform/thread.h"
+
+#include <stdint.h>
+
+#define MAX_THREADS 16
+#define QUEUE_SIZE 128
+
+typedef struct work_group work_group;
+
+typedef struct {
+    work_group *group;
+    int index;
+} task;
+
+typedef struct {
+    platform_mutex *lock;
+    task tasks[QUEUE_SIZE];
+    int top;
+    int bottom;
+} task_queue;
+
+struct work_group {
+    int remaining;
+    const job *jobs;
+    int pending[JOB_MAX_BATCH_SIZE];
+    uint32_t dependents[JOB_MAX_BATCH_SIZE];
+    void (*range_function)(int chunk, int start, int end, void *data);
+    void *data;
+    int count;
+    int num_chunks;
+};
+
+static struct {
+    int num_threads;
+    platform_thread *threads[MAX_THREADS];
+    task_queue queues[MAX_THREADS];
+    platform_mutex *lock;
+    platform_condition *wakeup;
+    int queued;
+    int next_queue;
+    int quit;
+} data;
+
+static int push_task(work_group *group, int index)
+{
+    platform_mutex_lock(data.lock);
+    int queue_id = data.next_queue;
+    data.next_queue = (data.next_queue + 1) % data.num_threads;
+    platform_mutex_unlock(data.lock);
+
+    task_queue *queue = &data.queues[queue_id];
+    platform_mutex_lock(queue->lock);
+    if (queue->bottom - queue->top >= QUEUE_SIZE) {
+        platform_mutex_unlock(queue->lock);
+        return 0;
+    }
+    task *t = &queue->tasks[queue->bottom % QUEUE_SIZE];
+    t->group = group;
+    t->index = index;
+    queue->bottom++;
+    platform_mutex_unlock(queue->lock);
+
+    platform_mutex_lock(data.lock);
+    data.queued++;
+    platform_condition_broadcast(data.wakeup);
+    platform_mutex_unlock(data.lock);
+    return 1;
+}
+
+static int pop_own_task(task_queue *queue, task *t)
+{
+    int found = 0;
+    platform_mutex_lock(queue->lock);
+    if (queue->bottom > queue->top) {
+        queue->bottom--;
+        *t = queue->tasks[queue->bottom % QUEUE_SIZE];
+        found = 1;
+        if (queue->bottom == queue->top) {
+            queue->bottom = queue->top = 0;
+        }
+    }
+    platform_mutex_unlock(queue->lock);
+    return found;
+}
+
+static int steal_task(task_queue *queue, task *t)
+{
+    int found = 0;
+    platform_mutex_lock(queue->lock);
+    if (queue->bottom > queue->top) {
+        *t = queue->tasks[queue->top % QUEUE_SIZE];
+        queue->top++;
+        found = 1;
+        if (queue->bottom == queue->top) {
+            queue->bottom = queue->top = 0;
+        }
+    }
+    platform_mutex_unlock(queue->lock);
+    return found;
+}
+
+static int take_task(int thread_id, task *t)
+{
+    int found = pop_own_task(&data.queues[thread_id], t);
+    for (int i = 1; i < data.num_threads && !found; i++) {
+        found = steal_task(&data.queues[(thread_id + i) % data.num_threads], t);
+    }
+    if (found) {
+        platform_mutex_lock(data.lock);
+        data.queued--;
+        platform_mutex_unlock(data.lock);
+    }
+    return found;
+}
+
+static void run_task(work_group *group, int index);
+
+static void schedule_task(work_group *group, int index)
+{
+    if (!push_task(group, index)) {
+        run_task(group, index);
+    }
+}
+
+static void finish_task(work_group *group, int index)
+{
+    uint32_t ready = 0;
+    platform_mutex_lock(data.lock);
+    if (group->jobs) {
+        for (int i = index + 1; i < JOB_MAX_BATCH_SIZE; i++) {
+            if ((group->dependents[index] & (1u << i)) && --group->pending[i] == 0) {
+                ready |= 1u << i;
+            }
+        }
+    }
+    group->remaining--;
+    if (!group->remaining) {
+        platform_condition_broadcast(data.wakeup);
+    }
+    platform_mutex_unlock(data.lock);
+    for (int i = index + 1; ready; i++) {
+        if (ready & (1u << i)) {
+            ready &= ~(1u << i);
+            schedule_task(group, i);
+        }
+    }
+}
+
+static void run_chunk(work_group *group, int chunk)
+{
+    int start = (int) ((int64_t) group->count * chunk / group->num_chunks);
+    int end = (int) ((int64_t) group->count * (chunk + 1) / group->num_chunks);
+    group->range_function(chunk, start, end, group->data);
+}
+
+static void run_task(work_group *group, int index)
+{
+    if (group->jobs) {
+        group->jobs[index].function(group->jobs[index].data);
+    } else {
+        run_chunk(group, index);
+    }
+    finish_task(group, index);
+}
+
+static int worker_main(void *arg)
+{
+    int thread_id = (int) (intptr_t) arg;
+    while (1) {
+        task t;
+        if (take_task(thread_id, &t)) {
+            run_task(t.group, t.index);
+            continue;
+        }
+        platform_mutex_lock(data.lock);
+        while (!data.queued && !data.quit) {
+            platform_condition_wait(data.wakeup, data.lock);
+        }
+        int quit = data.quit;
+        platform_mutex_unlock(data.lock);
+        if (quit) {
+            return 0;
+        }
+    }
+}
+
+static void wait_for_group(work_group *group)
+{
+    while (1) {
+        platform_mutex_lock(data.lock);
+        int remaining = group->remaining;
+        platform_mutex_unlock(data.lock);
+        if (!remaining) {
+            return;
+        }
+        task t;
+        if (take_task(0, &t)) {
+            run_task(t.group, t.index);
+            continue;
+        }
+        platform_mutex_lock(data.lock);
+        while (group->remaining && !data.queued) {
+            platform_condition_wait(data.wakeup, data.lock);
+        }
+        platform_mutex_unlock(data.lock);
+    }
+}
+
+static void destroy_primitives(void)
+{
+    for (int i = 0; i < MAX_THREADS; i++) {
+        if (data.queues[i].lock) {
+            platform_mutex_destroy(data.queues[i].lock);
+            data.queues[i].lock = 0;
+        }
+    }
+    if (data.wakeup) {
+        platform_condition_destroy(data.wakeup);
+        data.wakeup = 0;
+    }
+    if (data.lock) {
+        platform_mutex_destroy(data.lock);
+        data.lock = 0;
+    }
+}
+
+static void stop_threads(void)
+{
+    platform_mutex_lock(data.lock);
+    data.quit = 1;
+    platform_condition_broadcast(data.wakeup);
+    platform_mutex_unlock(data.lock);
+    for (int i = 1; i < MAX_THREADS; i++) {
+        if (data.threads[i]) {
+            platform_thread_wait(data.threads[i]);
+            data.threads[i] = 0;
+        }
+    }
+}
+
+void job_system_init(void)
+{
+    if (data.num_threads) {
+        return;
+    }
+    data.num_threads = 1;
+    int wanted_threads = platform_thread_cpu_count();
+    if (wanted_threads > MAX_THREADS) {
+        wanted_threads = MAX_THREADS;
+    }
+    if (wanted_threads <= 1) {
+        return;
+    }
+    data.lock = platform_mutex_create();
+    data.wakeup = platform_condition_create();
+    if (!data.lock || !data.wakeup) {
+        destroy_primitives();
+        return;
+    }
+    for (int i = 0; i < wanted_threads; i++) {
+        data.queues[i].top = 0;
+        data.queues[i].bottom = 0;
+        data.queues[i].lock = platform_mutex_create();
+        if (!data.queues[i].lock) {
+            destroy_primitives();
+            return;
+        }
+    }
+    data.quit = 0;
+    data.queued = 0;
+    data.next_queue = 0;
+    data.num_threads = wanted_threads;
+    for (int i = 1; i < wanted_threads; i++) {
+        data.threads[i] = platform_thread_create(worker_main, "job worker", (void *) (intptr_t) i);
+        if (!data.threads[i]) {
+            log_error("Unable to start job worker thread", 0, i);
+            stop_threads();
+            destroy_primitives();
+            data.num_threads = 1;
+            return;
+        }
+    }
+    log_info("Job system threads:", 0, data.num_threads);
+}
+
+void job_system_shutdown(void)
+{
+    if (data.num_threads > 1) {
+        stop_threads();
+        destroy_primitives();
+    }
+    data.num_threads = 0;
+}
+
+int job_system_num_threads(void)
+{
+    return data.num_threads ? data.num_threads : 1;
+}
+
+static int conflicts(const job *earlier, const job *later)
+{
+    return (earlier->writes & (later->reads | later->writes)) || (earlier->reads & later->writes);
+}
+
+void job_run_batch(const job *jobs, int num_jobs)
+{
+    if (num_jobs > JOB_MAX_BATCH_SIZE) {
+        log_error("Too many jobs in batch:", 0, num_jobs);
+        num_jobs = JOB_MAX_BATCH_SIZE;
+    }
+    if (data.num_threads <= 1 || num_jobs <= 1) {
+        for (int i = 0; i < num_jobs; i++) {
+            jobs[i].function(jobs[i].data);
+        }
+        return;
+    }
+    work_group group = { 0 };
+    group.jobs = jobs;
+    group.remaining = num_jobs;
+    for (int later = 0; later < num_jobs; later++) {
+        for (int earlier = 0; earlier < later; earlier++) {
+            if (conflicts(&jobs[earlier], &jobs[later])) {
+                group.pending[later]++;
+                group.dependents[earlier] |= 1u << later;
+            }
+        }
+    }
+    // Find the jobs without dependencies first: once scheduled, finished jobs lower the pending counts
+    // of the others, which must then only be scheduled by finish_task
+    uint32_t ready = 0;
+    for (int i = 0; i < num_jobs; i++) {
+        if (!group.pending[i]) {
+            ready |= 1u << i;
+        }
+    }
+    for (int i = 0; i < num_jobs; i++) {
+        if (ready & (1u << i)) {
+            schedule_task(&group, i);
+        }
+    }
+    wait_for_group(&group);
+}
+
+int job_parallel_for_num_chunks(int count, int min_chunk_size)
+{
+    if (count <= 0) {
+        return 0;
+    }
+    if (min_chunk_size < 1) {
+        min_chunk_size = 1;
+    }
+    int chunks = (count + min_chunk_size - 1) / min_chunk_size;
+    return chunks > JOB_MAX_CHUNKS ? JOB_MAX_CHUNKS : chunks;
+}
+
+void job_parallel_for(int count, int min_chunk_size,
+    void (*function)(int chunk, int start, int end, void *data), void *function_data)
+{
+    work_group group = { 0 };
+    group.range_function = function;
+    group.data = function_data;
+    group.count = count;
+    group.num_chunks = job_parallel_for_num_chunks(count, min_chunk_size);
+    if (data.num_threads <= 1 || group.num_chunks <= 1) {
+        for (int i = 0; i < group.num_chunks; i++) {
+            run_chunk(&group, i);
+        }
+        return;
+    }
+    group.remaining = group.num_chunks;
+    for (int i = 0; i < group.num_chunks; i++) {
+        schedule_task(&group, i);
+    }
+    wait_for_group(&group);
+}
@@ -0,0 +1,66 @@
+#ifndef CORE_JOB_H
+#define CORE_JOB_H
+
+/**
+ * @file
+ * Job system that spreads independent pieces of work over worker threads.
+ * Every worker has its own queue, and idle workers steal jobs from the other queues.
+ *
+ * Jobs in a batch declare which data sets they read and write. A job only starts after
+ * every earlier job in the same batch that writes data it uses, or uses data it writes,
+ * has finished. A batch therefore always has the same result as running its jobs in order.
+ */
+
+#define JOB_MAX_BATCH_SIZE 32
+#define JOB_MAX_CHUNKS 64
+
+typedef struct {
+    void (*function)(void *data); /**< Function to run */
+    void *data; /**< Data to pass to the function */
+    unsigned int reads; /**< Bitmask of the data sets that the job reads */
+    unsigned int writes; /**< Bitmask of the data sets that the job writes */
+} job;
+
+/**
+ * Starts the worker threads. When no threads can be started, all jobs run on the calling thread.
+ */
+void job_system_init(void);
+
+/**
+ * Stops the worker threads
+ */
+void job_system_shutdown(void);
+
+/**
+ * Gets the number of threads that run jobs, including the thread that submits them
+ * @return Number of threads
+ */
+int job_system_num_threads(void);
+
+/**
+ * Runs a batch of jobs and waits for all of them to finish
+ * @param jobs Jobs to run, in the order in which they would run sequentially
+ * @param num_jobs Number of jobs, at most JOB_MAX_BATCH_SIZE
+ */
+void job_run_batch(const job *jobs, int num_jobs);
+
+/**
+ * Gets the number of chunks job_parallel_for splits a range into.
+ * The result only depends on the parameters, not on the number of threads.
+ * @param count Number of items in the range
+ * @param min_chunk_size Minimum number of items per chunk
+ * @return Number of chunks, at most JOB_MAX_CHUNKS
+ */
+int job_parallel_for_num_chunks(int count, int min_chunk_size);
+
+/**
+ * Splits the range [0, count) into chunks, runs the function for every chunk and waits for all of them
+ * @param count Number of items in the range
+ * @param min_chunk_size Minimum number of items per chunk
+ * @param function Function to run for every chunk, with the chunk index and the item range [start, end)
+ * @param data Data to pass to the function
+ */
+void job_parallel_for(int count, int min_chunk_size,
+    void (*function)(int chunk, int start, int end, void *data), void *data);
+
+#endif // CORE_JOB_H
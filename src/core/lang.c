@@ -6,6 +6,7 @@
 #include "core/io.h"
 #include "core/log.h"
 #include "core/string.h"
+#include "core/trace.h"
 #include "scenario/building.h"
 #include "translation/translation.h"
 
@@ -73,15 +74,18 @@ static void parse_text(buffer *buf)
     buffer_read_raw(buf, data.text_data, MAX_TEXT_DATA);
 }
 
-static int load_text(const char *filename, int localizable, uint8_t *buf_data)
+static int load_text(const char *filename, int localizable)
 {
     buffer buf;
-    int filesize = io_read_file_into_buffer(filename, localizable, buf_data, BUFFER_SIZE);
+    io_file_contents file;
+    int filesize = io_map_file(filename, localizable, BUFFER_SIZE, &file);
     if (filesize < MIN_TEXT_SIZE || filesize > MAX_TEXT_SIZE) {
+        io_unmap_file(&file);
         return 0;
     }
-    buffer_init(&buf, buf_data, filesize);
+    buffer_init(&buf, file.data, filesize);
     parse_text(&buf);
+    io_unmap_file(&file);
     return 1;
 }
 
@@ -298,27 +302,27 @@ void load_custom_messages(void)
 }
 
 
-static int load_message(const char *filename, int localizable, uint8_t *data_buffer)
+static int load_message(const char *filename, int localizable)
 {
     buffer buf;
-    int filesize = io_read_file_into_buffer(filename, localizable, data_buffer, BUFFER_SIZE);
+    io_file_contents file;
+    int filesize = io_map_file(filename, localizable, BUFFER_SIZE, &file);
     if (filesize < MIN_MESSAGE_SIZE || filesize > MAX_MESSAGE_SIZE) {
+        io_unmap_file(&file);
         return 0;
     }
-    buffer_init(&buf, data_buffer, filesize);
+    buffer_init(&buf, file.data, filesize);
     parse_message(&buf);
+    io_unmap_file(&file);
     return 1;
 }
 
 static int load_files(const char *text_filename, const char *message_filename, int localizable)
 {
-    uint8_t *buffer = (uint8_t *) malloc(BUFFER_SIZE);
-    if (!buffer) {
-        return 0;
-    }
-    int success = load_text(text_filename, localizable, buffer) && load_message(message_filename, localizable, buffer);
-    free(buffer);
-    return success;
+    TRACE_BEGIN("load language files");
+    int result = load_text(text_filename, localizable) && load_message(message_filename, localizable);
+    TRACE_END();
+    return result;
 }
 
 int lang_load(int is_editor)
@@ -18,6 +18,11 @@ static struct {
     int32_t pool[MAX_RANDOM];
 } data;
 
+static struct {
+    int enabled;
+    uint32_t state;
+} stdlib_seed;
+
 void random_init(void)
 {
     memset(&data, 0, sizeof(data));
@@ -95,7 +100,17 @@ void random_save_state(buffer *buf)
     buffer_write_u32(buf, data.iv2);
 }
 
+void random_set_stdlib_seed(uint32_t seed)
+{
+    stdlib_seed.enabled = seed != 0;
+    stdlib_seed.state = seed;
+}
+
 int random_from_stdlib(void) {
+    if (stdlib_seed.enabled) {
+        stdlib_seed.state = stdlib_seed.state * 1103515245 + 12345;
+        return (stdlib_seed.state >> 16) & 0x7fff;
+    }
     time_t t;
     srand((unsigned)time(&t));
     return rand();
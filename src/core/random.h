@@ -68,5 +68,12 @@ void random_save_state(buffer *buf);
  */
 void random_load_state(buffer *buf);
 
+/**
+ * Makes random_from_stdlib return a reproducible sequence instead of a time-seeded one.
+ * Used when recording or playing back replays.
+ * @param seed Seed to use, or 0 to go back to time-seeded values
+ */
+void random_set_stdlib_seed(uint32_t seed);
+
 int random_from_stdlib(void);
 #endif // CORE_RANDOM_H
@@ -0,0 +1,120 @@
+#include "rle.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#define REPEAT_FLAG 0x80
+#define MIN_REPEAT 2
+#define MAX_REPEAT 129
+#define MAX_LITERALS 128
+
+static int is_valid_element_size(int element_size)
+{
+    return element_size == 1 || element_size == 2 || element_size == 4;
+}
+
+static int same_element(const uint8_t *a, const uint8_t *b, int element_size)
+{
+    switch (element_size) {
+        case 1:
+            return *a == *b;
+        case 2:
+            return a[0] == b[0] && a[1] == b[1];
+        default: {
+            uint32_t value_a, value_b;
+            memcpy(&value_a, a, 4);
+            memcpy(&value_b, b, 4);
+            return value_a == value_b;
+        }
+    }
+}
+
+int rle_compress(const void *input_buffer, int input_length, int element_size,
+    void *output_buffer, int output_buffer_length, int *output_length)
+{
+    if (!is_valid_element_size(element_size) || input_length % element_size || output_buffer_length < 1) {
+        return 0;
+    }
+    const uint8_t *input = input_buffer;
+    uint8_t *output = output_buffer;
+    int count = input_length / element_size;
+    int position = 0;
+    output[position++] = (uint8_t) element_size;
+
+    int i = 0;
+    while (i < count) {
+        const uint8_t *element = &input[i * element_size];
+        int run = 1;
+        while (i + run < count && run < MAX_REPEAT &&
+            same_element(element, &input[(i + run) * element_size], element_size)) {
+            run++;
+        }
+        if (run >= MIN_REPEAT) {
+            if (position + 1 + element_size > output_buffer_length) {
+                return 0;
+            }
+            output[position++] = (uint8_t) (REPEAT_FLAG | (run - MIN_REPEAT));
+            memcpy(&output[position], element, element_size);
+            position += element_size;
+            i += run;
+            continue;
+        }
+        // Collect elements until the next repeated element starts a run
+        int literals = 1;
+        while (i + literals < count && literals < MAX_LITERALS && (i + literals + 1 >= count ||
+            !same_element(&input[(i + literals) * element_size], &input[(i + literals + 1) * element_size],
+                element_size))) {
+            literals++;
+        }
+        int bytes = literals * element_size;
+        if (position + 1 + bytes > output_buffer_length) {
+            return 0;
+        }
+        output[position++] = (uint8_t) (literals - 1);
+        memcpy(&output[position], element, bytes);
+        position += bytes;
+        i += literals;
+    }
+    *output_length = position;
+    return 1;
+}
+
+int rle_decompress(const void *input_buffer, int input_length, void *output_buffer, int output_length)
+{
+    const uint8_t *input = input_buffer;
+    uint8_t *output = output_buffer;
+    if (input_length < 1 || !is_valid_element_size(input[0]) || output_length % input[0]) {
+        return 0;
+    }
+    int element_size = input[0];
+    int position = 1;
+    int written = 0;
+    while (position < input_length) {
+        int control = input[position++];
+        if (control & REPEAT_FLAG) {
+            int run = control - REPEAT_FLAG + MIN_REPEAT;
+            if (position + element_size > input_length || written + run * element_size > output_length) {
+                return 0;
+            }
+            if (element_size == 1) {
+                memset(&output[written], input[position], run);
+                written += run;
+            } else {
+                for (int i = 0; i < run; i++) {
+                    memcpy(&output[written], &input[position], element_size);
+                    written += element_size;
+                }
+            }
+            position += element_size;
+        } else {
+            int bytes = (control + 1) * element_size;
+            if (position + bytes > input_length || written + bytes > output_length) {
+                return 0;
+            }
+            memcpy(&output[written], &input[position], bytes);
+            position += bytes;
+            written += bytes;
+        }
+    }
+    return written == output_length;
+}
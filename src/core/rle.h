@@ -0,0 +1,37 @@
+#ifndef CORE_RLE_H
+#define CORE_RLE_H
+
+/**
+ * @file
+ * Run length encoding of arrays of 1, 2 or 4 byte elements.
+ * Much faster than zlib, and almost as small for grids that mostly contain long runs of the same value.
+ *
+ * The encoded data starts with the element size, followed by runs. A run starts with a control byte:
+ * values 0 to 127 are followed by 1 to 128 different elements, values 128 to 255 are followed by
+ * one element that is repeated 2 to 129 times.
+ */
+
+/**
+ * Compresses the input buffer
+ * @param input_buffer Input buffer to compress
+ * @param input_length Length of the input buffer, a multiple of the element size
+ * @param element_size Size of one element: 1, 2 or 4
+ * @param output_buffer Output buffer to write compressed data to
+ * @param output_buffer_length Available length of the output buffer
+ * @param output_length Written bytes
+ * @return boolean true on success, false when the output buffer is too small
+ */
+int rle_compress(const void *input_buffer, int input_length, int element_size,
+    void *output_buffer, int output_buffer_length, int *output_length);
+
+/**
+ * Decompresses the input buffer
+ * @param input_buffer Input buffer to decompress
+ * @param input_length Length of the input buffer
+ * @param output_buffer Output buffer to write decompressed data to
+ * @param output_length Length of the decompressed data, which has to match exactly
+ * @return boolean true on success, false on error
+ */
+int rle_decompress(const void *input_buffer, int input_length, void *output_buffer, int output_length);
+
+#endif // CORE_RLE_H
@@ -0,0 +1,159 @@
+#include "trace.h"
+
+#include "core/log.h"
+
+#ifdef TRACING
+
+#include "core/file.h"
+#include "platform/thread.h"
+#include "platform/timer.h"
+
+#include <stdint.h>
+#include <stdio.h>
+
+#define MAX_EVENTS 65536
+
+typedef enum {
+    EVENT_BEGIN = 'B',
+    EVENT_END = 'E',
+    EVENT_COUNTER = 'C'
+} event_type;
+
+typedef struct {
+    const char *name;
+    uint64_t timestamp;
+    unsigned long thread_id;
+    int value;
+    event_type type;
+} trace_event;
+
+static struct {
+    FILE *fp;
+    platform_mutex *lock;
+    uint64_t start_time;
+    int events_written;
+    int num_events;
+    trace_event events[MAX_EVENTS];
+} data;
+
+static void write_events(void)
+{
+    for (int i = 0; i < data.num_events; i++) {
+        const trace_event *event = &data.events[i];
+        fprintf(data.fp, "%s\n{\"ph\":\"%c\",\"ts\":%llu,\"pid\":1,\"tid\":%lu", data.events_written ? "," : "",
+            event->type, (unsigned long long) event->timestamp, event->thread_id);
+        if (event->type == EVENT_BEGIN) {
+            fprintf(data.fp, ",\"name\":\"%s\"}", event->name);
+        } else if (event->type == EVENT_COUNTER) {
+            fprintf(data.fp, ",\"name\":\"%s\",\"args\":{\"value\":%d}}", event->name, event->value);
+        } else {
+            fputc('}', data.fp);
+        }
+        data.events_written = 1;
+    }
+    data.num_events = 0;
+}
+
+static void add_event(event_type type, const char *name, int value)
+{
+    if (!data.fp) {
+        return;
+    }
+    uint64_t now = platform_timer_microseconds();
+    platform_mutex_lock(data.lock);
+    if (data.fp) {
+        // Writing a full buffer stalls the traced thread for a moment, but keeps memory use bounded
+        if (data.num_events == MAX_EVENTS) {
+            write_events();
+        }
+        trace_event *event = &data.events[data.num_events++];
+        event->name = name;
+        event->timestamp = now - data.start_time;
+        event->thread_id = platform_thread_current_id();
+        event->value = value;
+        event->type = type;
+    }
+    platform_mutex_unlock(data.lock);
+}
+
+int trace_start(const char *filename)
+{
+    if (data.fp) {
+        return 0;
+    }
+    if (!data.lock) {
+        data.lock = platform_mutex_create();
+        if (!data.lock) {
+            log_error("Unable to create trace lock", 0, 0);
+            return 0;
+        }
+    }
+    FILE *fp = file_open(filename, "w");
+    if (!fp) {
+        log_error("Unable to open trace file", filename, 0);
+        return 0;
+    }
+    fputs("{\"traceEvents\":[", fp);
+    platform_mutex_lock(data.lock);
+    data.num_events = 0;
+    data.events_written = 0;
+    data.start_time = platform_timer_microseconds();
+    data.fp = fp;
+    platform_mutex_unlock(data.lock);
+    log_info("Writing trace to", filename, 0);
+    return 1;
+}
+
+void trace_stop(void)
+{
+    if (!data.fp) {
+        return;
+    }
+    platform_mutex_lock(data.lock);
+    write_events();
+    fputs("\n]}\n", data.fp);
+    file_close(data.fp);
+    data.fp = 0;
+    platform_mutex_unlock(data.lock);
+}
+
+void trace_begin(const char *name)
+{
+    add_event(EVENT_BEGIN, name, 0);
+}
+
+void trace_end(void)
+{
+    add_event(EVENT_END, 0, 0);
+}
+
+void trace_counter(const char *name, int value)
+{
+    add_event(EVENT_COUNTER, name, value);
+}
+
+#else
+
+int trace_start(const char *filename)
+{
+    log_error("Unable to trace: this build was compiled without TRACING", filename, 0);
+    return 0;
+}
+
+void trace_stop(void)
+{
+}
+
+void trace_begin(const char *name)
+{
+}
+
+void trace_end(void)
+{
+}
+
+void trace_counter(const char *name, int value)
+{
+}
+
+#endif
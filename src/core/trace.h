@@ -0,0 +1,53 @@
+#ifndef CORE_TRACE_H
+#define CORE_TRACE_H
+
+/**
+ * @file
+ * Timing spans and counters that can be written to a trace file in the Chrome trace event format,
+ * which can be opened with chrome://tracing or the Perfetto UI.
+ *
+ * Tracing is only compiled in when TRACING is defined. Otherwise the TRACE_ macros do nothing and
+ * do not evaluate their arguments, so use them instead of calling the functions directly.
+ */
+
+#ifdef TRACING
+#define TRACE_BEGIN(name) trace_begin(name)
+#define TRACE_END() trace_end()
+#define TRACE_COUNTER(name, value) trace_counter(name, value)
+#else
+#define TRACE_BEGIN(name) ((void) 0)
+#define TRACE_END() ((void) 0)
+#define TRACE_COUNTER(name, value) ((void) sizeof(value))
+#endif
+
+/**
+ * Starts recording spans and counters
+ * @param filename File to write the trace to
+ * @return Boolean true if the trace file could be opened, false otherwise
+ */
+int trace_start(const char *filename);
+
+/**
+ * Stops recording and writes the remaining events to the trace file
+ */
+void trace_stop(void);
+
+/**
+ * Begins a span on the calling thread. Spans on the same thread have to be nested.
+ * @param name Name of the span, a string literal
+ */
+void trace_begin(const char *name);
+
+/**
+ * Ends the last span that was begun on the calling thread
+ */
+void trace_end(void);
+
+/**
+ * Records the value of a counter
+ * @param name Name of the counter, a string literal
+ * @param value Value of the counter
+ */
+void trace_counter(const char *name, int value);
+
+#endif // CORE_TRACE_H
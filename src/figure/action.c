@@ -2,6 +2,7 @@
 
 #include "city/entertainment.h"
 #include "city/figures.h"
+#include "core/trace.h"
 #include "figure/figure.h"
 #include "figuretype/animal.h"
 #include "figuretype/cartpusher.h"
@@ -122,11 +123,14 @@ static void (*figure_action_callbacks[])(figure *f) = {
 
 void figure_action_handle(void)
 {
+    TRACE_BEGIN("figure actions");
     city_figures_reset();
     city_entertainment_set_hippodrome_has_race(0);
+    int active_figures = 0;
     for (int i = 1; i < figure_count(); i++) {
         figure *f = figure_get(i);
         if (f->state) {
+            active_figures++;
             if (f->targeted_by_figure_id) {
                 figure *attacker = figure_get(f->targeted_by_figure_id);
                 if (attacker->state != FIGURE_STATE_ALIVE) {
@@ -142,4 +146,6 @@ void figure_action_handle(void)
             }
         }
     }
+    TRACE_COUNTER("figures", active_figures);
+    TRACE_END();
 }
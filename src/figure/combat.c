@@ -12,6 +12,10 @@
 #include "map/figure.h"
 #include "sound/effect.h"
 
+static struct {
+    int max_distance;
+} target_search;
+
 static int is_attacking_native(const figure *f)
 {
     return f->type == FIGURE_INDIGENOUS_NATIVE && f->action_state == FIGURE_ACTION_159_NATIVE_ATTACKING;
@@ -150,28 +154,24 @@ void figure_combat_handle_attack(figure *f)
     }
 }
 
-int figure_combat_get_target_for_soldier(int x, int y, int max_distance)
+static int get_soldier_target_score(figure *f, int distance)
 {
-    int min_figure_id = 0;
-    int min_distance = 10000;
-    for (int i = 1; i < figure_count(); i++) {
-        figure *f = figure_get(i);
-        if (figure_is_dead(f)) {
-            continue;
-        }
-        if (figure_is_enemy(f) || f->type == FIGURE_RIOTER || is_attacking_native(f)) {
-            int distance = calc_maximum_distance(x, y, f->x, f->y);
-            if (distance <= max_distance) {
-                if (f->targeted_by_figure_id) {
-                    distance *= 2; // penalty
-                }
-                if (distance < min_distance) {
-                    min_distance = distance;
-                    min_figure_id = i;
-                }
-            }
-        }
+    if (figure_is_dead(f) || distance > target_search.max_distance) {
+        return -1;
+    }
+    if (!figure_is_enemy(f) && f->type != FIGURE_RIOTER && !is_attacking_native(f)) {
+        return -1;
+    }
+    if (f->targeted_by_figure_id) {
+        distance *= 2; // penalty
     }
+    return distance;
+}
+
+int figure_combat_get_target_for_soldier(int x, int y, int max_distance)
+{
+    target_search.max_distance = max_distance;
+    int min_figure_id = map_figure_find_nearest(x, y, 10000, get_soldier_target_score);
     if (min_figure_id) {
         return min_figure_id;
     }
@@ -187,73 +187,59 @@ int figure_combat_get_target_for_soldier(int x, int y, int max_distance)
     return 0;
 }
 
+static int get_wolf_target_score(figure *f, int distance)
+{
+    if (figure_is_dead(f) || !f->type) {
+        return -1;
+    }
+    switch (f->type) {
+        case FIGURE_EXPLOSION:
+        case FIGURE_FORT_STANDARD:
+        case FIGURE_TRADE_SHIP:
+        case FIGURE_FISHING_BOAT:
+        case FIGURE_MAP_FLAG:
+        case FIGURE_FLOTSAM:
+        case FIGURE_SHIPWRECK:
+        case FIGURE_INDIGENOUS_NATIVE:
+        case FIGURE_TOWER_SENTRY:
+        case FIGURE_NATIVE_TRADER:
+        case FIGURE_ARROW:
+        case FIGURE_JAVELIN:
+        case FIGURE_BOLT:
+        case FIGURE_BALLISTA:
+        case FIGURE_FRIENDLY_ARROW:
+        case FIGURE_WATCHTOWER_ARCHER:
+        case FIGURE_CREATURE:
+            return -1;
+    }
+    if (figure_is_enemy(f) || figure_is_herd(f)) {
+        return -1;
+    }
+    if (figure_is_legion(f) && f->action_state == FIGURE_ACTION_80_SOLDIER_AT_REST) {
+        return -1;
+    }
+    if (f->targeted_by_figure_id) {
+        distance *= 2;
+    }
+    return distance;
+}
+
 int figure_combat_get_target_for_wolf(int x, int y, int max_distance)
 {
-    int min_figure_id = 0;
-    int min_distance = 10000;
-    for (int i = 1; i < figure_count(); i++) {
-        figure *f = figure_get(i);
-        if (figure_is_dead(f) || !f->type) {
-            continue;
-        }
-        switch (f->type) {
-            case FIGURE_EXPLOSION:
-            case FIGURE_FORT_STANDARD:
-            case FIGURE_TRADE_SHIP:
-            case FIGURE_FISHING_BOAT:
-            case FIGURE_MAP_FLAG:
-            case FIGURE_FLOTSAM:
-            case FIGURE_SHIPWRECK:
-            case FIGURE_INDIGENOUS_NATIVE:
-            case FIGURE_TOWER_SENTRY:
-            case FIGURE_NATIVE_TRADER:
-            case FIGURE_ARROW:
-            case FIGURE_JAVELIN:
-            case FIGURE_BOLT:
-            case FIGURE_BALLISTA:
-            case FIGURE_FRIENDLY_ARROW:
-            case FIGURE_WATCHTOWER_ARCHER:
-            case FIGURE_CREATURE:
-                continue;
-        }
-        if (figure_is_enemy(f) || figure_is_herd(f)) {
-            continue;
-        }
-        if (figure_is_legion(f) && f->action_state == FIGURE_ACTION_80_SOLDIER_AT_REST) {
-            continue;
-        }
-        int distance = calc_maximum_distance(x, y, f->x, f->y);
-        if (f->targeted_by_figure_id) {
-            distance *= 2;
-        }
-        if (distance < min_distance) {
-            min_distance = distance;
-            min_figure_id = i;
-        }
-    }
-    if (min_distance <= max_distance && min_figure_id) {
-        return min_figure_id;
+    return map_figure_find_nearest(x, y, max_distance + 1, get_wolf_target_score);
+}
+
+static int get_enemy_target_score(figure *f, int distance)
+{
+    if (figure_is_dead(f) || f->targeted_by_figure_id || !figure_is_legion(f)) {
+        return -1;
     }
-    return 0;
+    return distance;
 }
 
 int figure_combat_get_target_for_enemy(int x, int y)
 {
-    int min_figure_id = 0;
-    int min_distance = 10000;
-    for (int i = 1; i < figure_count(); i++) {
-        figure *f = figure_get(i);
-        if (figure_is_dead(f)) {
-            continue;
-        }
-        if (!f->targeted_by_figure_id && figure_is_legion(f)) {
-            int distance = calc_maximum_distance(x, y, f->x, f->y);
-            if (distance < min_distance) {
-                min_distance = distance;
-                min_figure_id = i;
-            }
-        }
-    }
+    int min_figure_id = map_figure_find_nearest(x, y, 10000, get_enemy_target_score);
     if (min_figure_id) {
         return min_figure_id;
     }
@@ -287,6 +273,9 @@ static int is_valid_missile_target(figure *f, formation *formation)
     return 0;
 }
 
+// The missile target searches visit every figure in id order instead of searching the figure grid:
+// launching a missile is checked using figure 0 as scratch, which is saved, so the checks must happen
+// for the same candidates in the same order. The cheap distance check always comes first.
 int figure_combat_get_missile_target_for_soldier(figure *shooter, int max_distance, map_point *tile)
 {
     int x = shooter->x;
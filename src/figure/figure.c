@@ -2,6 +2,7 @@
 
 #include "building/building.h"
 #include "core/array.h"
+#include "core/hash.h"
 #include "core/log.h"
 #include "city/emperor.h"
 #include "core/random.h"
@@ -18,11 +19,13 @@
 #define FIGURE_ARRAY_SIZE_STEP 1000
 
 #define FIGURE_ORIGINAL_BUFFER_SIZE 128
-#define FIGURE_CURRENT_BUFFER_SIZE 130
+#define FIGURE_WIDE_COORDINATES_BUFFER_SIZE 154
+#define FIGURE_CURRENT_BUFFER_SIZE 154
 
 static struct {
     int created_sequence;
     array(figure) figures;
+    hash_cache state_hash;
 } data;
 
 figure *figure_get(int id)
@@ -181,6 +184,7 @@ void figure_delete(figure *f)
     memset(f, 0, sizeof(figure));
     f->id = figure_id;
 
+    array_release_item(data.figures, figure_id);
     array_trim(data.figures);
 }
 
@@ -353,6 +357,16 @@ static void figure_save(buffer *buf, const figure *f)
     buffer_write_i16(buf, f->attacker_id2);
     buffer_write_i16(buf, f->opponent_id);
     buffer_write_i16(buf, f->last_visited_index);
+    buffer_write_u16(buf, f->x);
+    buffer_write_u16(buf, f->y);
+    buffer_write_u16(buf, f->previous_tile_x);
+    buffer_write_u16(buf, f->previous_tile_y);
+    buffer_write_u16(buf, f->destination_x);
+    buffer_write_u16(buf, f->destination_y);
+    buffer_write_u16(buf, f->source_x);
+    buffer_write_u16(buf, f->source_y);
+    buffer_write_i32(buf, f->grid_offset);
+    buffer_write_i32(buf, f->destination_grid_offset);
 }
 
 static int get_resource_id(figure_type type, int resource)
@@ -404,10 +418,10 @@ static void figure_load(buffer *buf, figure *f, int figure_buf_size, int version
     f->previous_tile_y = buffer_read_u8(buf);
     f->missile_damage = buffer_read_u8(buf);
     f->damage = buffer_read_u8(buf);
-    f->grid_offset = buffer_read_i16(buf);
+    f->grid_offset = map_grid_offset_from_saved(buffer_read_i16(buf));
     f->destination_x = buffer_read_u8(buf);
     f->destination_y = buffer_read_u8(buf);
-    f->destination_grid_offset = buffer_read_i16(buf);
+    f->destination_grid_offset = map_grid_offset_from_saved(buffer_read_i16(buf));
     f->source_x = buffer_read_u8(buf);
     f->source_y = buffer_read_u8(buf);
     f->formation_position_x.soldier = buffer_read_u8(buf);
@@ -481,6 +495,18 @@ static void figure_load(buffer *buf, figure *f, int figure_buf_size, int version
     if (version > SAVE_GAME_LAST_GLOBAL_BUILDING_INFO) {
         f->last_visited_index = buffer_read_i16(buf);
     }
+    if (figure_buf_size >= FIGURE_WIDE_COORDINATES_BUFFER_SIZE) {
+        f->x = buffer_read_u16(buf);
+        f->y = buffer_read_u16(buf);
+        f->previous_tile_x = buffer_read_u16(buf);
+        f->previous_tile_y = buffer_read_u16(buf);
+        f->destination_x = buffer_read_u16(buf);
+        f->destination_y = buffer_read_u16(buf);
+        f->source_x = buffer_read_u16(buf);
+        f->source_y = buffer_read_u16(buf);
+        f->grid_offset = map_grid_offset_from_saved(buffer_read_i32(buf));
+        f->destination_grid_offset = map_grid_offset_from_saved(buffer_read_i32(buf));
+    }
 
     // The following code should only be executed if the savegame includes figure information that is not 
     // supported on this specific version of Augustus. The extra bytes in the buffer must be skipped in order
@@ -494,6 +520,9 @@ void figure_save_state(buffer *list, buffer *seq)
 {
     buffer_write_i32(seq, data.created_sequence);
 
+    if (!list) {
+        return;
+    }
     int buf_size = 4 + data.figures.size * FIGURE_CURRENT_BUFFER_SIZE;
     uint8_t *buf_data = malloc(buf_size);
     buffer_init(list, buf_data, buf_size);
@@ -505,6 +534,23 @@ void figure_save_state(buffer *list, buffer *seq)
     }
 }
 
+static void write_figure_state(buffer *buf, const void *item)
+{
+    figure_save(buf, item);
+}
+
+uint64_t figure_hash_state(uint64_t seed)
+{
+    if (!hash_cache_start(&data.state_hash, data.figures.size, sizeof(figure), FIGURE_CURRENT_BUFFER_SIZE)) {
+        log_error("Out of memory for the figure state hash", 0, 0);
+        return 0;
+    }
+    for (int i = 0; i < data.figures.size; i++) {
+        hash_cache_add_item(&data.state_hash, i, array_item(data.figures, i), write_figure_state);
+    }
+    return hash_cache_finish(&data.state_hash, seed);
+}
+
 void figure_load_state(buffer *list, buffer *seq, int version)
 {
     data.created_sequence = buffer_read_i32(seq);
@@ -29,18 +29,18 @@ typedef struct {
     signed char direction;
     signed char previous_tile_direction;
     signed char attack_direction;
-    unsigned char x;
-    unsigned char y;
-    unsigned char previous_tile_x;
-    unsigned char previous_tile_y;
+    unsigned short x;
+    unsigned short y;
+    unsigned short previous_tile_x;
+    unsigned short previous_tile_y;
     unsigned char missile_damage;
     unsigned char damage;
-    short grid_offset;
-    unsigned char destination_x;
-    unsigned char destination_y;
-    short destination_grid_offset; // only used for soldiers
-    unsigned char source_x;
-    unsigned char source_y;
+    int grid_offset;
+    unsigned short destination_x;
+    unsigned short destination_y;
+    int destination_grid_offset; // only used for soldiers
+    unsigned short source_x;
+    unsigned short source_y;
     union {
         unsigned char soldier;
         signed char enemy;
@@ -157,4 +157,11 @@ void figure_save_state(buffer *list, buffer *seq);
 
 void figure_load_state(buffer *list, buffer *seq, int version);
 
+/**
+ * Hashes the saved state of all figures. Only the figures that changed since the last call are saved again.
+ * @param seed Seed of the hash
+ * @return Hash of the figures
+ */
+uint64_t figure_hash_state(uint64_t seed);
+
 #endif // FIGURE_FIGURE_H
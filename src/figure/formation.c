@@ -14,13 +14,15 @@
 #include "figure/formation_herd.h"
 #include "figure/formation_legion.h"
 #include "figure/properties.h"
+#include "game/replay.h"
 #include "game/save_version.h"
 #include "map/grid.h"
 #include "sound/effect.h"
 
 #define FORMATION_ARRAY_SIZE_STEP 50
 #define ORIGINAL_BUFFER_SIZE_PER_FORMATION 128
-#define CURRENT_BUFFER_SIZE_PER_FORMATION 128
+#define WIDE_COORDINATES_BUFFER_SIZE_PER_FORMATION 148
+#define CURRENT_BUFFER_SIZE_PER_FORMATION 148
 
 static array(formation) formations;
 
@@ -56,6 +58,7 @@ void formations_clear(void)
 void formation_clear(int formation_id)
 {
     array_item(formations, formation_id)->in_use = 0;
+    array_release_item(formations, formation_id);
     array_trim(formations);
 }
 
@@ -167,6 +170,7 @@ void formation_set_selected(int formation_id)
 
 void formation_toggle_empire_service(int formation_id)
 {
+    game_replay_record_command(REPLAY_COMMAND_EMPIRE_SERVICE, formation_id, 0);
     array_item(formations, formation_id)->empire_service ^= 1;
 }
 
@@ -766,6 +770,16 @@ void formations_save_state(buffer *buf, buffer *totals)
         buffer_write_i32(buf, f->target_formation_id);
         buffer_skip(buf, 13);
         buffer_write_i16(buf, f->invasion_sequence);
+        buffer_write_u16(buf, f->x_home);
+        buffer_write_u16(buf, f->y_home);
+        buffer_write_u16(buf, f->standard_x);
+        buffer_write_u16(buf, f->standard_y);
+        buffer_write_u16(buf, f->x);
+        buffer_write_u16(buf, f->y);
+        buffer_write_u16(buf, f->destination_x);
+        buffer_write_u16(buf, f->destination_y);
+        buffer_write_u16(buf, f->prev.x_home);
+        buffer_write_u16(buf, f->prev.y_home);
     }
     buffer_write_i32(totals, data.id_last_in_use);
     buffer_write_i32(totals, data.id_last_legion);
@@ -859,6 +873,18 @@ void formations_load_state(buffer *buf, buffer *totals, int version)
         f->target_formation_id = buffer_read_i32(buf);
         buffer_skip(buf, 13);
         f->invasion_sequence = buffer_read_i16(buf);
+        if (formation_buf_size >= WIDE_COORDINATES_BUFFER_SIZE_PER_FORMATION) {
+            f->x_home = buffer_read_u16(buf);
+            f->y_home = buffer_read_u16(buf);
+            f->standard_x = buffer_read_u16(buf);
+            f->standard_y = buffer_read_u16(buf);
+            f->x = buffer_read_u16(buf);
+            f->y = buffer_read_u16(buf);
+            f->destination_x = buffer_read_u16(buf);
+            f->destination_y = buffer_read_u16(buf);
+            f->prev.x_home = buffer_read_u16(buf);
+            f->prev.y_home = buffer_read_u16(buf);
+        }
 
         if (formation_buf_size > CURRENT_BUFFER_SIZE_PER_FORMATION) {
             buffer_skip(buf, formation_buf_size - CURRENT_BUFFER_SIZE_PER_FORMATION);
@@ -8,6 +8,7 @@
 #include "figure/enemy_army.h"
 #include "figure/figure.h"
 #include "figure/route.h"
+#include "game/replay.h"
 #include "map/building.h"
 #include "map/figure.h"
 #include "map/grid.h"
@@ -88,6 +89,7 @@ void formation_legion_update_recruit_status(building *fort)
 
 void formation_legion_change_layout(formation *m, int new_layout)
 {
+    game_replay_record_command(REPLAY_COMMAND_LEGION_LAYOUT, m->id, new_layout);
     if (new_layout == FORMATION_MOP_UP && m->layout != FORMATION_MOP_UP) {
         m->prev.layout = m->layout;
     }
@@ -114,6 +116,7 @@ static int prepare_to_move(formation *m)
 
 void formation_legion_move_to(formation *m, const map_tile *tile)
 {
+    game_replay_record_command(REPLAY_COMMAND_LEGION_MOVE, m->id, tile->grid_offset);
     map_routing_calculate_distances(m->x_home, m->y_home);
     if (map_routing_distance(tile->grid_offset) <= 0) {
         return; // unable to route there
@@ -162,6 +165,7 @@ void formation_legion_move_to(formation *m, const map_tile *tile)
 
 void formation_legion_return_home(formation *m)
 {
+    game_replay_record_command(REPLAY_COMMAND_LEGION_RETURN_HOME, m->id, 0);
     map_routing_calculate_distances(m->x_home, m->y_home);
     if (map_routing_distance(map_grid_offset(m->x, m->y)) <= 0) {
         return; // unable to route home
@@ -211,6 +215,7 @@ static int dispatch_soldiers(formation *m)
 
 void formation_legions_dispatch_to_distant_battle(void)
 {
+    game_replay_record_command(REPLAY_COMMAND_DISTANT_BATTLE, 0, 0);
     int num_legions = 0;
     int roman_strength = 0;
     for (int i = 1; i < formation_count(); i++) {
@@ -3,23 +3,63 @@
 #include "building/industry.h"
 #include "building/properties.h"
 #include "core/config.h"
+#include "core/log.h"
 #include "figure/figure.h"
 #include "figure/movement.h"
 #include "figure/route.h"
 #include "map/building.h"
 #include "map/grid.h"
 #include "map/road_access.h"
+#include "map/routing_terrain.h"
 
+#include <stdlib.h>
 #include <string.h>
 
 #define TOTAL_ROAMERS 4
 #define MAX_STORED_BUILDING_TYPES 4
 #define SHOWN_BUILDING_OFFSET 12
+#define FOOTPRINT_STEPS_SIZE_STEP 128
+
+// roamers look for a road up to 6 tiles around a point 8 tiles away from the building
+#define FOOTPRINT_ROAMING_RADIUS 15
+
+typedef enum {
+    STEP_EXIT,
+    STEP_PASS,
+    STEP_ENTRY
+} footprint_step_type;
+
+typedef struct {
+    int grid_offset;
+    footprint_step_type type;
+} footprint_step;
+
+typedef struct {
+    int is_valid;
+    building_type type;
+    int x;
+    int y;
+    int has_road_access;
+    map_point road;
+    int disallow_diagonal;
+    unsigned int routing_version;
+    int depends_on_whole_map;
+    int x_min;
+    int y_min;
+    int x_max;
+    int y_max;
+    footprint_step *steps;
+    int num_steps;
+    int size;
+} roamer_footprint;
 
 static struct {
     grid_u8 travelled_tiles;
     building_type types[MAX_STORED_BUILDING_TYPES];
     int stored_building_types;
+    roamer_footprint *footprints;
+    int num_footprints;
+    roamer_footprint scratch;
 } data;
 
 static figure_type building_type_to_figure_type(building_type type)
@@ -178,34 +218,85 @@ static void init_roaming(figure *f, int roam_dir, int x, int y)
     }
 }
 
-void figure_roamer_preview_create(building_type b_type, int x, int y)
+static void add_step(roamer_footprint *footprint, int grid_offset, footprint_step_type type)
 {
-    if (!config_get(CONFIG_UI_SHOW_ROAMING_PATH)) {
-        figure_roamer_preview_reset_building_types();
-        return;
+    if (footprint->num_steps == footprint->size) {
+        footprint_step *steps = realloc(footprint->steps,
+            sizeof(footprint_step) * (footprint->size + FOOTPRINT_STEPS_SIZE_STEP));
+        if (!steps) {
+            log_error("Unable to store roamer preview path. The preview will be incomplete.", 0, 0);
+            footprint->is_valid = 0;
+            return;
+        }
+        footprint->steps = steps;
+        footprint->size += FOOTPRINT_STEPS_SIZE_STEP;
     }
+    footprint->steps[footprint->num_steps].grid_offset = grid_offset;
+    footprint->steps[footprint->num_steps].type = type;
+    footprint->num_steps++;
+}
 
-    figure_type fig_type = building_type_to_figure_type(b_type);
-    if (fig_type == FIGURE_NONE) {
-        return;
+static void extend_area(roamer_footprint *footprint, int x, int y, int radius)
+{
+    if (x - radius < footprint->x_min) {
+        footprint->x_min = x - radius;
+    }
+    if (y - radius < footprint->y_min) {
+        footprint->y_min = y - radius;
+    }
+    if (x + radius > footprint->x_max) {
+        footprint->x_max = x + radius;
+    }
+    if (y + radius > footprint->y_max) {
+        footprint->y_max = y + radius;
     }
+}
 
-    if (fig_type == FIGURE_LABOR_SEEKER && config_get(CONFIG_GP_CH_GLOBAL_LABOUR)) {
-        return;
+static void track_route(roamer_footprint *footprint, const figure *roamer, int x_from, int y_from)
+{
+    if (roamer->routing_path_id > 0) {
+        // a different path of the same length or shorter can only use tiles within that distance
+        extend_area(footprint, x_from, y_from, roamer->routing_path_length + 1);
+    } else if (roamer->x != roamer->destination_x || roamer->y != roamer->destination_y) {
+        // no route: any new road on the map could create one
+        footprint->depends_on_whole_map = 1;
     }
+}
 
-    int grid_offset = map_grid_offset(x, y);
+static int will_calculate_route(const figure *roamer, int is_roaming)
+{
+    return roamer->routing_path_id <= 0 && (!is_roaming || !roamer->roam_choose_destination);
+}
 
-    if (data.travelled_tiles.items[grid_offset] == SHOWN_BUILDING_OFFSET) {
-        return;
-    }
+static int building_size(building_type type)
+{
+    return building_is_farm(type) ? 3 : building_properties_for_type(type)->size;
+}
 
-    data.travelled_tiles.items[grid_offset] = SHOWN_BUILDING_OFFSET;
+static void simulate_roamers(roamer_footprint *footprint, building_type b_type, figure_type fig_type, int x, int y)
+{
+    int b_size = building_size(b_type);
 
-    int b_size = building_is_farm(b_type) ? 3 : building_properties_for_type(b_type)->size;
+    footprint->is_valid = 1;
+    footprint->type = b_type;
+    footprint->x = x;
+    footprint->y = y;
+    footprint->disallow_diagonal = config_get(CONFIG_GP_CH_ROAMERS_DONT_SKIP_CORNERS);
+    footprint->routing_version = map_routing_citizen_version();
+    footprint->depends_on_whole_map = 0;
+    footprint->num_steps = 0;
+    footprint->x_min = x;
+    footprint->y_min = y;
+    footprint->x_max = x + b_size - 1;
+    footprint->y_max = y + b_size - 1;
+    extend_area(footprint, x, y, FOOTPRINT_ROAMING_RADIUS);
+    extend_area(footprint, x + b_size - 1, y + b_size - 1, FOOTPRINT_ROAMING_RADIUS);
 
-    map_point road;
-    if (!map_has_road_access(x, y, b_size, &road)) {
+    // the road access tile depends on the size of all road networks, so it is checked separately
+    map_point road = { 0 };
+    footprint->has_road_access = map_has_road_access(x, y, b_size, &road);
+    footprint->road = road;
+    if (!footprint->has_road_access) {
         return;
     }
 
@@ -244,15 +335,20 @@ void figure_roamer_preview_create(building_type b_type, int x, int y)
         }
         roamer.grid_offset = map_grid_offset(roamer.x, roamer.y);
         if (map_grid_is_valid_offset(roamer.grid_offset)) {
-            data.travelled_tiles.items[roamer.grid_offset] = FIGURE_ROAMER_PREVIEW_EXIT_TILE;
+            add_step(footprint, roamer.grid_offset, STEP_EXIT);
         }
         init_roaming(&roamer, i * 2, x, y);
         while (++roamer.roam_length <= roamer.max_roam_length) {
-            if (data.travelled_tiles.items[roamer.grid_offset] < FIGURE_ROAMER_PREVIEW_MAX_PASSAGES) {
-                data.travelled_tiles.items[roamer.grid_offset]++;
-            }
+            add_step(footprint, roamer.grid_offset, STEP_PASS);
+            extend_area(footprint, roamer.x, roamer.y, 1);
             roamer.progress_on_tile = 15;
+            int x_from = roamer.x;
+            int y_from = roamer.y;
+            int calculates_route = will_calculate_route(&roamer, 1);
             figure_movement_roam_ticks(&roamer, 1);
+            if (calculates_route) {
+                track_route(footprint, &roamer, x_from, y_from);
+            }
         }
         figure_route_remove(&roamer);
         if (!should_return || !has_closest_road) {
@@ -262,21 +358,133 @@ void figure_roamer_preview_create(building_type b_type, int x, int y)
         roamer.destination_y = y_road;
         while (roamer.direction != DIR_FIGURE_AT_DESTINATION &&
             roamer.direction != DIR_FIGURE_REROUTE && roamer.direction != DIR_FIGURE_LOST) {
-            if (data.travelled_tiles.items[roamer.grid_offset] < FIGURE_ROAMER_PREVIEW_MAX_PASSAGES) {
-                data.travelled_tiles.items[roamer.grid_offset]++;
-            }
+            add_step(footprint, roamer.grid_offset, STEP_PASS);
+            extend_area(footprint, roamer.x, roamer.y, 1);
             roamer.progress_on_tile = 15;
+            int x_from = roamer.x;
+            int y_from = roamer.y;
+            int calculates_route = will_calculate_route(&roamer, 0);
             figure_movement_move_ticks(&roamer, 1);
+            if (calculates_route) {
+                track_route(footprint, &roamer, x_from, y_from);
+            }
         }
         figure_route_remove(&roamer);
         if (roamer.direction == DIR_FIGURE_AT_DESTINATION) {
-            int tile_type = data.travelled_tiles.items[roamer.grid_offset];
-            data.travelled_tiles.items[roamer.grid_offset] = tile_type < FIGURE_ROAMER_PREVIEW_EXIT_TILE ?
-                FIGURE_ROAMER_PREVIEW_ENTRY_TILE : FIGURE_ROAMER_PREVIEW_ENTRY_EXIT_TILE;
+            add_step(footprint, roamer.grid_offset, STEP_ENTRY);
+        } else {
+            footprint->depends_on_whole_map = 1;
+        }
+    }
+}
+
+static void apply_footprint(const roamer_footprint *footprint)
+{
+    for (int i = 0; i < footprint->num_steps; i++) {
+        const footprint_step *step = &footprint->steps[i];
+        uint8_t *tile = &data.travelled_tiles.items[step->grid_offset];
+        switch (step->type) {
+            case STEP_EXIT:
+                *tile = FIGURE_ROAMER_PREVIEW_EXIT_TILE;
+                break;
+            case STEP_PASS:
+                if (*tile < FIGURE_ROAMER_PREVIEW_MAX_PASSAGES) {
+                    (*tile)++;
+                }
+                break;
+            case STEP_ENTRY:
+                *tile = *tile < FIGURE_ROAMER_PREVIEW_EXIT_TILE ?
+                    FIGURE_ROAMER_PREVIEW_ENTRY_TILE : FIGURE_ROAMER_PREVIEW_ENTRY_EXIT_TILE;
+                break;
         }
     }
 }
 
+static int footprint_is_current(const roamer_footprint *footprint, const building *b)
+{
+    if (!footprint->is_valid || footprint->type != b->type || footprint->x != b->x || footprint->y != b->y ||
+        footprint->disallow_diagonal != config_get(CONFIG_GP_CH_ROAMERS_DONT_SKIP_CORNERS)) {
+        return 0;
+    }
+    map_point road = { 0 };
+    int has_road_access = map_has_road_access(b->x, b->y, building_size(b->type), &road);
+    if (has_road_access != footprint->has_road_access ||
+        (has_road_access && (road.x != footprint->road.x || road.y != footprint->road.y))) {
+        return 0;
+    }
+    if (footprint->depends_on_whole_map) {
+        return footprint->routing_version == map_routing_citizen_version();
+    }
+    return !map_routing_citizen_changed_since(footprint->x_min, footprint->y_min,
+        footprint->x_max, footprint->y_max, footprint->routing_version);
+}
+
+static roamer_footprint *get_footprint_for_building(const building *b, figure_type fig_type)
+{
+    if (b->id >= data.num_footprints) {
+        int num_footprints = b->id + 1 > 2 * data.num_footprints ? b->id + 1 : 2 * data.num_footprints;
+        roamer_footprint *footprints = realloc(data.footprints, sizeof(roamer_footprint) * num_footprints);
+        if (!footprints) {
+            log_error("Unable to cache roamer preview paths.", 0, 0);
+            return 0;
+        }
+        memset(&footprints[data.num_footprints], 0,
+            sizeof(roamer_footprint) * (num_footprints - data.num_footprints));
+        data.footprints = footprints;
+        data.num_footprints = num_footprints;
+    }
+    roamer_footprint *footprint = &data.footprints[b->id];
+    if (!footprint_is_current(footprint, b)) {
+        simulate_roamers(footprint, b->type, fig_type, b->x, b->y);
+    }
+    return footprint;
+}
+
+static figure_type get_roamer_type(building_type type)
+{
+    figure_type fig_type = building_type_to_figure_type(type);
+    if (fig_type == FIGURE_LABOR_SEEKER && config_get(CONFIG_GP_CH_GLOBAL_LABOUR)) {
+        return FIGURE_NONE;
+    }
+    return fig_type;
+}
+
+static int mark_building_shown(int x, int y)
+{
+    int grid_offset = map_grid_offset(x, y);
+    if (data.travelled_tiles.items[grid_offset] == SHOWN_BUILDING_OFFSET) {
+        return 0;
+    }
+    data.travelled_tiles.items[grid_offset] = SHOWN_BUILDING_OFFSET;
+    return 1;
+}
+
+void figure_roamer_preview_create(building_type b_type, int x, int y)
+{
+    if (!config_get(CONFIG_UI_SHOW_ROAMING_PATH)) {
+        figure_roamer_preview_reset_building_types();
+        return;
+    }
+    figure_type fig_type = get_roamer_type(b_type);
+    if (fig_type == FIGURE_NONE || !mark_building_shown(x, y)) {
+        return;
+    }
+    simulate_roamers(&data.scratch, b_type, fig_type, x, y);
+    apply_footprint(&data.scratch);
+}
+
+static void create_for_building(const building *b)
+{
+    figure_type fig_type = get_roamer_type(b->type);
+    if (fig_type == FIGURE_NONE || !mark_building_shown(b->x, b->y)) {
+        return;
+    }
+    const roamer_footprint *footprint = get_footprint_for_building(b, fig_type);
+    if (footprint) {
+        apply_footprint(footprint);
+    }
+}
+
 void figure_roamer_preview_create_all_for_building_type(building_type type)
 {
     if (type == BUILDING_NONE) {
@@ -295,7 +503,7 @@ void figure_roamer_preview_create_all_for_building_type(building_type type)
         return;
     }
     for (building *b = building_first_of_type(type); b; b = b->next_of_type) {
-        figure_roamer_preview_create(type, b->x, b->y);
+        create_for_building(b);
     }
     data.types[data.stored_building_types] = type;
     data.stored_building_types++;
@@ -305,10 +513,7 @@ void figure_roamer_preview_reset(building_type type)
 {
     map_grid_clear_u8(data.travelled_tiles.items);
     int show_other_roamers = 0;
-    figure_type fig_type = building_type_to_figure_type(type);
-    if (fig_type == FIGURE_LABOR_SEEKER && config_get(CONFIG_GP_CH_GLOBAL_LABOUR)) {
-        fig_type = FIGURE_NONE;
-    }
+    figure_type fig_type = get_roamer_type(type);
     if (fig_type == FIGURE_NONE) {
         show_other_roamers = 1;
     } else {
@@ -321,8 +526,12 @@ void figure_roamer_preview_reset(building_type type)
     }
     if (show_other_roamers) {
         for (int i = 0; i < data.stored_building_types; i++) {
+            if (!config_get(CONFIG_UI_SHOW_ROAMING_PATH)) {
+                data.stored_building_types = 0;
+                break;
+            }
             for (building *b = building_first_of_type(data.types[i]); b; b = b->next_of_type) {
-                figure_roamer_preview_create(b->type, b->x, b->y);
+                create_for_building(b);
             }
         }
     }
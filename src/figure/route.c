@@ -1,12 +1,14 @@
 #include "route.h"
 
 #include "core/array.h"
+#include "core/direction.h"
 #include "core/log.h"
+#include "map/grid.h"
 #include "map/routing.h"
 #include "map/routing_path.h"
 
 #define ARRAY_SIZE_STEP 600
-#define MAX_PATH_LENGTH 500
+#define MAX_PATH_LENGTH MAP_ROUTING_PATH_MAX_LENGTH
 
 typedef struct {
     int id;
@@ -28,8 +30,7 @@ static int path_is_used(const figure_path_data *path)
 
 void figure_route_clear_all(void)
 {
-    paths.size = 0;
-    array_trim(paths);
+    array_clear(paths);
 }
 
 void figure_route_clean(void)
@@ -42,6 +43,7 @@ void figure_route_clean(void)
             const figure *f = figure_get(figure_id);
             if (f->state != FIGURE_STATE_ALIVE || f->routing_path_id != i) {
                 path->figure_id = 0;
+                array_release_item(paths, i);
             }
         }
     }
@@ -84,10 +86,11 @@ void figure_route_add(figure *f)
             case TERRAIN_USAGE_ENEMY:
                 // check to see if we can reach our destination by going around the city walls
                 can_travel = map_routing_noncitizen_can_travel_over_land(f->x, f->y,
-                    f->destination_x, f->destination_y, direction_limit, f->destination_building_id, 5000);
+                    f->destination_x, f->destination_y, direction_limit, f->destination_building_id,
+                    MAP_GRID_SCALE_TILES(5000));
                 if (!can_travel) {
                     can_travel = map_routing_noncitizen_can_travel_over_land(f->x, f->y,
-                        f->destination_x, f->destination_y, direction_limit, 0, 25000);
+                        f->destination_x, f->destination_y, direction_limit, 0, MAP_GRID_SCALE_TILES(25000));
                     if (!can_travel) {
                         can_travel = map_routing_noncitizen_can_travel_through_everything(
                             f->x, f->y, f->destination_x, f->destination_y, direction_limit);
@@ -100,7 +103,7 @@ void figure_route_add(figure *f)
                 break;
             case TERRAIN_USAGE_ANIMAL:
                 can_travel = map_routing_noncitizen_can_travel_over_land(f->x, f->y,
-                    f->destination_x, f->destination_y, direction_limit, -1, 5000);
+                    f->destination_x, f->destination_y, direction_limit, -1, MAP_GRID_SCALE_TILES(5000));
                 break;
             case TERRAIN_USAGE_PREFER_ROADS:
                 can_travel = map_routing_citizen_can_travel_over_road_garden(f->x, f->y,
@@ -159,6 +162,7 @@ void figure_route_remove(figure *f)
     if (f->routing_path_id > 0) {
         if (f->routing_path_id < paths.size && array_item(paths, f->routing_path_id)->figure_id == f->id) {
             array_item(paths, f->routing_path_id)->figure_id = 0;
+            array_release_item(paths, f->routing_path_id);
         }
         f->routing_path_id = 0;
     }
@@ -167,12 +171,16 @@ void figure_route_remove(figure *f)
 
 int figure_route_get_direction(int path_id, int index)
 {
+    if (index >= MAX_PATH_LENGTH) {
+        // path loaded from a larger grid that is longer than the paths of this one
+        return DIR_FIGURE_REROUTE;
+    }
     return array_item(paths, path_id)->directions[index];
 }
 
 void figure_route_save_state(buffer *figures, buffer *buf_paths)
 {
-    int size = paths.size * sizeof(int);
+    int size = paths.size * sizeof(int16_t);
     uint8_t *buf_data = malloc(size);
     buffer_init(figures, buf_data, size);
 
@@ -190,7 +198,10 @@ void figure_route_save_state(buffer *figures, buffer *buf_paths)
 
 void figure_route_load_state(buffer *figures, buffer *buf_paths)
 {
-    int elements_to_load = buf_paths->size / MAX_PATH_LENGTH;
+    // Paths are as long as the grid they were saved with allows, which may differ from the current one
+    int elements_to_load = figures->size / sizeof(int16_t);
+    int saved_path_length = elements_to_load ? buf_paths->size / elements_to_load : MAX_PATH_LENGTH;
+    int path_length_to_read = saved_path_length < MAX_PATH_LENGTH ? saved_path_length : MAX_PATH_LENGTH;
 
     if (!array_init(paths, ARRAY_SIZE_STEP, create_new_path, path_is_used) ||
         !array_expand(paths, elements_to_load)) {
@@ -203,7 +214,8 @@ void figure_route_load_state(buffer *figures, buffer *buf_paths)
     for (int i = 0; i < elements_to_load; i++) {
         figure_path_data *path = array_next(paths);
         path->figure_id = buffer_read_i16(figures);
-        buffer_read_raw(buf_paths, path->directions, MAX_PATH_LENGTH);
+        buffer_read_raw(buf_paths, path->directions, path_length_to_read);
+        buffer_skip(buf_paths, saved_path_length - path_length_to_read);
         if (path->figure_id) {
             highest_id_in_use = i;
         }
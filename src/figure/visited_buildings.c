@@ -56,6 +56,7 @@ void figure_visited_buildings_remove_list(int index)
 {
     while (index) {
         visited_building *visited = array_item(visited_buildings, index);
+        array_release_item(visited_buildings, index);
         index = visited->prev_index;
         visited->prev_index = 0;
         visited->building_id = 0;
@@ -2,7 +2,7 @@
 #include "building/building.h"
 #include "building/list.h"
 #include "building/monument.h"
-#include "city/festival.h"
+#include "building/tourism.h"
 #include "city/figures.h"
 #include "city/map.h"
 #include "core/calc.h"
@@ -35,39 +35,11 @@ void figure_spawn_tourist(void)
 
 static int determine_tourist_destination(int x, int y)
 {
-    int road_network = map_road_network_get(map_grid_offset(x, y));
-
-    building_list_large_clear();
-
-    for (int i = 1; i < building_count(); i++) {
-        building *b = building_get(i);
-        if (b->state != BUILDING_STATE_IN_USE) {
-            continue;
-        }
-        if (city_festival_games_active()) {
-            if (b->type != city_festival_games_active_venue_type()) {
-                continue;
-            }
-        }
-        if (b->is_tourism_venue && !b->tourism_disabled && b->distance_from_entry
-            && b->road_network_id == road_network) {
-            if (b->type == BUILDING_HIPPODROME && b->prev_part_building_id) {
-                continue;
-            }
-            building_list_large_add(i);
-        }
-    }
-    int total_venues = building_list_large_size();
+    int total_venues = building_tourism_list_venues(map_road_network_get(map_grid_offset(x, y)));
     if (total_venues <= 0) {
         return 0;
     }
-
-    int index;
-
-    index = random_from_stdlib() % total_venues;
-    building *b = building_get(building_list_large_item(index));
-
-    return b->id;
+    return building_list_large_item(random_from_stdlib() % total_venues);
 }
 
 static int is_venue(building *b)
@@ -13,6 +13,7 @@
 #include "figure/movement.h"
 #include "figure/route.h"
 #include "map/building.h"
+#include "map/figure.h"
 #include "map/road_access.h"
 #include "sound/effect.h"
 
@@ -113,28 +114,35 @@ static int get_enemy_distance(figure *f, int x, int y)
     return INFINITE;
 }
 
-static int get_nearest_enemy(int x, int y, int *distance)
+static struct {
+    int x;
+    int y;
+} enemy_search;
+
+static int get_enemy_score(figure *f, int distance)
 {
-    int min_enemy_id = 0;
-    int min_dist = INFINITE;
-    for (int i = 1; i < figure_count(); i++) {
-        figure *f = figure_get(i);
-        if (figure_is_dead(f)) {
-            continue;
-        }
-        int dist = get_enemy_distance(f, x, y);
-        if (dist != INFINITE && f->targeted_by_figure_id) {
-            figure *pursuiter = figure_get(f->targeted_by_figure_id);
-            if (get_enemy_distance(f, pursuiter->x, pursuiter->y) < dist * 2) {
-                continue;
-            }
-        }
-        if (dist < min_dist) {
-            min_dist = dist;
-            min_enemy_id = i;
+    if (figure_is_dead(f)) {
+        return -1;
+    }
+    int dist = get_enemy_distance(f, enemy_search.x, enemy_search.y);
+    if (dist == INFINITE) {
+        return -1;
+    }
+    if (f->targeted_by_figure_id) {
+        figure *pursuiter = figure_get(f->targeted_by_figure_id);
+        if (get_enemy_distance(f, pursuiter->x, pursuiter->y) < dist * 2) {
+            return -1;
         }
     }
-    *distance = min_dist;
+    return dist;
+}
+
+static int get_nearest_enemy(int x, int y, int *distance)
+{
+    enemy_search.x = x;
+    enemy_search.y = y;
+    int min_enemy_id = map_figure_find_nearest(x, y, INFINITE, get_enemy_score);
+    *distance = min_enemy_id ? get_enemy_distance(figure_get(min_enemy_id), x, y) : INFINITE;
     return min_enemy_id;
 }
 
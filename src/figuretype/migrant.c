@@ -7,17 +7,17 @@
 #include "city/population.h"
 #include "core/calc.h"
 #include "core/image.h"
-#include "core/time.h"
 #include "figure/combat.h"
 #include "figure/image.h"
 #include "figure/movement.h"
 #include "figure/route.h"
+#include "game/tick.h"
 #include "game/undo.h"
 #include "map/road_access.h"
 
 static struct {
     int available;
-    time_millis last_check;
+    unsigned int last_check;
 } houses_with_room;
 
 void figure_create_immigrant(building *house, int num_people)
@@ -69,7 +69,7 @@ static void update_direction_and_image(figure *f)
 
 static int closest_house_with_room(int x, int y)
 {
-    if (houses_with_room.last_check == time_get_millis() && !houses_with_room.available) {
+    if (houses_with_room.last_check == game_tick_id() && !houses_with_room.available) {
         return 0;
     }
     int available_houses = 0;
@@ -91,7 +91,7 @@ static int closest_house_with_room(int x, int y)
         }
     }
     available_houses--;
-    houses_with_room.last_check = time_get_millis();
+    houses_with_room.last_check = game_tick_id();
     houses_with_room.available = available_houses;
     return min_building_id;
 }
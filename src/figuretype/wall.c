@@ -500,14 +500,15 @@ void figure_watchtower_archer_action(figure *f)
 }
 
 
-void figure_kill_tower_sentries_at(int x, int y)
+static int kill_tower_sentry(figure *f)
 {
-    for (int i = 0; i < figure_count(); i++) {
-        figure *f = figure_get(i);
-        if (!figure_is_dead(f) && f->type == FIGURE_TOWER_SENTRY) {
-            if (calc_maximum_distance(f->x, f->y, x, y) <= 1) {
-                f->state = FIGURE_STATE_DEAD;
-            }
-        }
+    if (!figure_is_dead(f) && f->type == FIGURE_TOWER_SENTRY) {
+        f->state = FIGURE_STATE_DEAD;
     }
+    return 0;
+}
+
+void figure_kill_tower_sentries_at(int x, int y)
+{
+    map_figure_foreach_in_area_until(x, y, 1, kill_tower_sentry);
 }
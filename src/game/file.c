@@ -33,8 +33,10 @@
 #include "game/animation.h"
 #include "game/difficulty.h"
 #include "game/file_io.h"
+#include "game/replay.h"
 #include "game/settings.h"
 #include "game/state.h"
+#include "game/state_hash.h"
 #include "game/time.h"
 #include "game/tutorial.h"
 #include "game/undo.h"
@@ -358,6 +360,8 @@ static int start_scenario(const uint8_t *scenario_name, const char *scenario_fil
 
     building_menu_update();
     city_message_init_scenario();
+    game_replay_handle_game_start();
+    game_state_hash_handle_game_start();
     return 1;
 }
 
@@ -400,12 +404,14 @@ int game_file_load_saved_game(const char *filename)
     building_storage_reset_building_ids();
 
     sound_music_update(1);
+    game_replay_handle_game_start();
+    game_state_hash_handle_game_start();
     return 1;
 }
 
-int game_file_write_saved_game(const char *filename)
+int game_file_write_saved_game(const char *filename, saved_game_compression compression)
 {
-    return game_file_io_write_saved_game(filename);
+    return game_file_io_write_saved_game(filename, compression);
 }
 
 int game_file_delete_saved_game(const char *filename)
@@ -430,6 +436,6 @@ void game_file_write_mission_saved_game(void)
         filename = localized_filename;
     }
     if (city_mission_should_save_start() && !file_exists(filename, NOT_LOCALIZED)) {
-        game_file_io_write_saved_game(filename);
+        game_file_io_write_saved_game(filename, SAVED_GAME_COMPRESSION_FAST);
     }
 }
@@ -1,6 +1,8 @@
 #ifndef GAME_FILE_H
 #define GAME_FILE_H
 
+#include "game/file_io.h"
+
 #include <stdint.h>
 
 /**
@@ -27,9 +29,10 @@ int game_file_load_saved_game(const char *filename);
 /**
  * Write saved game to disk
  * @param filename File to save to
+ * @param compression Compression to use
  * @return Boolean true on success, false on failure
  */
-int game_file_write_saved_game(const char *filename);
+int game_file_write_saved_game(const char *filename, saved_game_compression compression);
 
 /**
  * Delete saved game
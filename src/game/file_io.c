@@ -12,10 +12,14 @@
 #include "city/view.h"
 #include "core/dir.h"
 #include "core/file.h"
+#include "core/hash.h"
+#include "core/job.h"
 #include "core/log.h"
 #include "core/memory_block.h"
 #include "core/random.h"
+#include "core/rle.h"
 #include "core/string.h"
+#include "core/trace.h"
 #include "core/zip.h"
 #include "core/zlib_helper.h"
 #include "empire/city.h"
@@ -38,6 +42,7 @@
 #include "map/desirability.h"
 #include "map/elevation.h"
 #include "map/figure.h"
+#include "map/grid.h"
 #include "map/image.h"
 #include "map/property.h"
 #include "map/random.h"
@@ -65,6 +70,15 @@
 #define COMPRESS_BUFFER_INITIAL_SIZE 1000000
 #define UNCOMPRESSED 0x80000000
 #define PIECE_SIZE_DYNAMIC 0
+#define MAX_SAVEGAME_PIECES 100
+
+// Pieces that are stored before the piece table: campaign mission, file, resource and scenario version
+#define SAVEGAME_HEADER_PIECES 4
+#define PIECE_TABLE_ENTRY_SIZE 24
+#define PIECE_TABLE_MAX_SIZE (4 + MAX_SAVEGAME_PIECES * PIECE_TABLE_ENTRY_SIZE + 8)
+
+// The best compression level takes several times as long for a saved game that is only a few percent smaller
+#define SMALL_COMPRESSION_LEVEL Z_DEFAULT_COMPRESSION
 
 
 
@@ -72,8 +86,30 @@ typedef struct {
     buffer buf;
     int compressed;
     int dynamic;
+    int element_size; // of grid pieces, 0 for other pieces
 } file_piece;
 
+typedef enum {
+    PIECE_STORED_RAW = 0,
+    PIECE_STORED_ZLIB = 1,
+    PIECE_STORED_RLE = 2
+} piece_storage;
+
+typedef struct {
+    uint32_t offset; // from the start of the saved game
+    uint32_t stored_size;
+    uint32_t size;
+    piece_storage storage;
+    uint64_t checksum; // of the stored bytes
+} piece_table_entry;
+
+typedef struct {
+    piece_table_entry entries[MAX_SAVEGAME_PIECES];
+    // Compressed data when writing, position in the data that was read when reading
+    uint8_t *stored[MAX_SAVEGAME_PIECES];
+    int failed[MAX_SAVEGAME_PIECES];
+} piece_table;
+
 typedef struct {
     buffer *resource_version;
     buffer *graphic_ids;
@@ -190,8 +226,6 @@ typedef struct {
 typedef struct {
     struct {
         int burning_totals;
-        int image_grid;
-        int terrain_grid;
         int figures;
         int route_figures;
         int route_paths;
@@ -212,6 +246,10 @@ typedef struct {
         int trade_route_traded;
         int figure_traders;
     } piece_sizes;
+    struct {
+        int image;
+        int terrain;
+    } grid_element_sizes;
     struct {
         int culture1;
         int culture2;
@@ -230,13 +268,15 @@ typedef struct {
         int resource_version;
         int static_building_counts;
         int visited_buildings;
+        int dynamic_grids;
     } features;
 } savegame_version_data;
 
 static struct {
     int num_pieces;
-    file_piece pieces[100];
+    file_piece pieces[MAX_SAVEGAME_PIECES];
     savegame_state state;
+    piece_table table;
 } savegame_data;
 
 static struct {
@@ -252,6 +292,7 @@ static void init_file_piece(file_piece *piece, int size, int compressed)
 {
     piece->compressed = compressed;
     piece->dynamic = size == PIECE_SIZE_DYNAMIC;
+    piece->element_size = 0;
     if (piece->dynamic) {
         buffer_init(&piece->buf, 0, 0);
     } else {
@@ -261,6 +302,18 @@ static void init_file_piece(file_piece *piece, int size, int compressed)
     }
 }
 
+static void init_grid_piece(file_piece *piece, int element_size, int compressed, int dynamic_grid)
+{
+    if (dynamic_grid) {
+        // Written with the current grid size, the actual size is read from the file when loading
+        init_file_piece(piece, GRID_SIZE * GRID_SIZE * element_size, compressed);
+        piece->dynamic = 1;
+    } else {
+        init_file_piece(piece, LEGACY_GRID_SIZE * LEGACY_GRID_SIZE * element_size, compressed);
+    }
+    piece->element_size = element_size;
+}
+
 static buffer *create_scenario_piece(int size, int compressed)
 {
     file_piece *piece = &scenario_data.pieces[scenario_data.num_pieces++];
@@ -268,6 +321,13 @@ static buffer *create_scenario_piece(int size, int compressed)
     return &piece->buf;
 }
 
+static buffer *create_scenario_grid_piece(int element_size, int dynamic_grid)
+{
+    file_piece *piece = &scenario_data.pieces[scenario_data.num_pieces++];
+    init_grid_piece(piece, element_size, 0, dynamic_grid);
+    return &piece->buf;
+}
+
 static buffer *create_savegame_piece(int size, int compressed)
 {
     file_piece *piece = &savegame_data.pieces[savegame_data.num_pieces++];
@@ -275,6 +335,13 @@ static buffer *create_savegame_piece(int size, int compressed)
     return &piece->buf;
 }
 
+static buffer *create_savegame_grid_piece(int element_size, int compressed, int dynamic_grid)
+{
+    file_piece *piece = &savegame_data.pieces[savegame_data.num_pieces++];
+    init_grid_piece(piece, element_size, compressed, dynamic_grid);
+    return &piece->buf;
+}
+
 static void clear_savegame_pieces(void)
 {
     for (int i = 0; i < savegame_data.num_pieces; i++) {
@@ -282,6 +349,8 @@ static void clear_savegame_pieces(void)
         free(savegame_data.pieces[i].buf.data);
     }
     savegame_data.num_pieces = 0;
+    // Pieces that are not used by the next savegame version must not point to freed buffers
+    memset(&savegame_data.state, 0, sizeof(savegame_state));
 }
 
 static void clear_scenario_pieces(void)
@@ -302,12 +371,13 @@ static void init_scenario_data(scenario_version version)
     if (version > SCENARIO_LAST_NO_STATIC_RESOURCES) {
         state->resource_version = create_scenario_piece(4, 0);
     }
-    state->graphic_ids = create_scenario_piece(52488, 0);
-    state->edge = create_scenario_piece(26244, 0);
-    state->terrain = create_scenario_piece(52488, 0);
-    state->bitfields = create_scenario_piece(26244, 0);
-    state->random = create_scenario_piece(26244, 0);
-    state->elevation = create_scenario_piece(26244, 0);
+    int dynamic_grids = version > SCENARIO_LAST_FIXED_GRID_SIZE;
+    state->graphic_ids = create_scenario_grid_piece(2, dynamic_grids);
+    state->edge = create_scenario_grid_piece(1, dynamic_grids);
+    state->terrain = create_scenario_grid_piece(2, dynamic_grids);
+    state->bitfields = create_scenario_grid_piece(1, dynamic_grids);
+    state->random = create_scenario_grid_piece(1, dynamic_grids);
+    state->elevation = create_scenario_grid_piece(1, dynamic_grids);
     state->random_iv = create_scenario_piece(8, 0);
     state->camera = create_scenario_piece(8, 0);
     if (version <= SCENARIO_LAST_UNVERSIONED) {
@@ -344,8 +414,8 @@ static void get_version_data(savegame_version_data *version_data, savegame_versi
         count_multiplier = PIECE_SIZE_DYNAMIC;
     }
 
-    version_data->piece_sizes.image_grid = 52488 * (version > SAVE_GAME_LAST_SMALLER_IMAGE_ID_VERSION ? 2 : 1);
-    version_data->piece_sizes.terrain_grid = 52488 * (version > SAVE_GAME_LAST_ORIGINAL_TERRAIN_DATA_SIZE_VERSION ? 2 : 1);
+    version_data->grid_element_sizes.image = version > SAVE_GAME_LAST_SMALLER_IMAGE_ID_VERSION ? 4 : 2;
+    version_data->grid_element_sizes.terrain = version > SAVE_GAME_LAST_ORIGINAL_TERRAIN_DATA_SIZE_VERSION ? 4 : 2;
     version_data->piece_sizes.figures = 128000 * multiplier;
     version_data->piece_sizes.route_figures = 1200 * multiplier;
     version_data->piece_sizes.route_paths = 300000 * multiplier;
@@ -399,6 +469,7 @@ static void get_version_data(savegame_version_data *version_data, savegame_versi
     version_data->features.resource_version = version > SAVE_GAME_LAST_STATIC_RESOURCES;
     version_data->features.static_building_counts = version <= SAVE_GAME_LAST_GLOBAL_BUILDING_INFO;
     version_data->features.visited_buildings = version > SAVE_GAME_LAST_GLOBAL_BUILDING_INFO;
+    version_data->features.dynamic_grids = version > SAVE_GAME_LAST_FIXED_GRID_SIZE;
 }
 
 static void init_savegame_data(savegame_version version)
@@ -417,22 +488,23 @@ static void init_savegame_data(savegame_version version)
     if (version_data.features.scenario_version) {
         state->scenario_version = create_savegame_piece(4, 0);
     }
+    int dynamic_grids = version_data.features.dynamic_grids;
     if (version_data.features.image_grid) {
-        state->image_grid = create_savegame_piece(version_data.piece_sizes.image_grid, 1);
-    }
-    state->edge_grid = create_savegame_piece(26244, 1);
-    state->building_grid = create_savegame_piece(52488, 1);
-    state->terrain_grid = create_savegame_piece(version_data.piece_sizes.terrain_grid, 1);
-    state->aqueduct_grid = create_savegame_piece(26244, 1);
-    state->figure_grid = create_savegame_piece(52488, 1);
-    state->bitfields_grid = create_savegame_piece(26244, 1);
-    state->sprite_grid = create_savegame_piece(26244, 1);
-    state->random_grid = create_savegame_piece(26244, 0);
-    state->desirability_grid = create_savegame_piece(26244, 1);
-    state->elevation_grid = create_savegame_piece(26244, 1);
-    state->building_damage_grid = create_savegame_piece(26244, 1);
-    state->aqueduct_backup_grid = create_savegame_piece(26244, 1);
-    state->sprite_backup_grid = create_savegame_piece(26244, 1);
+        state->image_grid = create_savegame_grid_piece(version_data.grid_element_sizes.image, 1, dynamic_grids);
+    }
+    state->edge_grid = create_savegame_grid_piece(1, 1, dynamic_grids);
+    state->building_grid = create_savegame_grid_piece(2, 1, dynamic_grids);
+    state->terrain_grid = create_savegame_grid_piece(version_data.grid_element_sizes.terrain, 1, dynamic_grids);
+    state->aqueduct_grid = create_savegame_grid_piece(1, 1, dynamic_grids);
+    state->figure_grid = create_savegame_grid_piece(2, 1, dynamic_grids);
+    state->bitfields_grid = create_savegame_grid_piece(1, 1, dynamic_grids);
+    state->sprite_grid = create_savegame_grid_piece(1, 1, dynamic_grids);
+    state->random_grid = create_savegame_grid_piece(1, 0, dynamic_grids);
+    state->desirability_grid = create_savegame_grid_piece(1, 1, dynamic_grids);
+    state->elevation_grid = create_savegame_grid_piece(1, 1, dynamic_grids);
+    state->building_damage_grid = create_savegame_grid_piece(1, 1, dynamic_grids);
+    state->aqueduct_backup_grid = create_savegame_grid_piece(1, 1, dynamic_grids);
+    state->sprite_backup_grid = create_savegame_grid_piece(1, 1, dynamic_grids);
     state->figures = create_savegame_piece(version_data.piece_sizes.figures, 1);
     state->route_figures = create_savegame_piece(version_data.piece_sizes.route_figures, 1);
     state->route_paths = create_savegame_piece(version_data.piece_sizes.route_paths, 1);
@@ -527,6 +599,39 @@ static void init_savegame_data(savegame_version version)
     }
 }
 
+static void convert_saved_grids(buffer **grids, int num_grids)
+{
+    for (int i = 0; i < num_grids; i++) {
+        if (grids[i] && !map_grid_convert_saved_buffer(grids[i])) {
+            log_error("Unable to convert map grid to the current grid size", 0, i);
+        }
+    }
+}
+
+static void set_saved_layout_from_scenario(buffer *scenario, int *grid_start, int *grid_border_size)
+{
+    int width, height;
+    scenario_map_data_from_buffer(scenario, &width, &height, grid_start, grid_border_size);
+    buffer_set(scenario, 0);
+    map_grid_set_saved_layout(width + *grid_border_size, *grid_start, width, height);
+    if (map_grid_saved_layout_differs()) {
+        *grid_start = map_grid_centered_start_offset(width, height);
+        *grid_border_size = GRID_SIZE - width;
+    }
+}
+
+static int map_fits_in_grid(buffer *scenario)
+{
+    int width, height, grid_start, grid_border_size;
+    scenario_map_data_from_buffer(scenario, &width, &height, &grid_start, &grid_border_size);
+    buffer_set(scenario, 0);
+    if (width <= 0 || height <= 0 || width > GRID_SIZE - 2 || height > GRID_SIZE - 2) {
+        log_error("Map does not fit in the map grid of this build, map width:", 0, width);
+        return 0;
+    }
+    return 1;
+}
+
 static void scenario_load_from_state(scenario_state *file, scenario_version version)
 {
     resource_version resource_version = RESOURCE_ORIGINAL_VERSION;
@@ -535,6 +640,14 @@ static void scenario_load_from_state(scenario_state *file, scenario_version vers
     }
     resource_set_mapping(resource_version);
 
+    int grid_start, grid_border_size;
+    set_saved_layout_from_scenario(file->scenario, &grid_start, &grid_border_size);
+    int convert_grids = map_grid_saved_layout_differs();
+    if (convert_grids) {
+        buffer *grids[] = { file->graphic_ids, file->edge, file->terrain, file->bitfields, file->random, file->elevation };
+        convert_saved_grids(grids, sizeof(grids) / sizeof(buffer *));
+    }
+
     map_image_load_state_legacy(file->graphic_ids);
     map_terrain_load_state(file->terrain, 0, file->graphic_ids, 1);
     map_property_load_state(file->bitfields, file->edge);
@@ -543,6 +656,10 @@ static void scenario_load_from_state(scenario_state *file, scenario_version vers
     city_view_load_scenario_state(file->camera);
     random_load_state(file->random_iv);
     scenario_load_state(file->scenario, version);
+    if (convert_grids) {
+        scenario_map_init();
+        map_terrain_init_outside_map();
+    }
     if (version > SCENARIO_LAST_UNVERSIONED) {
         empire_object_load(file->empire, version);
     }
@@ -589,11 +706,24 @@ static void savegame_load_from_state(savegame_state *state, savegame_version ver
 
     scenario_load_state(state->scenario, scenario_version);
     scenario_map_init();
+    int convert_grids = map_grid_saved_layout_differs();
+    if (convert_grids) {
+        buffer *grids[] = {
+            version <= SAVE_GAME_LAST_STORED_IMAGE_IDS ? state->image_grid : 0, state->edge_grid, state->building_grid, state->terrain_grid, state->aqueduct_grid,
+            state->figure_grid, state->bitfields_grid, state->sprite_grid, state->random_grid,
+            state->desirability_grid, state->elevation_grid, state->building_damage_grid,
+            state->aqueduct_backup_grid, state->sprite_backup_grid
+        };
+        convert_saved_grids(grids, sizeof(grids) / sizeof(buffer *));
+    }
 
     map_building_load_state(state->building_grid, state->building_damage_grid);
     map_terrain_load_state(state->terrain_grid, version > SAVE_GAME_LAST_ORIGINAL_TERRAIN_DATA_SIZE_VERSION,
         version <= SAVE_GAME_LAST_STORED_IMAGE_IDS ? state->image_grid : 0,
         version <= SAVE_GAME_LAST_SMALLER_IMAGE_ID_VERSION);
+    if (convert_grids) {
+        map_terrain_init_outside_map();
+    }
     map_aqueduct_load_state(state->aqueduct_grid, state->aqueduct_backup_grid);
     map_figure_load_state(state->figure_grid);
     map_sprite_load_state(state->sprite_grid, state->sprite_backup_grid);
@@ -627,7 +757,7 @@ static void savegame_load_from_state(savegame_state *state, savegame_version ver
     scenario_earthquake_load_state(state->earthquake);
     city_message_load_state(state->messages, state->message_extra,
         state->message_counts, state->message_delays,
-        state->population_messages);
+        state->population_messages, version > SAVE_GAME_LAST_FIXED_GRID_SIZE);
     sound_city_load_state(state->city_sounds);
     traders_load_state(state->figure_traders);
 
@@ -667,7 +797,7 @@ static void savegame_load_from_state(savegame_state *state, savegame_version ver
     map_image_update_all();
 }
 
-static void savegame_save_to_state(savegame_state *state)
+static void savegame_save_to_state(savegame_state *state, int skip_buildings_and_figures)
 {
     buffer_write_i32(state->file_version, SAVE_GAME_CURRENT_VERSION);
     buffer_write_u32(state->resource_version, RESOURCE_CURRENT_VERSION);
@@ -689,7 +819,8 @@ static void savegame_save_to_state(savegame_state *state)
     map_desirability_save_state(state->desirability_grid);
     map_elevation_save_state(state->elevation_grid);
 
-    figure_save_state(state->figures, state->figure_sequence);
+    // When hashing, buildings and figures are hashed separately so that unchanged ones are not saved again
+    figure_save_state(skip_buildings_and_figures ? 0 : state->figures, state->figure_sequence);
     figure_route_save_state(state->route_figures, state->route_paths);
     formations_save_state(state->formations, state->formation_totals);
 
@@ -698,7 +829,7 @@ static void savegame_save_to_state(savegame_state *state)
         state->city_entry_exit_xy,
         state->city_entry_exit_grid_offset);
 
-    building_save_state(state->buildings,
+    building_save_state(skip_buildings_and_figures ? 0 : state->buildings,
         state->building_extra_highest_id,
         state->building_extra_highest_id_ever,
         state->building_extra_sequence,
@@ -823,7 +954,8 @@ static int write_compressed_chunk(FILE *fp, void *buffer, int bytes_to_write, me
         return 0;
     }
     int output_size = 0;
-    if (zlib_helper_compress(buffer, bytes_to_write, compress_buffer->memory, COMPRESS_BUFFER_INITIAL_SIZE, &output_size)) {
+    if (zlib_helper_compress(buffer, bytes_to_write, compress_buffer->memory, (int) compress_buffer->size,
+            &output_size, Z_BEST_SPEED)) {
         write_int32(fp, output_size);
         fwrite(compress_buffer->memory, 1, output_size, fp);
     } else {
@@ -841,6 +973,7 @@ static int prepare_dynamic_piece(FILE *fp, file_piece *piece)
         if (!size) {
             return 0;
         }
+        free(piece->buf.data);
         uint8_t *data = malloc(size);
         memset(data, 0, size);
         buffer_init(&piece->buf, data, size);
@@ -890,7 +1023,7 @@ int game_file_io_read_scenario(const char *filename)
 {
     log_info("Loading scenario", filename, 0);
     scenario_version version = SCENARIO_VERSION_NONE;
-    if (!load_scenario_to_buffers(filename, &version)) {
+    if (!load_scenario_to_buffers(filename, &version) || !map_fits_in_grid(scenario_data.state.scenario)) {
         return 0;
     }
     scenario_load_from_state(&scenario_data.state, scenario_data.version);
@@ -960,11 +1093,20 @@ int game_file_io_read_scenario_info(const char *filename, scenario_info *info)
     if (!info->is_open_play) {
         scenario_objectives_from_buffer(state->scenario, version, &info->win_criteria);
     }
+    if (!map_fits_in_grid(state->scenario)) {
+        clear_scenario_pieces();
+        return SAVEGAME_STATUS_INVALID;
+    }
     int grid_start;
     int grid_border_size;
 
     scenario_map_data_from_buffer(state->scenario, &minimap_data.city_width, &minimap_data.city_height,
         &grid_start, &grid_border_size);
+    set_saved_layout_from_scenario(state->scenario, &grid_start, &grid_border_size);
+    if (map_grid_saved_layout_differs()) {
+        buffer *grids[] = { state->edge, state->terrain, state->bitfields, state->random };
+        convert_saved_grids(grids, sizeof(grids) / sizeof(buffer *));
+    }
     info->map_size = minimap_data.city_width;
     minimap_data.version = 0;
     minimap_data.climate = info->climate;
@@ -1026,7 +1168,7 @@ int game_file_io_write_scenario(const char *filename)
     return 1;
 }
 
-static int savegame_read_from_file(FILE *fp, savegame_version version)
+static int savegame_read_sequential_pieces(FILE *fp, savegame_version version)
 {
     memory_block compress_buffer;
     core_memory_block_init(&compress_buffer, COMPRESS_BUFFER_INITIAL_SIZE);
@@ -1052,22 +1194,330 @@ static int savegame_read_from_file(FILE *fp, savegame_version version)
     return 1;
 }
 
-static void savegame_write_to_file(FILE *fp, memory_block *compress_buffer)
+static int is_one_of(const buffer *buf, buffer *const *pieces, int num_pieces)
 {
-    for (int i = 0; i < savegame_data.num_pieces; i++) {
+    for (int i = 0; i < num_pieces; i++) {
+        if (buf == pieces[i]) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static int get_piece_table_size(int num_pieces)
+{
+    return 4 + num_pieces * PIECE_TABLE_ENTRY_SIZE + 8;
+}
+
+static void write_u64(buffer *buf, uint64_t value)
+{
+    buffer_write_u32(buf, (uint32_t) value);
+    buffer_write_u32(buf, (uint32_t) (value >> 32));
+}
+
+static uint64_t read_u64(buffer *buf)
+{
+    uint64_t low = buffer_read_u32(buf);
+    uint64_t high = buffer_read_u32(buf);
+    return low | (high << 32);
+}
+
+static void write_piece_table(buffer *buf, const piece_table *table, int num_pieces)
+{
+    buffer_write_i32(buf, num_pieces);
+    for (int i = 0; i < num_pieces; i++) {
+        const piece_table_entry *entry = &table->entries[i];
+        buffer_write_u32(buf, entry->offset);
+        buffer_write_u32(buf, entry->stored_size);
+        buffer_write_u32(buf, entry->size);
+        buffer_write_u32(buf, entry->storage);
+        write_u64(buf, entry->checksum);
+    }
+    write_u64(buf, hash_bytes(buf->data, buf->index, 0));
+}
+
+static int read_piece_table(FILE *fp, long start, piece_table *table, int num_pieces)
+{
+    uint8_t data[PIECE_TABLE_MAX_SIZE];
+    int size = get_piece_table_size(num_pieces);
+    if (fseek(fp, start + SAVEGAME_HEADER_PIECES * 4, SEEK_SET) || fread(data, 1, size, fp) != size) {
+        log_error("Unable to read the piece table of the saved game", 0, 0);
+        return 0;
+    }
+    buffer buf;
+    buffer_init(&buf, data, size);
+    int count = buffer_read_i32(&buf);
+    if (count != num_pieces) {
+        log_error("Unexpected number of pieces in saved game:", 0, count);
+        return 0;
+    }
+    for (int i = 0; i < num_pieces; i++) {
+        piece_table_entry *entry = &table->entries[i];
+        entry->offset = buffer_read_u32(&buf);
+        entry->stored_size = buffer_read_u32(&buf);
+        entry->size = buffer_read_u32(&buf);
+        entry->storage = buffer_read_u32(&buf);
+        entry->checksum = read_u64(&buf);
+    }
+    uint64_t checksum = hash_bytes(data, buf.index, 0);
+    if (read_u64(&buf) != checksum) {
+        log_error("The piece table of the saved game is corrupt", 0, 0);
+        return 0;
+    }
+    if (fseek(fp, 0, SEEK_END)) {
+        return 0;
+    }
+    int64_t available = ftell(fp) - start;
+    for (int i = 0; i < num_pieces; i++) {
+        const piece_table_entry *entry = &table->entries[i];
+        if ((int64_t) entry->offset + entry->stored_size > available || entry->size > INT32_MAX ||
+            (entry->storage == PIECE_STORED_RAW && entry->stored_size != entry->size) ||
+            (entry->storage != PIECE_STORED_RAW && entry->storage != PIECE_STORED_ZLIB &&
+            entry->storage != PIECE_STORED_RLE)) {
+            log_error("Invalid entry in the piece table of the saved game:", 0, i);
+            return 0;
+        }
+    }
+    return 1;
+}
+
+static int prepare_table_piece(file_piece *piece, const piece_table_entry *entry)
+{
+    if (!piece->dynamic) {
+        return piece->buf.size == (int) entry->size;
+    }
+    free(piece->buf.data);
+    buffer_init(&piece->buf, 0, 0);
+    if (entry->size) {
+        uint8_t *data = malloc(entry->size);
+        if (!data) {
+            return 0;
+        }
+        buffer_init(&piece->buf, data, entry->size);
+    }
+    return 1;
+}
+
+static uint8_t *read_stored_pieces(FILE *fp, long start, piece_table *table, int num_pieces, int *needed)
+{
+    size_t total = 0;
+    uint32_t end = 0;
+    int all_needed = 1;
+    for (int i = 0; i < num_pieces; i++) {
+        const piece_table_entry *entry = &table->entries[i];
+        if (needed[i]) {
+            total += entry->stored_size;
+        } else {
+            all_needed = 0;
+        }
+        if (entry->offset + entry->stored_size > end) {
+            end = entry->offset + entry->stored_size;
+        }
+    }
+    if (all_needed) {
+        // The pieces and the table cover the whole saved game, so read it at once
+        total = end;
+    }
+    uint8_t *data = malloc(total + 1);
+    if (!data) {
+        return 0;
+    }
+    if (all_needed) {
+        if (fseek(fp, start, SEEK_SET) || fread(data, 1, total, fp) != total) {
+            free(data);
+            return 0;
+        }
+        for (int i = 0; i < num_pieces; i++) {
+            table->stored[i] = &data[table->entries[i].offset];
+        }
+        return data;
+    }
+    size_t position = 0;
+    for (int i = 0; i < num_pieces; i++) {
+        const piece_table_entry *entry = &table->entries[i];
+        table->stored[i] = 0;
+        if (!needed[i]) {
+            continue;
+        }
+        if (fseek(fp, start + entry->offset, SEEK_SET) ||
+            fread(&data[position], 1, entry->stored_size, fp) != entry->stored_size) {
+            free(data);
+            return 0;
+        }
+        table->stored[i] = &data[position];
+        position += entry->stored_size;
+    }
+    return data;
+}
+
+static int decode_piece(file_piece *piece, const piece_table_entry *entry, uint8_t *stored)
+{
+    if (hash_bytes(stored, entry->stored_size, 0) != entry->checksum) {
+        return 0;
+    }
+    int output_size = 0;
+    switch (entry->storage) {
+        case PIECE_STORED_ZLIB:
+            return zlib_helper_decompress(stored, entry->stored_size, piece->buf.data, entry->size, &output_size);
+        case PIECE_STORED_RLE:
+            return rle_decompress(stored, entry->stored_size, piece->buf.data, entry->size);
+        default:
+            if (entry->size) {
+                memcpy(piece->buf.data, stored, entry->size);
+            }
+            return 1;
+    }
+}
+
+static void decode_pieces(int chunk, int start, int end, void *data)
+{
+    TRACE_BEGIN("decode saved game pieces");
+    piece_table *table = data;
+    for (int i = start; i < end; i++) {
+        table->failed[i] = table->stored[i] &&
+            !decode_piece(&savegame_data.pieces[i], &table->entries[i], table->stored[i]);
+    }
+    TRACE_END();
+}
+
+// Pieces are checked against their checksums and decompressed in parallel.
+// When only some pieces are needed, the others are not read at all.
+static int savegame_read_table_pieces(FILE *fp, buffer *const *only, int num_only)
+{
+    long start = ftell(fp);
+    piece_table *table = &savegame_data.table;
+    int num_pieces = savegame_data.num_pieces;
+    if (!read_piece_table(fp, start, table, num_pieces)) {
+        return 0;
+    }
+    int needed[MAX_SAVEGAME_PIECES];
+    for (int i = 0; i < num_pieces; i++) {
         file_piece *piece = &savegame_data.pieces[i];
-        if (piece->dynamic) {
-            write_int32(fp, piece->buf.size);
-            if (!piece->buf.size) {
-                continue;
+        needed[i] = !only || is_one_of(&piece->buf, only, num_only);
+        if (needed[i] && !prepare_table_piece(piece, &table->entries[i])) {
+            log_error("Unexpected size of saved game piece:", 0, i);
+            return 0;
+        }
+    }
+    uint8_t *data = read_stored_pieces(fp, start, table, num_pieces, needed);
+    if (!data) {
+        log_error("Unable to read the pieces of the saved game", 0, 0);
+        return 0;
+    }
+    job_parallel_for(num_pieces, 1, decode_pieces, table);
+    free(data);
+    for (int i = 0; i < num_pieces; i++) {
+        if (table->failed[i]) {
+            log_error("Saved game piece is corrupt:", 0, i);
+            return 0;
+        }
+    }
+    return 1;
+}
+
+static int savegame_read_from_file(FILE *fp, savegame_version version)
+{
+    if (version > SAVE_GAME_LAST_SEQUENTIAL_PIECES) {
+        return savegame_read_table_pieces(fp, 0, 0);
+    }
+    return savegame_read_sequential_pieces(fp, version);
+}
+
+static piece_storage get_piece_storage(const file_piece *piece, saved_game_compression compression)
+{
+    if (!piece->compressed || !piece->buf.size) {
+        return PIECE_STORED_RAW;
+    }
+    if (compression == SAVED_GAME_COMPRESSION_FAST && piece->element_size) {
+        return PIECE_STORED_RLE;
+    }
+    return PIECE_STORED_ZLIB;
+}
+
+static int compress_piece(const file_piece *piece, piece_storage storage, saved_game_compression compression,
+    uint8_t *output, int *output_size)
+{
+    switch (storage) {
+        case PIECE_STORED_ZLIB:
+            return zlib_helper_compress(piece->buf.data, piece->buf.size, output, piece->buf.size, output_size,
+                compression == SAVED_GAME_COMPRESSION_SMALL ? SMALL_COMPRESSION_LEVEL : Z_BEST_SPEED);
+        case PIECE_STORED_RLE:
+            return rle_compress(piece->buf.data, piece->buf.size, piece->element_size,
+                output, piece->buf.size, output_size);
+        default:
+            return 0;
+    }
+}
+
+typedef struct {
+    piece_table *table;
+    saved_game_compression compression;
+} encode_data;
+
+static void encode_pieces(int chunk, int start, int end, void *data)
+{
+    TRACE_BEGIN("encode saved game pieces");
+    const encode_data *encode = data;
+    piece_table *table = encode->table;
+    for (int i = start; i < end; i++) {
+        const file_piece *piece = &savegame_data.pieces[i];
+        piece_table_entry *entry = &table->entries[i];
+        entry->size = piece->buf.size;
+        entry->stored_size = piece->buf.size;
+        entry->storage = PIECE_STORED_RAW;
+        table->stored[i] = 0;
+        piece_storage storage = get_piece_storage(piece, encode->compression);
+        if (storage != PIECE_STORED_RAW) {
+            // Compressed data that is not smaller than the piece itself is not worth storing
+            uint8_t *compressed = malloc(piece->buf.size);
+            int compressed_size = 0;
+            if (compressed && compress_piece(piece, storage, encode->compression, compressed, &compressed_size)) {
+                table->stored[i] = compressed;
+                entry->stored_size = compressed_size;
+                entry->storage = storage;
+            } else {
+                free(compressed);
             }
         }
-        if (piece->compressed) {
-            write_compressed_chunk(fp, piece->buf.data, piece->buf.size, compress_buffer);
-        } else {
-            fwrite(piece->buf.data, 1, piece->buf.size, fp);
+        entry->checksum = hash_bytes(table->stored[i] ? table->stored[i] : piece->buf.data, entry->stored_size, 0);
+    }
+    TRACE_END();
+}
+
+static int savegame_write_to_file(FILE *fp, saved_game_compression compression)
+{
+    piece_table *table = &savegame_data.table;
+    int num_pieces = savegame_data.num_pieces;
+    encode_data encode = { table, compression };
+    job_parallel_for(num_pieces, 1, encode_pieces, &encode);
+
+    int table_size = get_piece_table_size(num_pieces);
+    uint32_t offset = 0;
+    for (int i = 0; i < num_pieces; i++) {
+        if (i == SAVEGAME_HEADER_PIECES) {
+            offset += table_size;
+        }
+        table->entries[i].offset = offset;
+        offset += table->entries[i].stored_size;
+    }
+    uint8_t table_data[PIECE_TABLE_MAX_SIZE];
+    buffer buf;
+    buffer_init(&buf, table_data, table_size);
+    write_piece_table(&buf, table, num_pieces);
+
+    int result = 1;
+    for (int i = 0; i < num_pieces; i++) {
+        if (i == SAVEGAME_HEADER_PIECES) {
+            result &= fwrite(table_data, 1, table_size, fp) == table_size;
+        }
+        const uint8_t *stored = table->stored[i] ? table->stored[i] : savegame_data.pieces[i].buf.data;
+        if (table->entries[i].stored_size) {
+            result &= fwrite(stored, 1, table->entries[i].stored_size, fp) == table->entries[i].stored_size;
         }
+        free(table->stored[i]);
+        table->stored[i] = 0;
     }
+    return result;
 }
 
 static int get_savegame_versions(FILE *fp, savegame_version *save_version, resource_version *resource_version)
@@ -1120,14 +1570,21 @@ int game_file_io_read_saved_game(const char *filename, int offset)
         log_info("Savegame version", 0, save_version);
         resource_set_mapping(resource_version);
         init_savegame_data(save_version);
+        TRACE_BEGIN("read saved game");
         result = savegame_read_from_file(fp, save_version);
+        TRACE_END();
     }
     file_close(fp);
     if (!result) {
         log_error("Unable to load game, unable to read savefile.", 0, 0);
         return 0;
     }
+    if (!map_fits_in_grid(savegame_data.state.scenario)) {
+        return 0;
+    }
+    TRACE_BEGIN("load saved game state");
     savegame_load_from_state(&savegame_data.state, save_version);
+    TRACE_END();
     return 1;
 }
 
@@ -1149,6 +1606,12 @@ static int skip_piece(FILE *fp, int size, int compressed)
     return fseek(fp, input_size, SEEK_CUR) == 0;
 }
 
+static int skip_grid_piece(FILE *fp, int element_size, int compressed, int dynamic_grid)
+{
+    int size = dynamic_grid ? PIECE_SIZE_DYNAMIC : LEGACY_GRID_SIZE * LEGACY_GRID_SIZE * element_size;
+    return skip_piece(fp, size, compressed);
+}
+
 static void free_file_piece(file_piece *piece)
 {
     buffer_reset(&piece->buf);
@@ -1196,6 +1659,48 @@ static building *savegame_building(int id)
     return &b;
 }
 
+static savegame_load_status load_file_info_from_state(saved_game_info *info, const savegame_state *state,
+    savegame_version version, int scenario_version)
+{
+    city_data_load_basic_info(state->city_data, &info->population, &info->treasury, &minimap_data.caravanserai_id, version);
+    game_time_load_basic_info(state->game_time, &info->month, &info->year);
+
+    int grid_start;
+    int grid_border_size;
+
+    minimap_data.version = version;
+    if (!map_fits_in_grid(state->scenario)) {
+        return SAVEGAME_STATUS_INVALID;
+    }
+    scenario_map_data_from_buffer(state->scenario, &minimap_data.city_width, &minimap_data.city_height,
+        &grid_start, &grid_border_size);
+    set_saved_layout_from_scenario(state->scenario, &grid_start, &grid_border_size);
+    if (map_grid_saved_layout_differs()) {
+        buffer *grids[] = {
+            state->terrain_grid, state->random_grid, state->edge_grid, state->bitfields_grid, state->building_grid
+        };
+        convert_saved_grids(grids, sizeof(grids) / sizeof(buffer *));
+    }
+    minimap_data.climate = scenario_climate_from_buffer(state->scenario, scenario_version);
+    minimap_data.functions.building = savegame_building;
+    minimap_data.functions.climate = get_climate;
+    minimap_data.functions.map.width = map_width;
+    minimap_data.functions.map.height = map_height;
+    minimap_data.functions.viewport = set_viewport;
+    minimap_data.functions.offset.building_id = savegame_get_building_id;
+    minimap_data.functions.offset.figure = 0;
+    minimap_data.functions.offset.is_draw_tile = savegame_is_draw_tile_at;
+    minimap_data.functions.offset.random = savegame_random_at;
+    minimap_data.functions.offset.terrain = savegame_terrain_at;
+    minimap_data.functions.offset.tile_size = savegame_tile_size_at;
+
+    city_view_set_custom_lookup(grid_start, minimap_data.city_width, minimap_data.city_height, grid_border_size);
+    widget_minimap_update(&minimap_data.functions);
+    city_view_restore_lookup();
+
+    return SAVEGAME_STATUS_OK;
+}
+
 static savegame_load_status savegame_read_file_info(FILE *fp, saved_game_info *info,
     savegame_version version, memory_block *compress_buffer)
 {
@@ -1213,12 +1718,13 @@ static savegame_load_status savegame_read_file_info(FILE *fp, saved_game_info *i
     init_file_piece(&scenario_version_data, 4, 0);
     init_file_piece(&city_data, version_data.piece_sizes.city_data, 0);
     init_file_piece(&game_time, 20, 0);
-    init_file_piece(&terrain_grid, version_data.piece_sizes.terrain_grid, 0);
-    init_file_piece(&random_grid, 26244, 0);
-    init_file_piece(&edge_grid, 26244, 0);
-    init_file_piece(&bitfields_grid, 26244, 0);
+    int dynamic_grids = version_data.features.dynamic_grids;
+    init_grid_piece(&terrain_grid, version_data.grid_element_sizes.terrain, 0, dynamic_grids);
+    init_grid_piece(&random_grid, 1, 0, dynamic_grids);
+    init_grid_piece(&edge_grid, 1, 0, dynamic_grids);
+    init_grid_piece(&bitfields_grid, 1, 0, dynamic_grids);
     init_file_piece(&scenario, version_data.piece_sizes.scenario, 0);
-    init_file_piece(&building_grid, 52488, 0);
+    init_grid_piece(&building_grid, 2, 0, dynamic_grids);
     init_file_piece(&buildings, version_data.piece_sizes.buildings, 0);
 
     state->terrain_grid = &terrain_grid.buf;
@@ -1242,39 +1748,44 @@ static savegame_load_status savegame_read_file_info(FILE *fp, saved_game_info *i
 
     int scenario_version = save_version_to_scenario_version(version, &scenario_version_data.buf);
     if (version_data.features.image_grid) {
-        skip_piece(fp, version_data.piece_sizes.image_grid, 1);
+        skip_grid_piece(fp, version_data.grid_element_sizes.image, 1, dynamic_grids);
     }
 
-    if (!read_compressed_savegame_chunk(fp, edge_grid.buf.data, edge_grid.buf.size, version, compress_buffer)) {
+    if (!prepare_dynamic_piece(fp, &edge_grid) ||
+        !read_compressed_savegame_chunk(fp, edge_grid.buf.data, edge_grid.buf.size, version, compress_buffer)) {
         return SAVEGAME_STATUS_INVALID;
     }
 
-    if (!read_compressed_savegame_chunk(fp, building_grid.buf.data, building_grid.buf.size, version, compress_buffer)) {
+    if (!prepare_dynamic_piece(fp, &building_grid) ||
+        !read_compressed_savegame_chunk(fp, building_grid.buf.data, building_grid.buf.size, version, compress_buffer)) {
         return SAVEGAME_STATUS_INVALID;
     }
 
-    if (!read_compressed_savegame_chunk(fp, terrain_grid.buf.data, terrain_grid.buf.size, version, compress_buffer)) {
+    if (!prepare_dynamic_piece(fp, &terrain_grid) ||
+        !read_compressed_savegame_chunk(fp, terrain_grid.buf.data, terrain_grid.buf.size, version, compress_buffer)) {
         return SAVEGAME_STATUS_INVALID;
     }
 
-    skip_piece(fp, 26244, 1);
-    skip_piece(fp, 52488, 1);
+    skip_grid_piece(fp, 1, 1, dynamic_grids);
+    skip_grid_piece(fp, 2, 1, dynamic_grids);
 
-    if (!read_compressed_savegame_chunk(fp, bitfields_grid.buf.data, bitfields_grid.buf.size, version, compress_buffer)) {
+    if (!prepare_dynamic_piece(fp, &bitfields_grid) ||
+        !read_compressed_savegame_chunk(fp, bitfields_grid.buf.data, bitfields_grid.buf.size, version, compress_buffer)) {
         return SAVEGAME_STATUS_INVALID;
     }
 
-    skip_piece(fp, 26244, 1);
+    skip_grid_piece(fp, 1, 1, dynamic_grids);
 
-    if (fread(random_grid.buf.data, 1, random_grid.buf.size, fp) != random_grid.buf.size) {
+    if (!prepare_dynamic_piece(fp, &random_grid) ||
+        fread(random_grid.buf.data, 1, random_grid.buf.size, fp) != random_grid.buf.size) {
         return SAVEGAME_STATUS_INVALID;
     }
 
-    skip_piece(fp, 26244, 1);
-    skip_piece(fp, 26244, 1);
-    skip_piece(fp, 26244, 1);
-    skip_piece(fp, 26244, 1);
-    skip_piece(fp, 26244, 1);
+    skip_grid_piece(fp, 1, 1, dynamic_grids);
+    skip_grid_piece(fp, 1, 1, dynamic_grids);
+    skip_grid_piece(fp, 1, 1, dynamic_grids);
+    skip_grid_piece(fp, 1, 1, dynamic_grids);
+    skip_grid_piece(fp, 1, 1, dynamic_grids);
     skip_piece(fp, version_data.piece_sizes.figures, 1);
     skip_piece(fp, version_data.piece_sizes.route_figures, 1);
     skip_piece(fp, version_data.piece_sizes.route_paths, 1);
@@ -1339,31 +1850,10 @@ static savegame_load_status savegame_read_file_info(FILE *fp, saved_game_info *i
 
     info->custom_mission = read_int32(fp);
 
-    city_data_load_basic_info(&city_data.buf, &info->population, &info->treasury, &minimap_data.caravanserai_id, version);
-    game_time_load_basic_info(&game_time.buf, &info->month, &info->year);
-
-    int grid_start;
-    int grid_border_size;
-
-    minimap_data.version = version;
-    scenario_map_data_from_buffer(&scenario.buf, &minimap_data.city_width, &minimap_data.city_height,
-        &grid_start, &grid_border_size);
-    minimap_data.climate = scenario_climate_from_buffer(&scenario.buf, scenario_version);
-    minimap_data.functions.building = savegame_building;
-    minimap_data.functions.climate = get_climate;
-    minimap_data.functions.map.width = map_width;
-    minimap_data.functions.map.height = map_height;
-    minimap_data.functions.viewport = set_viewport;
-    minimap_data.functions.offset.building_id = savegame_get_building_id;
-    minimap_data.functions.offset.figure = 0;
-    minimap_data.functions.offset.is_draw_tile = savegame_is_draw_tile_at;
-    minimap_data.functions.offset.random = savegame_random_at;
-    minimap_data.functions.offset.terrain = savegame_terrain_at;
-    minimap_data.functions.offset.tile_size = savegame_tile_size_at;
-
-    city_view_set_custom_lookup(grid_start, minimap_data.city_width, minimap_data.city_height, grid_border_size);
-    widget_minimap_update(&minimap_data.functions);
-    city_view_restore_lookup();
+    state->city_data = &city_data.buf;
+    state->game_time = &game_time.buf;
+    state->scenario = &scenario.buf;
+    savegame_load_status status = load_file_info_from_state(info, state, version, scenario_version);
 
     free_file_piece(&scenario_version_data);
     free_file_piece(&city_data);
@@ -1376,7 +1866,26 @@ static savegame_load_status savegame_read_file_info(FILE *fp, saved_game_info *i
     free_file_piece(&building_grid);
     free_file_piece(&buildings);
 
-    return SAVEGAME_STATUS_OK;
+    return status;
+}
+
+static savegame_load_status savegame_read_file_info_from_table(FILE *fp, saved_game_info *info,
+    savegame_version version)
+{
+    init_savegame_data(version);
+    savegame_state *state = &savegame_data.state;
+    buffer *const pieces[] = {
+        state->scenario_campaign_mission, state->scenario_version, state->edge_grid, state->building_grid,
+        state->terrain_grid, state->bitfields_grid, state->random_grid, state->city_data, state->buildings,
+        state->game_time, state->scenario, state->scenario_is_custom
+    };
+    if (!savegame_read_table_pieces(fp, pieces, sizeof(pieces) / sizeof(buffer *))) {
+        return SAVEGAME_STATUS_INVALID;
+    }
+    info->mission = buffer_read_i32(state->scenario_campaign_mission);
+    info->custom_mission = buffer_read_i32(state->scenario_is_custom);
+    int scenario_version = save_version_to_scenario_version(version, state->scenario_version);
+    return load_file_info_from_state(info, state, version, scenario_version);
 }
 
 int game_file_io_read_saved_game_info(const char *filename, saved_game_info *info)
@@ -1398,33 +1907,136 @@ int game_file_io_read_saved_game_info(const char *filename, saved_game_info *inf
         return SAVEGAME_STATUS_NEWER_VERSION;
     }
     resource_set_mapping(resource_version);
-    memory_block compress_buffer;
-    core_memory_block_init(&compress_buffer, COMPRESS_BUFFER_INITIAL_SIZE);
-    result = savegame_read_file_info(fp, info, save_version, &compress_buffer);
-    core_memory_block_free(&compress_buffer);
+    if (save_version > SAVE_GAME_LAST_SEQUENTIAL_PIECES) {
+        result = savegame_read_file_info_from_table(fp, info, save_version);
+    } else {
+        memory_block compress_buffer;
+        core_memory_block_init(&compress_buffer, COMPRESS_BUFFER_INITIAL_SIZE);
+        result = savegame_read_file_info(fp, info, save_version, &compress_buffer);
+        core_memory_block_free(&compress_buffer);
+    }
     file_close(fp);
     return result;
 }
 
-int game_file_io_write_saved_game(const char *filename)
+int game_file_io_write_saved_game(const char *filename, saved_game_compression compression)
 {
     resource_set_mapping(RESOURCE_CURRENT_VERSION);
     init_savegame_data(SAVE_GAME_CURRENT_VERSION);
 
     log_info("Saving game", filename, 0);
-    savegame_save_to_state(&savegame_data.state);
+    TRACE_BEGIN("save game state");
+    savegame_save_to_state(&savegame_data.state, 0);
+    TRACE_END();
 
     FILE *fp = file_open(filename, "wb");
     if (!fp) {
         log_error("Unable to save game", 0, 0);
         return 0;
     }
-    memory_block compress_buffer;
-    core_memory_block_init(&compress_buffer, COMPRESS_BUFFER_INITIAL_SIZE);
-    savegame_write_to_file(fp, &compress_buffer);
-    core_memory_block_free(&compress_buffer);
+    TRACE_BEGIN("write saved game");
+    int result = savegame_write_to_file(fp, compression);
     file_close(fp);
-    return 1;
+    TRACE_END();
+    if (!result) {
+        log_error("Unable to write the whole saved game", 0, 0);
+    }
+    return result;
+}
+
+static int get_piece_section(const buffer *buf)
+{
+    const savegame_state *s = &savegame_data.state;
+    // Interface state, and undo backups which are overwritten before they are used again
+    buffer *const excluded[] = {
+        s->city_view_orientation, s->city_view_camera, s->city_graph_order, s->messages, s->message_extra,
+        s->city_sounds, s->bookmarks, s->aqueduct_backup_grid, s->sprite_backup_grid
+    };
+    buffer *const map[] = {
+        s->image_grid, s->edge_grid, s->building_grid, s->terrain_grid, s->aqueduct_grid, s->figure_grid,
+        s->bitfields_grid, s->sprite_grid, s->random_grid, s->desirability_grid, s->elevation_grid,
+        s->building_damage_grid
+    };
+    buffer *const buildings[] = {
+        s->buildings, s->building_extra_highest_id_ever, s->building_extra_highest_id, s->building_extra_sequence,
+        s->building_extra_corrupt_houses, s->building_list_burning_totals, s->building_list_burning,
+        s->building_list_small, s->building_list_large, s->building_storages, s->building_barracks_tower_sentry,
+        s->building_count_culture1, s->building_count_culture2, s->building_count_culture3,
+        s->building_count_industry, s->building_count_military, s->building_count_support, s->deliveries
+    };
+    buffer *const figures[] = {
+        s->figures, s->route_figures, s->route_paths, s->figure_names, s->figure_sequence, s->figure_traders,
+        s->routing_counters, s->visited_buildings
+    };
+    buffer *const military[] = {
+        s->formations, s->formation_totals, s->enemy_army_totals, s->enemy_armies, s->invasion_warnings,
+        s->last_invasion_id
+    };
+    buffer *const city[] = {
+        s->city_data, s->city_faction_unknown, s->city_faction, s->player_name, s->culture_coverage,
+        s->population_messages, s->message_counts, s->message_delays, s->city_entry_exit_xy,
+        s->city_entry_exit_grid_offset
+    };
+    buffer *const empire[] = {
+        s->empire, s->empire_cities, s->trade_prices, s->trade_route_limit, s->trade_route_traded, s->custom_empire
+    };
+    if (is_one_of(buf, excluded, sizeof(excluded) / sizeof(buffer *))) {
+        return -1;
+    } else if (is_one_of(buf, map, sizeof(map) / sizeof(buffer *))) {
+        return SAVED_GAME_SECTION_MAP;
+    } else if (is_one_of(buf, buildings, sizeof(buildings) / sizeof(buffer *))) {
+        return SAVED_GAME_SECTION_BUILDINGS;
+    } else if (is_one_of(buf, figures, sizeof(figures) / sizeof(buffer *))) {
+        return SAVED_GAME_SECTION_FIGURES;
+    } else if (is_one_of(buf, military, sizeof(military) / sizeof(buffer *))) {
+        return SAVED_GAME_SECTION_MILITARY;
+    } else if (is_one_of(buf, city, sizeof(city) / sizeof(buffer *))) {
+        return SAVED_GAME_SECTION_CITY;
+    } else if (is_one_of(buf, empire, sizeof(empire) / sizeof(buffer *))) {
+        return SAVED_GAME_SECTION_EMPIRE;
+    } else {
+        // Scenario settings, game time, random state and other small pieces
+        return SAVED_GAME_SECTION_SCENARIO;
+    }
+}
+
+static void calculate_section_hashes(uint64_t *hashes, int fast)
+{
+    resource_set_mapping(RESOURCE_CURRENT_VERSION);
+    init_savegame_data(SAVE_GAME_CURRENT_VERSION);
+    savegame_save_to_state(&savegame_data.state, fast);
+
+    for (int i = 0; i < SAVED_GAME_SECTION_MAX; i++) {
+        hashes[i] = 0;
+    }
+    for (int i = 0; i < savegame_data.num_pieces; i++) {
+        const file_piece *piece = &savegame_data.pieces[i];
+        if (!piece->buf.size) {
+            continue;
+        }
+        int section = get_piece_section(&piece->buf);
+        if (section >= 0) {
+            hashes[section] = hash_bytes(piece->buf.data, piece->buf.size, hashes[section]);
+        }
+    }
+    if (fast) {
+        hashes[SAVED_GAME_SECTION_BUILDINGS] = building_hash_state(hashes[SAVED_GAME_SECTION_BUILDINGS]);
+        hashes[SAVED_GAME_SECTION_FIGURES] = figure_hash_state(hashes[SAVED_GAME_SECTION_FIGURES]);
+    }
+}
+
+void game_file_io_saved_game_section_hashes(uint64_t *hashes)
+{
+    calculate_section_hashes(hashes, 1);
+}
+
+uint32_t game_file_io_saved_game_checksum(void)
+{
+    // Replays store these checksums, so they keep hashing the saved game exactly as it is written
+    uint64_t hashes[SAVED_GAME_SECTION_MAX];
+    calculate_section_hashes(hashes, 0);
+    uint64_t checksum = hash_bytes(hashes, sizeof(hashes), 0);
+    return (uint32_t) (checksum ^ (checksum >> 32));
 }
 
 int game_file_io_delete_saved_game(const char *filename)
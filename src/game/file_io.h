@@ -25,6 +25,22 @@ typedef struct {
     scenario_win_criteria win_criteria;
 } scenario_info;
 
+typedef enum {
+    SAVED_GAME_SECTION_MAP = 0,
+    SAVED_GAME_SECTION_BUILDINGS = 1,
+    SAVED_GAME_SECTION_FIGURES = 2,
+    SAVED_GAME_SECTION_MILITARY = 3,
+    SAVED_GAME_SECTION_CITY = 4,
+    SAVED_GAME_SECTION_EMPIRE = 5,
+    SAVED_GAME_SECTION_SCENARIO = 6,
+    SAVED_GAME_SECTION_MAX = 7
+} saved_game_section;
+
+typedef enum {
+    SAVED_GAME_COMPRESSION_FAST = 0, /**< Quick to write, for saves that are made automatically */
+    SAVED_GAME_COMPRESSION_SMALL = 1 /**< Smallest file, for saves that the player makes */
+} saved_game_compression;
+
 int game_file_io_read_scenario(const char *filename);
 
 int game_file_io_read_scenario_info(const char *filename, scenario_info *info);
@@ -35,7 +51,31 @@ int game_file_io_read_saved_game(const char *filename, int offset);
 
 int game_file_io_read_saved_game_info(const char *filename, saved_game_info *info);
 
-int game_file_io_write_saved_game(const char *filename);
+/**
+ * Writes the current game to a saved game.
+ * The compression of every piece is stored in the piece table, so any saved game can be loaded
+ * regardless of the compression it was written with.
+ * @param filename File to save to
+ * @param compression Whether to write the file quickly or to make it as small as possible
+ * @return Boolean true on success, false on failure
+ */
+int game_file_io_write_saved_game(const char *filename, saved_game_compression compression);
+
+/**
+ * Calculates a checksum of the current game state, as it would be written to a saved game.
+ * State that does not affect the simulation, like the camera position or the undo backups, is left out.
+ * @return Checksum of the game state
+ */
+uint32_t game_file_io_saved_game_checksum(void);
+
+/**
+ * Calculates a hash of each section of the current game state, leaving out the same state as
+ * game_file_io_saved_game_checksum does. Sections can be compared to find which part of the game diverged.
+ * Buildings and figures that did not change since the previous call are not saved again, so the hashes
+ * are cheap enough to calculate often.
+ * @param hashes Array of SAVED_GAME_SECTION_MAX elements to store the hashes in
+ */
+void game_file_io_saved_game_section_hashes(uint64_t *hashes);
 
 int game_file_io_delete_saved_game(const char *filename);
 
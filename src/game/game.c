@@ -7,18 +7,22 @@
 #include "core/config.h"
 #include "core/hotkey_config.h"
 #include "core/image.h"
+#include "core/job.h"
 #include "core/lang.h"
 #include "core/locale.h"
 #include "core/log.h"
 #include "core/random.h"
+#include "core/trace.h"
 #include "editor/editor.h"
 #include "figure/type.h"
 #include "game/animation.h"
 #include "game/file.h"
 #include "game/file_editor.h"
+#include "game/replay.h"
 #include "game/settings.h"
 #include "game/speed.h"
 #include "game/state.h"
+#include "game/state_hash.h"
 #include "game/tick.h"
 #include "graphics/font.h"
 #include "graphics/video.h"
@@ -104,6 +108,7 @@ int game_init(void)
     init_augustus_building_properties();
     load_custom_messages();
     sound_system_init();
+    job_system_init();
     game_state_init();
     resource_init();
     int missing_assets = !assets_get_image_id("Logistics", "roadblock"); // If can't find roadblocks asset, extra assets not installed properly
@@ -190,12 +195,17 @@ void game_draw(void)
 {
     window_draw(0);
     sound_city_play();
+    sound_system_update();
 }
 
 void game_exit(void)
 {
+    game_replay_stop_recording();
+    game_state_hash_stop_log();
+    trace_stop();
     video_shutdown();
     settings_save();
     config_save();
     sound_system_shutdown();
+    job_system_shutdown();
 }
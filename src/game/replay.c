@@ -0,0 +1,540 @@
+#include "replay.h"
+
+#include "building/building.h"
+#include "building/construction.h"
+#include "building/construction_clear.h"
+#include "building/distribution.h"
+#include "building/rotation.h"
+#include "building/storage.h"
+#include "city/emperor.h"
+#include "city/festival.h"
+#include "city/finance.h"
+#include "city/games.h"
+#include "city/labor.h"
+#include "city/ratings.h"
+#include "city/resource.h"
+#include "city/trade_policy.h"
+#include "city/view.h"
+#include "core/buffer.h"
+#include "core/dir.h"
+#include "core/file.h"
+#include "core/log.h"
+#include "core/random.h"
+#include "empire/city.h"
+#include "figure/formation.h"
+#include "figure/formation_legion.h"
+#include "game/file.h"
+#include "game/file_io.h"
+#include "game/tick.h"
+#include "game/undo.h"
+#include "map/grid.h"
+#include "scenario/request.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define REPLAY_MAGIC 0x59504552 // "REPY"
+#define REPLAY_VERSION 2
+
+#define TICKS_PER_CHECKPOINT 50
+#define MAX_COMMAND_PARAMS 12
+#define COMMAND_SIZE (8 + 4 * MAX_COMMAND_PARAMS)
+#define TRAILER_SIZE 20
+
+typedef enum {
+    REPLAY_IDLE = 0,
+    REPLAY_REQUESTED = 1,
+    REPLAY_STARTING = 2,
+    REPLAY_RECORDING = 3,
+    REPLAY_PLAYING = 4
+} replay_state;
+
+typedef struct {
+    unsigned int tick;
+    replay_command command;
+    int params[MAX_COMMAND_PARAMS];
+} replay_entry;
+
+static struct {
+    replay_state state;
+    char filename[FILE_NAME_MAX];
+    uint32_t seed;
+    unsigned int tick;
+    replay_entry *entries;
+    int num_entries;
+    int capacity;
+    int next_entry;
+    int out_of_sync;
+} data;
+
+static void clear_entries(void)
+{
+    free(data.entries);
+    data.entries = 0;
+    data.num_entries = 0;
+    data.capacity = 0;
+    data.next_entry = 0;
+}
+
+static replay_entry *add_entry(replay_command command)
+{
+    if (data.num_entries >= data.capacity) {
+        int capacity = data.capacity ? 2 * data.capacity : 1024;
+        replay_entry *entries = realloc(data.entries, capacity * sizeof(replay_entry));
+        if (!entries) {
+            log_error("Out of memory for replay, recording stopped", 0, 0);
+            data.state = REPLAY_IDLE;
+            random_set_stdlib_seed(0);
+            return 0;
+        }
+        data.entries = entries;
+        data.capacity = capacity;
+    }
+    replay_entry *entry = &data.entries[data.num_entries++];
+    memset(entry, 0, sizeof(replay_entry));
+    entry->tick = data.tick;
+    entry->command = command;
+    return entry;
+}
+
+void game_replay_record_next_game(const char *filename)
+{
+    strncpy(data.filename, filename, FILE_NAME_MAX - 1);
+    data.filename[FILE_NAME_MAX - 1] = 0;
+    data.state = REPLAY_REQUESTED;
+}
+
+static void start_recording(void)
+{
+    // Reload the game from the replay file itself, so recording and playback start from identical state
+    data.state = REPLAY_STARTING;
+    if (!game_file_io_write_saved_game(data.filename, SAVED_GAME_COMPRESSION_FAST) || game_file_load_saved_game(data.filename) != 1) {
+        log_error("Unable to start recording replay", data.filename, 0);
+        data.state = REPLAY_IDLE;
+        return;
+    }
+    clear_entries();
+    data.tick = 0;
+    data.seed = (uint32_t) time(0) | 1;
+    random_set_stdlib_seed(data.seed);
+    data.state = REPLAY_RECORDING;
+    log_info("Recording replay", data.filename, 0);
+}
+
+void game_replay_handle_game_start(void)
+{
+    if (data.state == REPLAY_RECORDING) {
+        game_replay_stop_recording();
+    } else if (data.state == REPLAY_REQUESTED) {
+        start_recording();
+    }
+}
+
+static void write_entry(buffer *buf, const replay_entry *entry)
+{
+    buffer_write_u32(buf, entry->tick);
+    buffer_write_i32(buf, entry->command);
+    for (int i = 0; i < MAX_COMMAND_PARAMS; i++) {
+        buffer_write_i32(buf, entry->params[i]);
+    }
+}
+
+static void read_entry(buffer *buf, replay_entry *entry)
+{
+    entry->tick = buffer_read_u32(buf);
+    entry->command = buffer_read_i32(buf);
+    for (int i = 0; i < MAX_COMMAND_PARAMS; i++) {
+        entry->params[i] = buffer_read_i32(buf);
+    }
+}
+
+static int write_commands(FILE *fp)
+{
+    if (fseek(fp, 0, SEEK_END)) {
+        return 0;
+    }
+    long save_size = ftell(fp);
+    if (save_size <= 0) {
+        return 0;
+    }
+    int size = data.num_entries * COMMAND_SIZE + TRAILER_SIZE;
+    uint8_t *contents = malloc(size);
+    if (!contents) {
+        return 0;
+    }
+    buffer buf;
+    buffer_init(&buf, contents, size);
+    for (int i = 0; i < data.num_entries; i++) {
+        write_entry(&buf, &data.entries[i]);
+    }
+    buffer_write_u32(&buf, data.num_entries);
+    buffer_write_u32(&buf, (uint32_t) save_size);
+    buffer_write_u32(&buf, data.seed);
+    buffer_write_u32(&buf, REPLAY_VERSION);
+    buffer_write_u32(&buf, REPLAY_MAGIC);
+    int result = fwrite(contents, 1, size, fp) == (size_t) size;
+    free(contents);
+    return result;
+}
+
+int game_replay_stop_recording(void)
+{
+    if (data.state != REPLAY_RECORDING) {
+        return 0;
+    }
+    data.state = REPLAY_IDLE;
+    random_set_stdlib_seed(0);
+
+    int result = 0;
+    FILE *fp = file_open(data.filename, "ab");
+    if (fp) {
+        result = write_commands(fp);
+        file_close(fp);
+    }
+    if (result) {
+        log_info("Replay written, number of commands:", 0, data.num_entries);
+    } else {
+        log_error("Unable to write replay", data.filename, 0);
+    }
+    clear_entries();
+    return result;
+}
+
+static void verify_checkpoint(const replay_entry *entry)
+{
+    uint32_t checksum = game_file_io_saved_game_checksum();
+    if (checksum != (uint32_t) entry->params[0]) {
+        log_error("Replay out of sync at tick", 0, entry->tick);
+        data.out_of_sync = 1;
+    }
+}
+
+void game_replay_handle_tick(void)
+{
+    if (data.state == REPLAY_RECORDING) {
+        data.tick++;
+        if (data.tick % TICKS_PER_CHECKPOINT == 0) {
+            uint32_t checksum = game_file_io_saved_game_checksum();
+            replay_entry *entry = add_entry(REPLAY_COMMAND_CHECKPOINT);
+            if (entry) {
+                entry->params[0] = (int) checksum;
+            }
+        }
+    } else if (data.state == REPLAY_PLAYING) {
+        data.tick++;
+        while (data.next_entry < data.num_entries && !data.out_of_sync) {
+            const replay_entry *entry = &data.entries[data.next_entry];
+            if (entry->tick > data.tick || entry->command != REPLAY_COMMAND_CHECKPOINT) {
+                break;
+            }
+            verify_checkpoint(entry);
+            data.next_entry++;
+        }
+    }
+}
+
+void game_replay_record_command(replay_command command, int param1, int param2)
+{
+    if (data.state != REPLAY_RECORDING) {
+        return;
+    }
+    replay_entry *entry = add_entry(command);
+    if (entry) {
+        entry->params[0] = param1;
+        entry->params[1] = param2;
+    }
+}
+
+void game_replay_record_unsupported_command(const char *command)
+{
+    if (data.state != REPLAY_RECORDING) {
+        return;
+    }
+    log_error("Replays cannot reproduce this command, recording stopped:", command, 0);
+    game_replay_stop_recording();
+}
+
+void game_replay_record_construction(building_type type, building_type sub_type,
+    const map_tile *start, const map_tile *end)
+{
+    if (data.state != REPLAY_RECORDING) {
+        return;
+    }
+    replay_entry *entry = add_entry(REPLAY_COMMAND_CONSTRUCTION);
+    if (!entry) {
+        return;
+    }
+    int *params = entry->params;
+    params[0] = type;
+    params[1] = sub_type;
+    building_rotation_get_state(&params[2], &params[3], &params[4]);
+    params[5] = city_view_orientation();
+    params[6] = start->x;
+    params[7] = start->y;
+    params[8] = start->grid_offset;
+    params[9] = end->x;
+    params[10] = end->y;
+    params[11] = end->grid_offset;
+}
+
+static void play_construction(const int *params)
+{
+    for (int i = 0; i < 4 && city_view_orientation() != params[5]; i++) {
+        city_view_rotate_left();
+    }
+    building_construction_set_type(params[0]);
+    building_construction_set_sub_type(params[1]);
+    building_rotation_set_state(params[2], params[3], params[4]);
+    building_construction_start(params[6], params[7], params[8]);
+    if (building_construction_in_progress()) {
+        building_construction_update(params[9], params[10], params[11]);
+        building_construction_place();
+    }
+}
+
+static formation *get_legion(int formation_id)
+{
+    if (formation_id <= 0 || formation_id >= formation_count()) {
+        return 0;
+    }
+    formation *m = formation_get(formation_id);
+    return m->in_use && m->is_legion ? m : 0;
+}
+
+static building *get_building(int building_id)
+{
+    if (building_id <= 0 || building_id >= building_count()) {
+        return 0;
+    }
+    building *b = building_get(building_id);
+    return b->state != BUILDING_STATE_UNUSED ? b : 0;
+}
+
+static void play_command(const replay_entry *entry)
+{
+    const int *params = entry->params;
+    formation *m;
+    building *b;
+    switch (entry->command) {
+        case REPLAY_COMMAND_CONSTRUCTION:
+            play_construction(params);
+            break;
+        case REPLAY_COMMAND_UNDO:
+            game_undo_perform();
+            break;
+        case REPLAY_COMMAND_CHANGE_TAXES:
+            city_finance_change_tax_percentage(params[0]);
+            break;
+        case REPLAY_COMMAND_CHANGE_WAGES:
+            city_labor_change_wages(params[0]);
+            break;
+        case REPLAY_COMMAND_LEGION_LAYOUT:
+            if ((m = get_legion(params[0])) != 0) {
+                formation_legion_change_layout(m, params[1]);
+            }
+            break;
+        case REPLAY_COMMAND_LEGION_MOVE:
+            if ((m = get_legion(params[0])) != 0 && map_grid_is_valid_offset(params[1])) {
+                map_tile tile = { map_grid_offset_to_x(params[1]), map_grid_offset_to_y(params[1]), params[1] };
+                formation_legion_move_to(m, &tile);
+            }
+            break;
+        case REPLAY_COMMAND_LEGION_RETURN_HOME:
+            if ((m = get_legion(params[0])) != 0) {
+                formation_legion_return_home(m);
+            }
+            break;
+        case REPLAY_COMMAND_STORAGE_CYCLE_RESOURCE:
+            building_storage_cycle_resource_state(params[0], params[1]);
+            break;
+        case REPLAY_COMMAND_STORAGE_CYCLE_PARTIAL_RESOURCE:
+            building_storage_cycle_partial_resource_state(params[0], params[1]);
+            break;
+        case REPLAY_COMMAND_STORAGE_ACCEPT_NONE:
+            building_storage_accept_none(params[0]);
+            break;
+        case REPLAY_COMMAND_STORAGE_TOGGLE_EMPTY_ALL:
+            building_storage_toggle_empty_all(params[0]);
+            break;
+        case REPLAY_COMMAND_STORAGE_TOGGLE_PERMISSION:
+            if ((b = get_building(params[0])) != 0 && b->storage_id) {
+                building_storage_set_permission(params[1], b);
+            }
+            break;
+        case REPLAY_COMMAND_MARKET_TOGGLE_GOOD:
+            if ((b = get_building(params[0])) != 0) {
+                building_distribution_toggle_good_accepted(params[1], b);
+            }
+            break;
+        case REPLAY_COMMAND_MARKET_ACCEPT_NONE:
+            if ((b = get_building(params[0])) != 0) {
+                building_distribution_unaccept_all_goods(b);
+            }
+            break;
+        case REPLAY_COMMAND_STOCKPILING_TOGGLE:
+            if ((b = get_building(params[0])) != 0) {
+                building_stockpiling_toggle(b);
+            }
+            break;
+        case REPLAY_COMMAND_LABOR_PRIORITY:
+            city_labor_set_priority(params[0], params[1]);
+            break;
+        case REPLAY_COMMAND_OPEN_TRADE_ROUTE:
+            empire_city_open_trade(params[0]);
+            break;
+        case REPLAY_COMMAND_FESTIVAL:
+            city_festival_select_god(params[0]);
+            city_festival_select_size(params[1]);
+            city_festival_schedule();
+            break;
+        case REPLAY_COMMAND_GAMES:
+            city_games_schedule(params[0]);
+            break;
+        case REPLAY_COMMAND_MOTHBALL_BUILDING:
+            if ((b = get_building(params[0])) != 0) {
+                building_mothball_toggle(b);
+            }
+            break;
+        case REPLAY_COMMAND_MOTHBALL_RESOURCE:
+            city_resource_toggle_mothballed(params[0]);
+            break;
+        case REPLAY_COMMAND_STOCKPILE_RESOURCE:
+            city_resource_toggle_stockpiled(params[0]);
+            break;
+        case REPLAY_COMMAND_RESOURCE_TRADE_STATUS:
+            city_resource_cycle_trade_status(params[0], params[1]);
+            break;
+        case REPLAY_COMMAND_RESOURCE_IMPORT_OVER:
+            city_resource_change_import_over(params[0], params[1]);
+            break;
+        case REPLAY_COMMAND_RESOURCE_EXPORT_OVER:
+            city_resource_change_export_over(params[0], params[1]);
+            break;
+        case REPLAY_COMMAND_CLEAR_LAND_CONFIRM:
+            building_construction_clear_land_confirm(params[0], params[1]);
+            break;
+        case REPLAY_COMMAND_TRADE_POLICY:
+            city_trade_policy_set(params[0], params[1]);
+            break;
+        case REPLAY_COMMAND_EMPIRE_SERVICE:
+            if ((m = get_legion(params[0])) != 0) {
+                formation_toggle_empire_service(m->id);
+            }
+            break;
+        case REPLAY_COMMAND_DISTANT_BATTLE:
+            formation_legions_dispatch_to_distant_battle();
+            break;
+        case REPLAY_COMMAND_DISPATCH_REQUEST:
+            scenario_request_dispatch(params[0]);
+            break;
+        case REPLAY_COMMAND_SEND_GIFT:
+            if (city_emperor_set_gift_size(params[0])) {
+                city_emperor_send_gift();
+            }
+            break;
+        case REPLAY_COMMAND_SET_SALARY:
+            city_emperor_set_salary_rank(params[0]);
+            city_finance_update_salary();
+            city_ratings_update_favor_explanation();
+            break;
+        case REPLAY_COMMAND_DONATE:
+            city_emperor_set_donation_amount(params[0]);
+            city_emperor_donate_savings_to_city();
+            break;
+        default:
+            break;
+    }
+}
+
+static int load_commands(const char *filename, long *save_size)
+{
+    const char *path = dir_get_file(filename, NOT_LOCALIZED);
+    FILE *fp = path ? file_open(path, "rb") : 0;
+    if (!fp) {
+        return 0;
+    }
+    uint8_t trailer[TRAILER_SIZE];
+    buffer buf;
+    buffer_init(&buf, trailer, TRAILER_SIZE);
+    if (fseek(fp, -TRAILER_SIZE, SEEK_END) || fread(trailer, 1, TRAILER_SIZE, fp) != TRAILER_SIZE) {
+        file_close(fp);
+        return 0;
+    }
+    int num_entries = buffer_read_u32(&buf);
+    *save_size = buffer_read_u32(&buf);
+    uint32_t seed = buffer_read_u32(&buf);
+    uint32_t version = buffer_read_u32(&buf);
+    uint32_t magic = buffer_read_u32(&buf);
+    if (magic != REPLAY_MAGIC || version > REPLAY_VERSION || num_entries < 0 ||
+        fseek(fp, *save_size, SEEK_SET)) {
+        file_close(fp);
+        return 0;
+    }
+    int size = num_entries * COMMAND_SIZE;
+    uint8_t *contents = malloc(size ? size : 1);
+    replay_entry *entries = malloc(num_entries ? num_entries * sizeof(replay_entry) : 1);
+    if (!contents || !entries || fread(contents, 1, size, fp) != (size_t) size) {
+        free(contents);
+        free(entries);
+        file_close(fp);
+        return 0;
+    }
+    file_close(fp);
+
+    buffer_init(&buf, contents, size);
+    for (int i = 0; i < num_entries; i++) {
+        read_entry(&buf, &entries[i]);
+    }
+    free(contents);
+
+    clear_entries();
+    data.entries = entries;
+    data.num_entries = num_entries;
+    data.capacity = num_entries;
+    data.seed = seed;
+    return 1;
+}
+
+int game_replay_play(const char *filename)
+{
+    if (data.state == REPLAY_RECORDING) {
+        game_replay_stop_recording();
+    }
+    long save_size;
+    if (!load_commands(filename, &save_size)) {
+        log_error("Unable to read replay", filename, 0);
+        return 0;
+    }
+    data.state = REPLAY_PLAYING;
+    if (game_file_load_saved_game(filename) != 1) {
+        log_error("Unable to load game from replay", filename, 0);
+        data.state = REPLAY_IDLE;
+        clear_entries();
+        return 0;
+    }
+    log_info("Playing replay", filename, data.num_entries);
+    random_set_stdlib_seed(data.seed);
+    data.tick = 0;
+    data.next_entry = 0;
+    data.out_of_sync = 0;
+
+    while (data.next_entry < data.num_entries && !data.out_of_sync) {
+        const replay_entry *entry = &data.entries[data.next_entry];
+        if (entry->tick <= data.tick && entry->command != REPLAY_COMMAND_CHECKPOINT) {
+            play_command(entry);
+            data.next_entry++;
+        } else {
+            game_tick_run();
+        }
+    }
+    int result = !data.out_of_sync;
+    if (result) {
+        log_info("Replay finished in sync, ticks played:", 0, data.tick);
+    }
+    data.state = REPLAY_IDLE;
+    random_set_stdlib_seed(0);
+    clear_entries();
+    return result;
+}
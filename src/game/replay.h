@@ -0,0 +1,106 @@
+#ifndef GAME_REPLAY_H
+#define GAME_REPLAY_H
+
+#include "building/type.h"
+#include "map/point.h"
+
+/**
+ * @file
+ * Deterministic replays: a saved game followed by the player commands issued from it.
+ * Every game day a checksum of the game state is stored, so that playback can verify
+ * that the simulation still produces the same city.
+ */
+
+typedef enum {
+    REPLAY_COMMAND_NONE = 0,
+    REPLAY_COMMAND_CHECKPOINT = 1,
+    REPLAY_COMMAND_CONSTRUCTION = 2,
+    REPLAY_COMMAND_UNDO = 3,
+    REPLAY_COMMAND_CHANGE_TAXES = 4,
+    REPLAY_COMMAND_CHANGE_WAGES = 5,
+    REPLAY_COMMAND_LEGION_LAYOUT = 6,
+    REPLAY_COMMAND_LEGION_MOVE = 7,
+    REPLAY_COMMAND_LEGION_RETURN_HOME = 8,
+    REPLAY_COMMAND_STORAGE_CYCLE_RESOURCE = 9,
+    REPLAY_COMMAND_STORAGE_CYCLE_PARTIAL_RESOURCE = 10,
+    REPLAY_COMMAND_STORAGE_ACCEPT_NONE = 11,
+    REPLAY_COMMAND_STORAGE_TOGGLE_EMPTY_ALL = 12,
+    REPLAY_COMMAND_STORAGE_TOGGLE_PERMISSION = 13,
+    REPLAY_COMMAND_MARKET_TOGGLE_GOOD = 14,
+    REPLAY_COMMAND_MARKET_ACCEPT_NONE = 15,
+    REPLAY_COMMAND_STOCKPILING_TOGGLE = 16,
+    REPLAY_COMMAND_LABOR_PRIORITY = 17,
+    REPLAY_COMMAND_OPEN_TRADE_ROUTE = 18,
+    REPLAY_COMMAND_FESTIVAL = 19,
+    REPLAY_COMMAND_GAMES = 20,
+    REPLAY_COMMAND_MOTHBALL_BUILDING = 21,
+    REPLAY_COMMAND_MOTHBALL_RESOURCE = 22,
+    REPLAY_COMMAND_STOCKPILE_RESOURCE = 23,
+    REPLAY_COMMAND_RESOURCE_TRADE_STATUS = 24,
+    REPLAY_COMMAND_RESOURCE_IMPORT_OVER = 25,
+    REPLAY_COMMAND_RESOURCE_EXPORT_OVER = 26,
+    REPLAY_COMMAND_CLEAR_LAND_CONFIRM = 27,
+    REPLAY_COMMAND_TRADE_POLICY = 28,
+    REPLAY_COMMAND_EMPIRE_SERVICE = 29,
+    REPLAY_COMMAND_DISTANT_BATTLE = 30,
+    REPLAY_COMMAND_DISPATCH_REQUEST = 31,
+    REPLAY_COMMAND_SEND_GIFT = 32,
+    REPLAY_COMMAND_SET_SALARY = 33,
+    REPLAY_COMMAND_DONATE = 34
+} replay_command;
+
+/**
+ * Requests a replay to be recorded for the next game that is started or loaded
+ * @param filename File to write the replay to
+ */
+void game_replay_record_next_game(const char *filename);
+
+/**
+ * Handles a game being started or loaded: starts a requested recording, or finishes the current one
+ */
+void game_replay_handle_game_start(void);
+
+/**
+ * Finishes the current recording, if any, and writes it to disk
+ * @return Boolean true if a recording was written, false otherwise
+ */
+int game_replay_stop_recording(void);
+
+/**
+ * Handles the end of a game tick: counts ticks and records or verifies checkpoints
+ */
+void game_replay_handle_tick(void);
+
+/**
+ * Records a player command while recording
+ * @param command Command to record
+ * @param param1 First command parameter
+ * @param param2 Second command parameter
+ */
+void game_replay_record_command(replay_command command, int param1, int param2);
+
+/**
+ * Stops the recording when the player issues a command that replays cannot reproduce.
+ * The replay written up to that point still plays back in sync.
+ * @param command Name of the command, for the log
+ */
+void game_replay_record_unsupported_command(const char *command);
+
+/**
+ * Records the placement of a building while recording
+ * @param type Construction type as selected by the player
+ * @param sub_type Construction sub type, for temples
+ * @param start Tile where the player started building
+ * @param end Tile where the player finished building
+ */
+void game_replay_record_construction(building_type type, building_type sub_type,
+    const map_tile *start, const map_tile *end);
+
+/**
+ * Plays back a replay as fast as possible, without drawing
+ * @param filename Replay file to play
+ * @return Boolean true if the replay played until the end and all checkpoints matched, false otherwise
+ */
+int game_replay_play(const char *filename);
+
+#endif // GAME_REPLAY_H
@@ -2,7 +2,7 @@
 #define GAME_SAVE_VERSION_H
 
 typedef enum {
-    SAVE_GAME_CURRENT_VERSION = 0x92,
+    SAVE_GAME_CURRENT_VERSION = 0x95,
 
     SAVE_GAME_LAST_ORIGINAL_LIMITS_VERSION = 0x66,
     SAVE_GAME_LAST_SMALLER_IMAGE_ID_VERSION = 0x76,
@@ -28,11 +28,17 @@ typedef enum {
     SAVE_GAME_LAST_NO_SCENARIO_VERSION = 0x8e,
     SAVE_GAME_LAST_UNKNOWN_UNUSED_CITY_DATA = 0x8f,
     SAVE_GAME_LAST_STATIC_RESOURCES = 0x90,
-    SAVE_GAME_LAST_GLOBAL_BUILDING_INFO = 0x91
+    SAVE_GAME_LAST_GLOBAL_BUILDING_INFO = 0x91,
+    // grids were always 162x162 and coordinates were stored in a single byte
+    SAVE_GAME_LAST_FIXED_GRID_SIZE = 0x92,
+    // pieces were stored one after the other, without a piece table
+    SAVE_GAME_LAST_SEQUENTIAL_PIECES = 0x93,
+    // pieces were either stored as they are or compressed with zlib, never run length encoded
+    SAVE_GAME_LAST_ZLIB_ONLY_PIECES = 0x94
 } savegame_version;
 
 typedef enum {
-    SCENARIO_CURRENT_VERSION = 8,
+    SCENARIO_CURRENT_VERSION = 9,
 
     SCENARIO_VERSION_NONE = 0,
     SCENARIO_LAST_UNVERSIONED = 1,
@@ -41,7 +47,8 @@ typedef enum {
     SCENARIO_LAST_EMPIRE_RESOURCES_U8 = 4,
     SCENARIO_LAST_EMPIRE_RESOURCES_ALWAYS_WRITE = 5,
     SCENARIO_LAST_NO_SAVE_VERSION_WRITE = 6,
-    SCENARIO_LAST_NO_STATIC_RESOURCES = 7
+    SCENARIO_LAST_NO_STATIC_RESOURCES = 7,
+    SCENARIO_LAST_FIXED_GRID_SIZE = 8
 } scenario_version;
 
 typedef enum {
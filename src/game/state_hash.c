@@ -0,0 +1,178 @@
+#include "state_hash.h"
+
+#include "core/file.h"
+#include "core/log.h"
+#include "game/file_io.h"
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+
+#define MAX_LINE_LENGTH 256
+
+static const char *SECTION_NAMES[SAVED_GAME_SECTION_MAX] = {
+    "map", "buildings", "figures", "military", "city", "empire", "scenario"
+};
+
+static struct {
+    FILE *fp;
+    int interval;
+    int game_started;
+    unsigned int tick;
+    uint64_t initial_hashes[SAVED_GAME_SECTION_MAX];
+} data;
+
+typedef struct {
+    FILE *fp;
+    int game;
+    unsigned int tick;
+    uint64_t hashes[SAVED_GAME_SECTION_MAX];
+} log_reader;
+
+static void write_hashes(const uint64_t *hashes)
+{
+    fprintf(data.fp, "%u", data.tick);
+    for (int i = 0; i < SAVED_GAME_SECTION_MAX; i++) {
+        fprintf(data.fp, " %016" PRIx64, hashes[i]);
+    }
+    fputc('\n', data.fp);
+}
+
+int game_state_hash_start_log(const char *filename, int interval)
+{
+    game_state_hash_stop_log();
+    data.fp = file_open(filename, "w");
+    if (!data.fp) {
+        log_error("Unable to open state hash log", filename, 0);
+        return 0;
+    }
+    data.interval = interval > 0 ? interval : 1;
+    data.game_started = 0;
+    data.tick = 0;
+    fprintf(data.fp, "# Augustus state hash log, every %d ticks\n# tick", data.interval);
+    for (int i = 0; i < SAVED_GAME_SECTION_MAX; i++) {
+        fprintf(data.fp, " %s", SECTION_NAMES[i]);
+    }
+    fputc('\n', data.fp);
+    return 1;
+}
+
+void game_state_hash_stop_log(void)
+{
+    if (data.fp) {
+        file_close(data.fp);
+        data.fp = 0;
+    }
+}
+
+void game_state_hash_handle_game_start(void)
+{
+    if (!data.fp) {
+        return;
+    }
+    // The initial state is written on the first tick, so that a game which is reloaded
+    // before it runs, like when a replay recording starts, is only logged once
+    game_file_io_saved_game_section_hashes(data.initial_hashes);
+    data.game_started = 1;
+    data.tick = 0;
+}
+
+void game_state_hash_handle_tick(void)
+{
+    if (!data.fp || !data.game_started) {
+        return;
+    }
+    if (data.tick == 0) {
+        fputs("game\n", data.fp);
+        write_hashes(data.initial_hashes);
+    }
+    data.tick++;
+    if (data.tick % data.interval == 0) {
+        uint64_t hashes[SAVED_GAME_SECTION_MAX];
+        game_file_io_saved_game_section_hashes(hashes);
+        write_hashes(hashes);
+    }
+}
+
+static int read_entry(log_reader *reader)
+{
+    char line[MAX_LINE_LENGTH];
+    while (fgets(line, MAX_LINE_LENGTH, reader->fp)) {
+        if (line[0] == '#') {
+            continue;
+        }
+        if (strncmp(line, "game", 4) == 0) {
+            reader->game++;
+            continue;
+        }
+        const char *p = line;
+        int length;
+        if (sscanf(p, "%u%n", &reader->tick, &length) != 1) {
+            return 0;
+        }
+        p += length;
+        for (int i = 0; i < SAVED_GAME_SECTION_MAX; i++) {
+            if (sscanf(p, "%" SCNx64 "%n", &reader->hashes[i], &length) != 1) {
+                return 0;
+            }
+            p += length;
+        }
+        return 1;
+    }
+    return 0;
+}
+
+int game_state_hash_compare_logs(const char *filename1, const char *filename2)
+{
+    log_reader logs[2];
+    memset(logs, 0, sizeof(logs));
+    logs[0].fp = file_open(filename1, "r");
+    logs[1].fp = file_open(filename2, "r");
+    if (!logs[0].fp || !logs[1].fp) {
+        log_error("Unable to open state hash log", logs[0].fp ? filename2 : filename1, 0);
+        if (logs[0].fp) {
+            file_close(logs[0].fp);
+        }
+        if (logs[1].fp) {
+            file_close(logs[1].fp);
+        }
+        return 0;
+    }
+    int equal = 1;
+    int entries = 0;
+    while (equal) {
+        int has_entry1 = read_entry(&logs[0]);
+        int has_entry2 = read_entry(&logs[1]);
+        if (!has_entry1 && !has_entry2) {
+            break;
+        }
+        if (has_entry1 != has_entry2) {
+            log_error("State hash logs have a different length, the shorter one is",
+                has_entry1 ? filename2 : filename1, 0);
+            equal = 0;
+        } else if (logs[0].game != logs[1].game || logs[0].tick != logs[1].tick) {
+            log_error("State hash logs are not for the same games and ticks", 0, 0);
+            equal = 0;
+        } else {
+            for (int i = 0; i < SAVED_GAME_SECTION_MAX; i++) {
+                if (logs[0].hashes[i] != logs[1].hashes[i]) {
+                    if (equal) {
+                        char message[MAX_LINE_LENGTH];
+                        snprintf(message, MAX_LINE_LENGTH, "State diverged in game %d at tick %u",
+                            logs[0].game, logs[0].tick);
+                        log_error(message, 0, 0);
+                        equal = 0;
+                    }
+                    log_error("State differs in section", SECTION_NAMES[i], 0);
+                }
+            }
+        }
+        entries++;
+    }
+    if (equal) {
+        log_info("State hash logs are equal, number of entries:", 0, entries);
+    }
+    file_close(logs[0].fp);
+    file_close(logs[1].fp);
+    return equal;
+}
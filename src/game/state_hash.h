@@ -0,0 +1,42 @@
+#ifndef GAME_STATE_HASH_H
+#define GAME_STATE_HASH_H
+
+/**
+ * @file
+ * State hash logs: hashes of each section of the game state, written every few ticks.
+ * Two logs of the same game, for example from playing the same replay with different builds,
+ * can be compared to find the first tick and the part of the game where they diverged.
+ */
+
+/**
+ * Starts logging state hashes. Each game that is started or loaded afterwards is logged.
+ * @param filename File to write the log to
+ * @param interval Number of ticks between hashes
+ * @return Boolean true if the log file could be opened, false otherwise
+ */
+int game_state_hash_start_log(const char *filename, int interval);
+
+/**
+ * Stops logging state hashes and closes the log file
+ */
+void game_state_hash_stop_log(void);
+
+/**
+ * Handles a game being started or loaded: restarts the tick count and logs the initial state
+ */
+void game_state_hash_handle_game_start(void);
+
+/**
+ * Handles the end of a game tick: logs the state hashes when the interval has passed
+ */
+void game_state_hash_handle_tick(void);
+
+/**
+ * Compares two state hash logs and logs the first difference
+ * @param filename1 First log
+ * @param filename2 Second log
+ * @return Boolean true if the logs are equal, false if they differ or could not be read
+ */
+int game_state_hash_compare_logs(const char *filename1, const char *filename2);
+
+#endif // GAME_STATE_HASH_H
@@ -33,12 +33,15 @@
 #include "city/victory.h"
 #include "core/config.h"
 #include "core/random.h"
+#include "core/trace.h"
 #include "editor/editor.h"
 #include "empire/city.h"
 #include "figure/formation.h"
 #include "figuretype/crime.h"
 #include "game/file.h"
+#include "game/replay.h"
 #include "game/settings.h"
+#include "game/state_hash.h"
 #include "game/time.h"
 #include "game/tutorial.h"
 #include "game/undo.h"
@@ -95,9 +98,7 @@ static void advance_month(void)
     building_trim();
 
     building_connectable_update_connections();
-    map_tiles_update_all_roads();
-    map_tiles_update_all_highways();
-    map_tiles_update_all_water();
+    map_tiles_update_changed_terrain_images();
     map_routing_update_land_citizen();
     city_message_sort_and_compact();
 
@@ -114,10 +115,10 @@ static void advance_month(void)
     city_gods_update_blessings();
     tutorial_on_month_tick();
     if (setting_monthly_autosave()) {
-        game_file_write_saved_game("autosave.svx");
+        game_file_write_saved_game("autosave.svx", SAVED_GAME_COMPRESSION_FAST);
     }
     if (new_year && config_get(CONFIG_GP_CH_YEARLY_AUTOSAVE)) {
-        game_file_write_saved_game("autosave-year.svx");
+        game_file_write_saved_game("autosave-year.svx", SAVED_GAME_COMPRESSION_FAST);
     }
 }
 
@@ -188,21 +189,37 @@ static void advance_tick(void)
     }
 }
 
+static unsigned int tick_id = 1;
+
 void game_tick_run(void)
 {
+    tick_id++;
     if (editor_is_active()) {
         random_generate_next(); // update random to randomize native huts
         figure_action_handle(); // just update the flag figures
         return;
     }
+    TRACE_BEGIN("tick");
     random_generate_next();
     game_undo_reduce_time_available();
+    TRACE_BEGIN("city update");
     advance_tick();
+    TRACE_END();
     figure_action_handle();
+    TRACE_BEGIN("scenario events");
     scenario_earthquake_process();
     scenario_gladiator_revolt_process();
     scenario_emperor_change_process();
     city_victory_check();
+    TRACE_END();
+    game_replay_handle_tick();
+    game_state_hash_handle_tick();
+    TRACE_END();
+}
+
+unsigned int game_tick_id(void)
+{
+    return tick_id;
 }
 
 void game_tick_cheat_year(void)
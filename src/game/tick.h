@@ -3,6 +3,14 @@
 
 void game_tick_run(void);
 
+/**
+ * Gets an identifier of the current game tick, which changes every time a tick is run.
+ * Use this instead of the system time for per-tick caches, so the outcome of a tick
+ * does not depend on how many ticks are run in the same frame.
+ * @return Tick identifier
+ */
+unsigned int game_tick_id(void);
+
 void game_tick_cheat_year(void);
 
 #endif // GAME_TICK_H
@@ -53,6 +53,9 @@ typedef uint32_t color_t;
 #define COLOR_MINIMAP_ENEMY_NORTHERN 0xff1800ff
 #define COLOR_MINIMAP_ENEMY_DESERT 0xff08007b
 #define COLOR_MINIMAP_WOLF COLOR_BLACK
+#define COLOR_MINIMAP_OVERLAY_NONE 0xff5a5a5a
+#define COLOR_MINIMAP_OVERLAY_GREEN 0xff29a529
+#define COLOR_MINIMAP_OVERLAY_RED 0xffd62929
 
 #define COLOR_OVERLAY_NEUTRAL 0xccffffff
 #define COLOR_OVERLAY_NEGATIVE_STEP 0x00040505
@@ -3,6 +3,14 @@
 #include "core/encoding_japanese.h"
 #include "core/encoding_trad_chinese.h"
 #include "core/image.h"
+#include "graphics/text_cache.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define MULTIBYTE_CACHE_SIZE 0x10000
+#define MULTIBYTE_CACHE_NO_LETTER -1
+#define MULTIBYTE_CACHE_UNKNOWN -2
 
 static int image_y_offset_none(uint8_t c, int image_height, int line_height);
 static int image_y_offset_default(uint8_t c, int image_height, int line_height);
@@ -197,6 +205,7 @@ static struct {
     const int *font_mapping;
     const font_definition *font_definitions;
     int multibyte;
+    int16_t *multibyte_char_ids;
 } data;
 
 static int image_y_offset_none(uint8_t c, int image_height, int line_height)
@@ -436,6 +445,50 @@ static int image_y_offset_japanese(uint8_t c, int image_height, int line_height)
     return image_height - line_height;
 }
 
+static void reset_multibyte_cache(void)
+{
+    // Only the table-based lookups are slow enough to be worth caching
+    if (data.multibyte != MULTIBYTE_TRADITIONAL_CHINESE && data.multibyte != MULTIBYTE_JAPANESE) {
+        free(data.multibyte_char_ids);
+        data.multibyte_char_ids = 0;
+        return;
+    }
+    if (!data.multibyte_char_ids) {
+        data.multibyte_char_ids = malloc(sizeof(int16_t) * MULTIBYTE_CACHE_SIZE);
+        if (!data.multibyte_char_ids) {
+            return;
+        }
+    }
+    for (int i = 0; i < MULTIBYTE_CACHE_SIZE; i++) {
+        data.multibyte_char_ids[i] = MULTIBYTE_CACHE_UNKNOWN;
+    }
+}
+
+static int lookup_multibyte_char_id(uint8_t first, uint8_t second)
+{
+    if (data.multibyte == MULTIBYTE_TRADITIONAL_CHINESE) {
+        int char_id = encoding_trad_chinese_big5_to_image_id(first << 8 | second);
+        if (char_id < 0 || char_id >= IMAGE_FONT_MULTIBYTE_TRAD_CHINESE_MAX_CHARS) {
+            return MULTIBYTE_CACHE_NO_LETTER;
+        }
+        return char_id;
+    } else {
+        return encoding_japanese_sjis_to_image_id(first, second);
+    }
+}
+
+static int get_multibyte_char_id(uint8_t first, uint8_t second)
+{
+    if (!data.multibyte_char_ids) {
+        return lookup_multibyte_char_id(first, second);
+    }
+    int16_t *char_id = &data.multibyte_char_ids[first << 8 | second];
+    if (*char_id == MULTIBYTE_CACHE_UNKNOWN) {
+        *char_id = lookup_multibyte_char_id(first, second);
+    }
+    return *char_id;
+}
+
 void font_set_encoding(encoding_type encoding)
 {
     data.multibyte = MULTIBYTE_NONE;
@@ -465,6 +518,8 @@ void font_set_encoding(encoding_type encoding)
         data.font_mapping = CHAR_TO_FONT_IMAGE_DEFAULT;
         data.font_definitions = DEFINITIONS_DEFAULT;
     }
+    reset_multibyte_cache();
+    text_cache_clear();
 }
 
 const font_definition *font_definition_for(font_t font)
@@ -486,9 +541,8 @@ int font_letter_id(const font_definition *def, const uint8_t *str, int *num_byte
             int char_id = (str[0] & 0x7f) | ((str[1] & 0x7f) << 7);
             if (char_id >= IMAGE_FONT_MULTIBYTE_TRAD_CHINESE_MAX_CHARS) {
                 // lookup in table
-                int big5_encoded = str[0] << 8 | str[1];
-                char_id = encoding_trad_chinese_big5_to_image_id(big5_encoded);
-                if (char_id < 0 || char_id >= IMAGE_FONT_MULTIBYTE_TRAD_CHINESE_MAX_CHARS) {
+                char_id = get_multibyte_char_id(str[0], str[1]);
+                if (char_id == MULTIBYTE_CACHE_NO_LETTER) {
                     return -1;
                 }
             }
@@ -511,9 +565,9 @@ int font_letter_id(const font_definition *def, const uint8_t *str, int *num_byte
             int char_id;
             if (str[0] >= 0xa0 && str[0] < 0xe0) {
                 *num_bytes = 1;
-                char_id = encoding_japanese_sjis_to_image_id(str[0], 0);
+                char_id = get_multibyte_char_id(str[0], 0);
             } else {
-                char_id = encoding_japanese_sjis_to_image_id(str[0], str[1]);
+                char_id = get_multibyte_char_id(str[0], str[1]);
             }
             if (char_id == -1) {
                 return -1;
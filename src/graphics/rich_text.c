@@ -9,9 +9,13 @@
 #include "graphics/image_button.h"
 #include "graphics/panel.h"
 #include "graphics/scrollbar.h"
+#include "graphics/text_cache.h"
 #include "graphics/window.h"
 
+#include <string.h>
+
 #define MAX_LINKS 50
+#define MAX_LINES 1000
 
 static void on_scroll(void);
 
@@ -238,35 +242,35 @@ static void draw_line(const uint8_t *str, int x, int y, color_t color, int measu
     }
 }
 
-static int draw_text(const uint8_t *text, int x_offset, int y_offset,
-                     int box_width, int height_lines, color_t color, int measure_only)
+static int get_font_key(void)
 {
-    int image_height_lines = 0;
-    int image_id = 0;
-    int lines_before_image = 0;
+    // Distinguishes rich text layouts from plain text layouts, which use the font as key
+    return (1 << 16) | (data.paragraph_indent << 8) | (data.link_font->font << 4) | data.normal_font->font;
+}
+
+static const text_layout *get_layout(const uint8_t *text, int box_width)
+{
+    int font_key = get_font_key();
+    const text_layout *layout = text_cache_get(text, font_key, box_width);
+    if (layout) {
+        return layout;
+    }
+    text_layout *new_layout = text_cache_new_layout();
+    const uint8_t *start = text;
     int paragraph = 0;
     int has_more_characters = 1;
-    int y = y_offset;
     int guard = 0;
-    int line = 0;
-    int num_lines = 0;
-    while (has_more_characters || image_height_lines) {
-        if (++guard >= 1000) {
+    while (has_more_characters) {
+        if (++guard >= MAX_LINES) {
             break;
         }
-        // clear line
-        for (int i = 0; i < 200; i++) {
-            tmp_line[i] = 0;
-        }
-        int line_index = 0;
-        int current_width, x_line_offset;
-        current_width = x_line_offset = paragraph ? data.paragraph_indent : 0;
+        text_cache_line *line = &new_layout->lines[new_layout->num_lines++];
+        memset(line, 0, sizeof(text_cache_line));
+        line->start = (int) (text - start);
+        int current_width;
+        current_width = line->x_offset = paragraph ? data.paragraph_indent : 0;
         paragraph = 0;
-        while ((has_more_characters || image_height_lines) && current_width < box_width) {
-            if (image_height_lines) {
-                image_height_lines--;
-                break;
-            }
+        while (has_more_characters && current_width < box_width) {
             int word_num_chars;
             current_width += get_word_width(text, 0, &word_num_chars);
             if (current_width >= box_width) {
@@ -287,26 +291,21 @@ static int draw_text(const uint8_t *text, int x_offset, int y_offset,
                             current_width = box_width;
                             break;
                         } else if (*text == 'G') {
-                            if (line_index) {
-                                num_lines++;
-                            }
+                            line->has_text_before_image = line->length > 0;
                             text++; // skip 'G'
                             current_width = box_width;
-                            image_id = string_to_int(text);
+                            line->image_id = string_to_int(text);
                             c = *text++;
                             while (c >= '0' && c <= '9') {
                                 c = *text++;
                             }
-                            image_id += image_group(GROUP_MESSAGE_IMAGES) - 1;
-                            image_height_lines = image_get(image_id)->height / data.line_height + 2;
-                            if (line > 0) {
-                                lines_before_image = 1;
-                            }
                             break;
                         }
                     }
-                    if (line_index || c != ' ') { // no space at start of line
-                        tmp_line[line_index++] = c;
+                    if (line->length || c != ' ') { // no space at start of line
+                        line->length++;
+                    } else {
+                        line->start++;
                     }
                 }
                 if (!*text) {
@@ -314,6 +313,42 @@ static int draw_text(const uint8_t *text, int x_offset, int y_offset,
                 }
             }
         }
+    }
+    return text_cache_store(start, font_key, box_width, new_layout);
+}
+
+static int draw_text(const uint8_t *text, int x_offset, int y_offset,
+                     int box_width, int height_lines, color_t color, int measure_only)
+{
+    const text_layout *layout = get_layout(text, box_width);
+    int image_height_lines = 0;
+    int image_id = 0;
+    int lines_before_image = 0;
+    int y = y_offset;
+    int guard = 0;
+    int line = 0;
+    int num_lines = 0;
+    int layout_line = 0;
+    while (layout_line < layout->num_lines || image_height_lines) {
+        if (++guard >= MAX_LINES) {
+            break;
+        }
+        const text_cache_line *text_line = 0;
+        if (image_height_lines) {
+            image_height_lines--;
+        } else {
+            text_line = &layout->lines[layout_line++];
+            if (text_line->image_id) {
+                if (text_line->has_text_before_image) {
+                    num_lines++;
+                }
+                image_id = text_line->image_id + image_group(GROUP_MESSAGE_IMAGES) - 1;
+                image_height_lines = image_get(image_id)->height / data.line_height + 2;
+                if (line > 0) {
+                    lines_before_image = 1;
+                }
+            }
+        }
 
         int outside_viewport = 0;
         if (!measure_only) {
@@ -321,8 +356,12 @@ static int draw_text(const uint8_t *text, int x_offset, int y_offset,
                 outside_viewport = 1;
             }
         }
-        if (!outside_viewport) {
-            draw_line(tmp_line, x_line_offset + x_offset, y, color, measure_only);
+        if (!outside_viewport && text_line) {
+            int length = text_line->length < (int) sizeof(tmp_line) ?
+                text_line->length : (int) sizeof(tmp_line) - 1;
+            memset(tmp_line, 0, sizeof(tmp_line));
+            memcpy(tmp_line, &text[text_line->start], length);
+            draw_line(tmp_line, text_line->x_offset + x_offset, y, color, measure_only);
         }
         if (!measure_only) {
             if (image_id) {
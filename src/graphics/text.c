@@ -7,11 +7,13 @@
 #include "core/time.h"
 #include "graphics/graphics.h"
 #include "graphics/image.h"
+#include "graphics/text_cache.h"
 
 #include <string.h>
 
 #define ELLIPSIS_LENGTH 4
 #define NUMBER_BUFFER_LENGTH 100
+#define SINGLE_LINE -1
 
 static uint8_t tmp_line[200];
 
@@ -87,7 +89,7 @@ void text_draw_cursor(int x_offset, int y_offset, int is_insert)
     }
 }
 
-int text_get_width(const uint8_t *str, font_t font)
+static int measure_width(const uint8_t *str, font_t font)
 {
     const font_definition *def = font_definition_for(font);
     int maxlen = 10000;
@@ -108,6 +110,17 @@ int text_get_width(const uint8_t *str, font_t font)
     return width;
 }
 
+int text_get_width(const uint8_t *str, font_t font)
+{
+    const text_layout *layout = text_cache_get(str, font, SINGLE_LINE);
+    if (!layout) {
+        text_layout *new_layout = text_cache_new_layout();
+        new_layout->width = measure_width(str, font);
+        layout = text_cache_store(str, font, SINGLE_LINE, new_layout);
+    }
+    return layout->width;
+}
+
 int text_get_number_width(int value, char prefix, const char *postfix, font_t font)
 {
     const font_definition *def = font_definition_for(font);
@@ -563,25 +576,24 @@ void text_draw_number_centered_colored(
     text_draw_centered(str, x_offset, y_offset, box_width, font, color);
 }
 
-int text_draw_multiline(const uint8_t *str, int x_offset, int y_offset, int box_width, font_t font, uint32_t color)
+static const text_layout *get_multiline_layout(const uint8_t *str, int box_width, font_t font)
 {
-    int line_height = font_definition_for(font)->line_height;
-    if (line_height < 11) {
-        line_height = 11;
+    const text_layout *layout = text_cache_get(str, font, box_width);
+    if (layout) {
+        return layout;
     }
+    text_layout *new_layout = text_cache_new_layout();
+    const uint8_t *start = str;
     int has_more_characters = 1;
     int guard = 0;
-    int y = y_offset;
     while (has_more_characters) {
         if (++guard >= 100) {
             break;
         }
-        // clear line
-        for (int i = 0; i < 200; i++) {
-            tmp_line[i] = 0;
-        }
+        text_cache_line *line = &new_layout->lines[new_layout->num_lines++];
+        memset(line, 0, sizeof(text_cache_line));
+        line->start = (int) (str - start);
         int current_width = 0;
-        int line_index = 0;
         while (has_more_characters && current_width < box_width) {
             int word_num_chars;
             int word_width = get_word_width(str, font, &word_num_chars);
@@ -592,11 +604,12 @@ int text_draw_multiline(const uint8_t *str, int x_offset, int y_offset, int box_
                 }
             } else {
                 for (int i = 0; i < word_num_chars; i++) {
-                    if (line_index == 0 && *str <= ' ') {
-                        str++; // skip whitespace at start of line
+                    if (line->length == 0 && *str <= ' ') {
+                        line->start++; // skip whitespace at start of line
                     } else {
-                        tmp_line[line_index++] = *str++;
+                        line->length++;
                     }
+                    str++;
                 }
                 if (!*str) {
                     has_more_characters = 0;
@@ -606,6 +619,23 @@ int text_draw_multiline(const uint8_t *str, int x_offset, int y_offset, int box_
                 }
             }
         }
+    }
+    return text_cache_store(start, font, box_width, new_layout);
+}
+
+int text_draw_multiline(const uint8_t *str, int x_offset, int y_offset, int box_width, font_t font, uint32_t color)
+{
+    int line_height = font_definition_for(font)->line_height;
+    if (line_height < 11) {
+        line_height = 11;
+    }
+    const text_layout *layout = get_multiline_layout(str, box_width, font);
+    int y = y_offset;
+    for (int i = 0; i < layout->num_lines; i++) {
+        const text_cache_line *line = &layout->lines[i];
+        int length = line->length < (int) sizeof(tmp_line) ? line->length : (int) sizeof(tmp_line) - 1;
+        memset(tmp_line, 0, sizeof(tmp_line));
+        memcpy(tmp_line, &str[line->start], length);
         text_draw(tmp_line, x_offset, y, font, color);
         y += line_height + 5;
     }
@@ -614,33 +644,5 @@ int text_draw_multiline(const uint8_t *str, int x_offset, int y_offset, int box_
 
 int text_measure_multiline(const uint8_t *str, int box_width, font_t font)
 {
-    int has_more_characters = 1;
-    int guard = 0;
-    int num_lines = 0;
-    while (has_more_characters) {
-        if (++guard >= 100) {
-            break;
-        }
-        int current_width = 0;
-        while (has_more_characters && current_width < box_width) {
-            int word_num_chars;
-            int word_width = get_word_width(str, font, &word_num_chars);
-            current_width += word_width;
-            if (current_width >= box_width) {
-                if (current_width == 0) {
-                    has_more_characters = 0;
-                }
-            } else {
-                str += word_num_chars;
-                if (!*str) {
-                    has_more_characters = 0;
-                } else if (*str == '\n') {
-                    str++;
-                    break;
-                }
-            }
-        }
-        num_lines += 1;
-    }
-    return num_lines;
+    return get_multiline_layout(str, box_width, font)->num_lines;
 }
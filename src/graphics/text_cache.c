@@ -0,0 +1,138 @@
+#include "text_cache.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define CACHE_SETS 64
+#define CACHE_WAYS 4
+
+typedef struct {
+    int in_use;
+    uint64_t hash;
+    int length;
+    int font_key;
+    int box_width;
+    unsigned int last_used;
+    uint8_t *text;
+    int text_capacity;
+    int lines_capacity;
+    text_layout layout;
+} cache_entry;
+
+static struct {
+    cache_entry entries[CACHE_SETS][CACHE_WAYS];
+    unsigned int use_counter;
+    text_cache_line scratch_lines[TEXT_CACHE_MAX_LINES];
+    text_layout scratch;
+} data;
+
+static uint64_t hash_string(const uint8_t *str, int *length)
+{
+    // FNV-1a
+    uint64_t hash = 14695981039346656037ULL;
+    const uint8_t *start = str;
+    while (*str) {
+        hash ^= *str++;
+        hash *= 1099511628211ULL;
+    }
+    *length = (int) (str - start);
+    return hash;
+}
+
+static cache_entry *find_entry(const uint8_t *str, uint64_t hash, int length, int font_key, int box_width)
+{
+    cache_entry *set = data.entries[hash & (CACHE_SETS - 1)];
+    for (int i = 0; i < CACHE_WAYS; i++) {
+        cache_entry *entry = &set[i];
+        // The hash only narrows the search: different strings can share it
+        if (entry->in_use && entry->hash == hash && entry->length == length &&
+            entry->font_key == font_key && entry->box_width == box_width &&
+            memcmp(entry->text, str, length) == 0) {
+            return entry;
+        }
+    }
+    return 0;
+}
+
+static cache_entry *get_free_entry(uint64_t hash)
+{
+    cache_entry *set = data.entries[hash & (CACHE_SETS - 1)];
+    cache_entry *oldest = &set[0];
+    for (int i = 0; i < CACHE_WAYS; i++) {
+        if (!set[i].in_use) {
+            return &set[i];
+        }
+        if (set[i].last_used < oldest->last_used) {
+            oldest = &set[i];
+        }
+    }
+    return oldest;
+}
+
+const text_layout *text_cache_get(const uint8_t *str, int font_key, int box_width)
+{
+    int length;
+    uint64_t hash = hash_string(str, &length);
+    cache_entry *entry = find_entry(str, hash, length, font_key, box_width);
+    if (!entry) {
+        return 0;
+    }
+    entry->last_used = ++data.use_counter;
+    return &entry->layout;
+}
+
+text_layout *text_cache_new_layout(void)
+{
+    data.scratch.width = 0;
+    data.scratch.num_lines = 0;
+    data.scratch.lines = data.scratch_lines;
+    return &data.scratch;
+}
+
+const text_layout *text_cache_store(const uint8_t *str, int font_key, int box_width, const text_layout *layout)
+{
+    int length;
+    uint64_t hash = hash_string(str, &length);
+    cache_entry *entry = find_entry(str, hash, length, font_key, box_width);
+    if (!entry) {
+        entry = get_free_entry(hash);
+    }
+    if (length >= entry->text_capacity) {
+        uint8_t *text = realloc(entry->text, length + 1);
+        if (!text) {
+            return layout;
+        }
+        entry->text = text;
+        entry->text_capacity = length + 1;
+    }
+    if (layout->num_lines > entry->lines_capacity) {
+        text_cache_line *lines = realloc(entry->layout.lines, sizeof(text_cache_line) * layout->num_lines);
+        if (!lines) {
+            return layout;
+        }
+        entry->layout.lines = lines;
+        entry->lines_capacity = layout->num_lines;
+    }
+    if (layout->num_lines) {
+        memcpy(entry->layout.lines, layout->lines, sizeof(text_cache_line) * layout->num_lines);
+    }
+    memcpy(entry->text, str, length + 1);
+    entry->layout.width = layout->width;
+    entry->layout.num_lines = layout->num_lines;
+    entry->in_use = 1;
+    entry->hash = hash;
+    entry->length = length;
+    entry->font_key = font_key;
+    entry->box_width = box_width;
+    entry->last_used = ++data.use_counter;
+    return &entry->layout;
+}
+
+void text_cache_clear(void)
+{
+    for (int set = 0; set < CACHE_SETS; set++) {
+        for (int way = 0; way < CACHE_WAYS; way++) {
+            data.entries[set][way].in_use = 0;
+        }
+    }
+}
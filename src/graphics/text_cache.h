@@ -0,0 +1,62 @@
+#ifndef GRAPHICS_TEXT_CACHE_H
+#define GRAPHICS_TEXT_CACHE_H
+
+#include <stdint.h>
+
+/**
+ * @file
+ * Least recently used cache for measured text: widths and line breaks.
+ * Entries are keyed by the string contents, a font key and the box width,
+ * so strings can be safely cached even when they live in reused buffers.
+ */
+
+#define TEXT_CACHE_MAX_LINES 1000
+
+typedef struct {
+    int start; /**< Offset of the first byte of the line in the source string */
+    int length; /**< Number of bytes in the line */
+    int x_offset; /**< Horizontal offset of the line, for indented paragraphs */
+    int image_id; /**< Image found at the end of the line, 0 if none */
+    int has_text_before_image; /**< Whether the line had text before the image */
+} text_cache_line;
+
+typedef struct {
+    int width;
+    int num_lines;
+    text_cache_line *lines;
+} text_layout;
+
+/**
+ * Gets a cached layout
+ * @param str String that was measured
+ * @param font_key Font or font combination that was used to measure
+ * @param box_width Box width that was used to measure, or -1 for single line measurements
+ * @return The cached layout, or 0 if the string is not in the cache.
+ *         The layout is only valid until the next call to text_cache_store.
+ */
+const text_layout *text_cache_get(const uint8_t *str, int font_key, int box_width);
+
+/**
+ * Gets an empty scratch layout to measure a string into, which can hold up to TEXT_CACHE_MAX_LINES lines.
+ * The layout is only valid until the next call to text_cache_new_layout.
+ * @return Empty layout
+ */
+text_layout *text_cache_new_layout(void);
+
+/**
+ * Stores a layout in the cache, evicting the least recently used entry if needed
+ * @param str String that was measured
+ * @param font_key Font or font combination that was used to measure
+ * @param box_width Box width that was used to measure, or -1 for single line measurements
+ * @param layout The measured layout
+ * @return The cached copy of the layout, or the passed layout if it could not be cached.
+ *         The layout is only valid until the next call to text_cache_store.
+ */
+const text_layout *text_cache_store(const uint8_t *str, int font_key, int box_width, const text_layout *layout);
+
+/**
+ * Clears the cache. Should be called when fonts change.
+ */
+void text_cache_clear(void);
+
+#endif // GRAPHICS_TEXT_CACHE_H
@@ -9,20 +9,39 @@
 #include "game/system.h"
 #include "graphics/renderer.h"
 #include "graphics/screen.h"
+#include "graphics/video_convert.h"
+#include "platform/thread.h"
 #include "sound/device.h"
 #include "sound/music.h"
 #include "sound/speech.h"
 
 #include "pl_mpeg/pl_mpeg.h"
 
+#include <stdlib.h>
 #include <string.h>
 
+#define FRAME_QUEUE_SIZE 4
+
 typedef enum {
     VIDEO_TYPE_NONE = 0,
     VIDEO_TYPE_SMK = 1,
     VIDEO_TYPE_MPG = 2
 } video_type;
 
+typedef struct {
+    int is_end;
+    int has_video;
+    color_t *pixels;
+    struct {
+        uint8_t *data;
+        int width;
+        int size;
+    } planes[3];
+    uint8_t *audio;
+    int audio_size;
+    int audio_capacity;
+} video_frame;
+
 static struct {
     int is_playing;
     int is_ended;
@@ -40,7 +59,6 @@ static struct {
         time_millis start_render_millis;
         int current_frame;
         int draw_frame;
-        plm_frame_t *mpg_frame;
     } video;
     struct {
         int has_audio;
@@ -51,12 +69,57 @@ static struct {
     struct {
         color_t *pixels;
         int width;
+        int is_yuv;
     } buffer;
+    struct {
+        video_frame frames[FRAME_QUEUE_SIZE];
+        video_frame *current;
+        int first;
+        int count;
+        int held;
+        int decoded;
+        int stop;
+        platform_thread *thread;
+        platform_mutex *lock;
+        platform_condition *changed;
+    } queue;
     int restart_music;
 } data;
 
+static void stop_decoder_thread(void)
+{
+    if (!data.queue.thread) {
+        return;
+    }
+    platform_mutex_lock(data.queue.lock);
+    data.queue.stop = 1;
+    platform_condition_broadcast(data.queue.changed);
+    platform_mutex_unlock(data.queue.lock);
+    platform_thread_wait(data.queue.thread);
+    data.queue.thread = 0;
+    platform_condition_destroy(data.queue.changed);
+    data.queue.changed = 0;
+    platform_mutex_destroy(data.queue.lock);
+    data.queue.lock = 0;
+}
+
+static void free_frames(void)
+{
+    for (int i = 0; i < FRAME_QUEUE_SIZE; i++) {
+        video_frame *frame = &data.queue.frames[i];
+        free(frame->pixels);
+        for (int p = 0; p < 3; p++) {
+            free(frame->planes[p].data);
+        }
+        free(frame->audio);
+    }
+    memset(&data.queue, 0, sizeof(data.queue));
+}
+
 static void close_decoder(void)
 {
+    stop_decoder_thread();
+    free_frames();
     if (data.s) {
         smacker_close(data.s);
         data.s = 0;
@@ -69,15 +132,54 @@ static void close_decoder(void)
     data.type = VIDEO_TYPE_NONE;
 }
 
-static void update_mpg_video(plm_t *plm, plm_frame_t *frame, void *user)
+static void copy_plane(video_frame *frame, int plane, const plm_plane_t *source)
+{
+    int size = source->width * source->height;
+    if (frame->planes[plane].size < size) {
+        uint8_t *plane_data = realloc(frame->planes[plane].data, size);
+        if (!plane_data) {
+            return;
+        }
+        frame->planes[plane].data = plane_data;
+        frame->planes[plane].size = size;
+    }
+    memcpy(frame->planes[plane].data, source->data, size);
+    frame->planes[plane].width = source->width;
+}
+
+static void update_mpg_video(plm_t *plm, plm_frame_t *mpg_frame, void *user)
 {
-	data.video.draw_frame = 1;
-    data.video.mpg_frame = frame;
+    video_frame *frame = data.queue.current;
+    if (data.buffer.is_yuv) {
+        copy_plane(frame, 0, &mpg_frame->y);
+        copy_plane(frame, 1, &mpg_frame->cb);
+        copy_plane(frame, 2, &mpg_frame->cr);
+        frame->has_video = frame->planes[0].data && frame->planes[1].data && frame->planes[2].data;
+    } else if (frame->pixels) {
+        video_convert_yuv_frame(mpg_frame->y.data, mpg_frame->y.width, mpg_frame->cb.data, mpg_frame->cr.data,
+            mpg_frame->cb.width, mpg_frame->width, mpg_frame->height, frame->pixels, data.video.width);
+        frame->has_video = 1;
+    }
+}
+
+static void add_frame_audio(video_frame *frame, const void *audio, int size)
+{
+    if (frame->audio_size + size > frame->audio_capacity) {
+        int capacity = 2 * (frame->audio_size + size);
+        uint8_t *audio_data = realloc(frame->audio, capacity);
+        if (!audio_data) {
+            return;
+        }
+        frame->audio = audio_data;
+        frame->audio_capacity = capacity;
+    }
+    memcpy(&frame->audio[frame->audio_size], audio, size);
+    frame->audio_size += size;
 }
 
 static void update_mpg_audio(plm_t *mpeg, plm_samples_t *samples, void *user)
 {
-    sound_device_write_custom_music_data(samples->interleaved, sizeof(float) * samples->count * 2);
+    add_frame_audio(data.queue.current, samples->interleaved, sizeof(float) * samples->count * 2);
 }
 
 static int load_mpg(const char *filename)
@@ -111,8 +213,8 @@ static int load_mpg(const char *filename)
 
     data.audio.has_audio = 0;
 
-	plm_set_video_decode_callback(data.plm, update_mpg_video, 0);
-	
+    plm_set_video_decode_callback(data.plm, update_mpg_video, 0);
+
     if (config_get(CONFIG_GENERAL_ENABLE_VIDEO_SOUND) && plm_get_num_audio_streams(data.plm) > 0) {
         plm_set_audio_enabled(data.plm, 1);
         plm_set_audio_stream(data.plm, 0);
@@ -176,6 +278,140 @@ static int load_smk(const char *filename)
     return 1;
 }
 
+static void decode_smk_frame(video_frame *frame)
+{
+    if (data.queue.decoded > 0) {
+        if (smacker_next_frame(data.s) != SMACKER_FRAME_OK) {
+            frame->is_end = 1;
+            return;
+        }
+        // The audio of the first frame is passed to the music player by video_init()
+        if (data.audio.has_audio) {
+            int audio_len = smacker_get_frame_audio_size(data.s, 0);
+            if (audio_len > 0) {
+                add_frame_audio(frame, smacker_get_frame_audio(data.s, 0), audio_len);
+            }
+        }
+    }
+    const uint8_t *video = smacker_get_frame_video(data.s);
+    const color_t *pal = smacker_get_frame_palette(data.s);
+    if (video && pal && frame->pixels) {
+        video_convert_palette_frame(video, data.video.width, data.video.height,
+            data.video.y_scale != SMACKER_Y_SCALE_NONE, pal, frame->pixels, data.video.width);
+        frame->has_video = 1;
+    }
+}
+
+static void decode_mpg_frame(video_frame *frame)
+{
+    data.queue.current = frame;
+    plm_decode(data.plm, 1.0 / plm_get_framerate(data.plm));
+    data.queue.current = 0;
+    if (plm_has_ended(data.plm)) {
+        frame->is_end = 1;
+    }
+}
+
+static void decode_frame(video_frame *frame)
+{
+    frame->is_end = 0;
+    frame->has_video = 0;
+    frame->audio_size = 0;
+    if (data.type == VIDEO_TYPE_SMK) {
+        decode_smk_frame(frame);
+    } else {
+        decode_mpg_frame(frame);
+    }
+    data.queue.decoded++;
+}
+
+static int run_decoder(void *unused)
+{
+    platform_mutex_lock(data.queue.lock);
+    while (!data.queue.stop) {
+        if (data.queue.count == FRAME_QUEUE_SIZE) {
+            platform_condition_wait(data.queue.changed, data.queue.lock);
+            continue;
+        }
+        video_frame *frame = &data.queue.frames[(data.queue.first + data.queue.count) % FRAME_QUEUE_SIZE];
+        platform_mutex_unlock(data.queue.lock);
+
+        decode_frame(frame);
+
+        platform_mutex_lock(data.queue.lock);
+        data.queue.count++;
+        if (frame->is_end) {
+            break;
+        }
+    }
+    platform_mutex_unlock(data.queue.lock);
+    return 0;
+}
+
+static void start_decoder_thread(void)
+{
+    if (platform_thread_cpu_count() <= 1) {
+        // Without a second core, a thread only adds overhead: frames are decoded when they are needed
+        return;
+    }
+    data.queue.lock = platform_mutex_create();
+    data.queue.changed = platform_condition_create();
+    if (data.queue.lock && data.queue.changed) {
+        data.queue.thread = platform_thread_create(run_decoder, "video decoder", 0);
+    }
+    if (!data.queue.thread) {
+        if (data.queue.changed) {
+            platform_condition_destroy(data.queue.changed);
+            data.queue.changed = 0;
+        }
+        if (data.queue.lock) {
+            platform_mutex_destroy(data.queue.lock);
+            data.queue.lock = 0;
+        }
+    }
+}
+
+static video_frame *take_frame(void)
+{
+    if (data.queue.thread) {
+        platform_mutex_lock(data.queue.lock);
+    } else if (data.queue.count == data.queue.held) {
+        decode_frame(&data.queue.frames[(data.queue.first + data.queue.count) % FRAME_QUEUE_SIZE]);
+        data.queue.count++;
+    }
+    video_frame *frame = 0;
+    if (data.queue.count > data.queue.held) {
+        frame = &data.queue.frames[(data.queue.first + data.queue.held) % FRAME_QUEUE_SIZE];
+        if (data.queue.held) {
+            data.queue.first = (data.queue.first + 1) % FRAME_QUEUE_SIZE;
+            data.queue.count--;
+        }
+        data.queue.held = 1;
+    }
+    if (data.queue.thread) {
+        platform_condition_broadcast(data.queue.changed);
+        platform_mutex_unlock(data.queue.lock);
+    }
+    return frame;
+}
+
+static void release_frame(void)
+{
+    if (!data.queue.held) {
+        return;
+    }
+    if (data.queue.thread) {
+        platform_mutex_lock(data.queue.lock);
+    }
+    data.queue.first = (data.queue.first + 1) % FRAME_QUEUE_SIZE;
+    data.queue.count--;
+    data.queue.held = 0;
+    if (data.queue.thread) {
+        platform_condition_broadcast(data.queue.changed);
+        platform_mutex_unlock(data.queue.lock);
+    }
+}
+
 static void end_video(void)
 {
     sound_device_use_default_music_player();
@@ -196,8 +432,12 @@ int video_start(const char *filename)
         sound_speech_stop();
         int is_yuv = data.type == VIDEO_TYPE_MPG && graphics_renderer()->supports_yuv_image_format();
         graphics_renderer()->create_custom_image(CUSTOM_IMAGE_VIDEO, data.video.width, data.video.height, is_yuv);
+        data.buffer.is_yuv = is_yuv;
         if (!is_yuv) {
             data.buffer.pixels = graphics_renderer()->get_custom_image_buffer(CUSTOM_IMAGE_VIDEO, &data.buffer.width);
+            for (int i = 0; i < FRAME_QUEUE_SIZE; i++) {
+                data.queue.frames[i].pixels = malloc(sizeof(color_t) * data.video.width * data.video.height);
+            }
         }
         data.is_playing = 1;
         return 1;
@@ -233,6 +473,9 @@ void video_init(int restart_music)
                 audio_data, audio_len);
         }
     }
+    if (!data.queue.thread && !data.queue.decoded) {
+        start_decoder_thread();
+    }
 }
 
 int video_is_finished(void)
@@ -266,70 +509,48 @@ static void get_next_frame(void)
         return;
     }
     time_millis now_millis = time_get_millis();
+    int frame_no = (now_millis - data.video.start_render_millis) * 1000 / data.video.micros_per_frame;
 
-    if (data.type == VIDEO_TYPE_SMK) {
-        int frame_no = (now_millis - data.video.start_render_millis) * 1000 / data.video.micros_per_frame;
-        data.video.draw_frame = data.video.current_frame == 0;
-        while (frame_no > data.video.current_frame) {
-            if (smacker_next_frame(data.s) != SMACKER_FRAME_OK) {
-                close_decoder();
-                data.is_ended = 1;
-                data.is_playing = 0;
-                end_video();
-                return;
-            }
-            data.video.current_frame++;
-            data.video.draw_frame = 1;
-
-            if (data.audio.has_audio) {
-                int audio_len = smacker_get_frame_audio_size(data.s, 0);
-                const void *audio_data = smacker_get_frame_audio(data.s, 0);
-                if (audio_len > 0) {
-                    sound_device_write_custom_music_data(audio_data, audio_len);
-                }
-            }
+    // Never wait for the decoder: when it falls behind, the last frame stays on screen
+    while (frame_no >= data.video.current_frame) {
+        video_frame *frame = take_frame();
+        if (!frame) {
+            break;
         }
-    } else {
-        plm_decode(data.plm, (now_millis - data.video.start_render_millis + 1) / 1000.0);
-        data.video.start_render_millis = now_millis;
-        if (plm_has_ended(data.plm)) {
+        if (frame->is_end) {
             close_decoder();
             data.is_ended = 1;
             data.is_playing = 0;
+            data.video.draw_frame = 0;
             end_video();
+            return;
+        }
+        data.video.current_frame++;
+        data.video.draw_frame = frame->has_video;
+        if (data.audio.has_audio && frame->audio_size > 0) {
+            sound_device_write_custom_music_data(frame->audio, frame->audio_size);
         }
     }
 }
 
 static void update_video_frame(void)
 {
-    if (data.type == VIDEO_TYPE_NONE) {
+    if (data.type == VIDEO_TYPE_NONE || !data.queue.held) {
         return;
     }
-    if (data.type == VIDEO_TYPE_SMK) {
-        const unsigned char *frame = smacker_get_frame_video(data.s);
-        const uint32_t *pal = smacker_get_frame_palette(data.s);
-        if (frame && pal) {
-            for (int y = 0; y < data.video.height; y++) {
-                color_t *pixel = &data.buffer.pixels[y * data.buffer.width];
-                int video_y = data.video.y_scale == SMACKER_Y_SCALE_NONE ? y : y / 2;
-                const unsigned char *line = frame + (video_y * data.video.width);
-                for (int x = 0; x < data.video.width; x++) {
-                    *pixel = ALPHA_OPAQUE | pal[line[x]];
-                    ++pixel;
-                }
-            }
-        }
-    } else if (data.type == VIDEO_TYPE_MPG) {
-        if (graphics_renderer()->supports_yuv_image_format()) {
-            plm_frame_t *frame = data.video.mpg_frame;
-            graphics_renderer()->update_custom_image_yuv(CUSTOM_IMAGE_VIDEO, frame->y.data, frame->y.width,
-                frame->cb.data, frame->cb.width, frame->cr.data, frame->cr.width);
-            return;
+    const video_frame *frame = &data.queue.frames[data.queue.first];
+    if (data.buffer.is_yuv) {
+        graphics_renderer()->update_custom_image_yuv(CUSTOM_IMAGE_VIDEO,
+            frame->planes[0].data, frame->planes[0].width, frame->planes[1].data, frame->planes[1].width,
+            frame->planes[2].data, frame->planes[2].width);
+    } else {
+        for (int y = 0; y < data.video.height; y++) {
+            memcpy(&data.buffer.pixels[y * data.buffer.width], &frame->pixels[y * data.video.width],
+                sizeof(color_t) * data.video.width);
         }
-        plm_frame_to_bgra(data.video.mpg_frame, (uint8_t *) data.buffer.pixels, data.buffer.width * 4);
+        graphics_renderer()->update_custom_image(CUSTOM_IMAGE_VIDEO);
     }
-    graphics_renderer()->update_custom_image(CUSTOM_IMAGE_VIDEO);
+    release_frame();
 }
 
 void video_draw(int x_offset, int y_offset)
@@ -352,6 +573,7 @@ void video_draw_fullscreen(void)
     get_next_frame();
     if (data.video.draw_frame) {
         update_video_frame();
+        data.video.draw_frame = 0;
     }
 
     int s_width = screen_width();
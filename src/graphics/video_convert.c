@@ -0,0 +1,152 @@
+#include "video_convert.h"
+
+#include <string.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define USE_SSE2
+#include <emmintrin.h>
+#endif
+
+#define PALETTE_SIZE 256
+
+static uint8_t clamp_color(int value)
+{
+    if (value < 0) {
+        return 0;
+    }
+    return value > 255 ? 255 : (uint8_t) value;
+}
+
+void video_convert_palette_frame(const uint8_t *frame, int width, int height, int double_lines,
+    const color_t *palette, color_t *dest, int dest_width)
+{
+    color_t opaque_palette[PALETTE_SIZE];
+    for (int i = 0; i < PALETTE_SIZE; i++) {
+        opaque_palette[i] = ALPHA_OPAQUE | palette[i];
+    }
+    for (int y = 0; y < height; y++) {
+        color_t *pixel = &dest[y * dest_width];
+        if (double_lines && (y & 1)) {
+            memcpy(pixel, pixel - dest_width, width * sizeof(color_t));
+            continue;
+        }
+        const uint8_t *line = &frame[(double_lines ? y / 2 : y) * width];
+        int x = 0;
+        for (; x + 4 <= width; x += 4) {
+            pixel[x] = opaque_palette[line[x]];
+            pixel[x + 1] = opaque_palette[line[x + 1]];
+            pixel[x + 2] = opaque_palette[line[x + 2]];
+            pixel[x + 3] = opaque_palette[line[x + 3]];
+        }
+        for (; x < width; x++) {
+            pixel[x] = opaque_palette[line[x]];
+        }
+    }
+}
+
+static void convert_yuv_pixels(const uint8_t *y_line, const uint8_t *cb_line, const uint8_t *cr_line,
+    color_t *dest_line, int start, int end)
+{
+    for (int col = start; col < end; col++) {
+        int cr = cr_line[col] - 128;
+        int cb = cb_line[col] - 128;
+        int r = (cr * 104597) >> 16;
+        int g = (cb * 25674 + cr * 53278) >> 16;
+        int b = (cb * 132201) >> 16;
+        for (int i = 0; i < 2; i++) {
+            int y = ((y_line[2 * col + i] - 16) * 76309) >> 16;
+            dest_line[2 * col + i] = ALPHA_OPAQUE |
+                (clamp_color(y + r) << 16) | (clamp_color(y - g) << 8) | clamp_color(y + b);
+        }
+    }
+}
+
+#ifdef USE_SSE2
+/**
+ * Converts 16 luma values of one line, using the chroma terms of 8 chroma samples.
+ * The fixed point factors of the scalar code are split into a whole part and a 16 bit
+ * fraction, so that every result is bit for bit the same as the scalar result.
+ */
+static void convert_yuv_line_sse2(const uint8_t *y_line, __m128i r_lo, __m128i r_hi,
+    __m128i g_lo, __m128i g_hi, __m128i b_lo, __m128i b_hi, color_t *dest)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i y_offset = _mm_set1_epi16(16);
+    const __m128i y_fraction = _mm_set1_epi16(10773);
+    const __m128i alpha = _mm_set1_epi8((char) 0xff);
+
+    __m128i luma = _mm_loadu_si128((const __m128i *) y_line);
+    __m128i y_lo = _mm_sub_epi16(_mm_unpacklo_epi8(luma, zero), y_offset);
+    __m128i y_hi = _mm_sub_epi16(_mm_unpackhi_epi8(luma, zero), y_offset);
+    y_lo = _mm_add_epi16(y_lo, _mm_mulhi_epi16(y_lo, y_fraction));
+    y_hi = _mm_add_epi16(y_hi, _mm_mulhi_epi16(y_hi, y_fraction));
+
+    __m128i r = _mm_packus_epi16(_mm_add_epi16(y_lo, r_lo), _mm_add_epi16(y_hi, r_hi));
+    __m128i g = _mm_packus_epi16(_mm_sub_epi16(y_lo, g_lo), _mm_sub_epi16(y_hi, g_hi));
+    __m128i b = _mm_packus_epi16(_mm_add_epi16(y_lo, b_lo), _mm_add_epi16(y_hi, b_hi));
+
+    __m128i bg_lo = _mm_unpacklo_epi8(b, g);
+    __m128i bg_hi = _mm_unpackhi_epi8(b, g);
+    __m128i ra_lo = _mm_unpacklo_epi8(r, alpha);
+    __m128i ra_hi = _mm_unpackhi_epi8(r, alpha);
+    _mm_storeu_si128((__m128i *) dest, _mm_unpacklo_epi16(bg_lo, ra_lo));
+    _mm_storeu_si128((__m128i *) (dest + 4), _mm_unpackhi_epi16(bg_lo, ra_lo));
+    _mm_storeu_si128((__m128i *) (dest + 8), _mm_unpacklo_epi16(bg_hi, ra_hi));
+    _mm_storeu_si128((__m128i *) (dest + 12), _mm_unpackhi_epi16(bg_hi, ra_hi));
+}
+
+static int convert_yuv_lines_sse2(const uint8_t *y_line, int y_stride, const uint8_t *cb_line,
+    const uint8_t *cr_line, color_t *dest_line, int dest_width, int cols)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i c_offset = _mm_set1_epi16(128);
+    const __m128i r_fraction = _mm_set1_epi16(-26475);
+    const __m128i b_fraction = _mm_set1_epi16(1129);
+    const __m128i g_factors = _mm_set_epi16(-12258, 25674, -12258, 25674, -12258, 25674, -12258, 25674);
+
+    int col = 0;
+    for (; col + 8 <= cols; col += 8) {
+        __m128i cb = _mm_sub_epi16(_mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *) &cb_line[col]), zero),
+            c_offset);
+        __m128i cr = _mm_sub_epi16(_mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *) &cr_line[col]), zero),
+            c_offset);
+
+        __m128i r = _mm_add_epi16(_mm_add_epi16(cr, cr), _mm_mulhi_epi16(cr, r_fraction));
+        __m128i b = _mm_add_epi16(_mm_add_epi16(cb, cb), _mm_mulhi_epi16(cb, b_fraction));
+        __m128i g_part_lo = _mm_srai_epi32(_mm_madd_epi16(_mm_unpacklo_epi16(cb, cr), g_factors), 16);
+        __m128i g_part_hi = _mm_srai_epi32(_mm_madd_epi16(_mm_unpackhi_epi16(cb, cr), g_factors), 16);
+        __m128i g = _mm_add_epi16(cr, _mm_packs_epi32(g_part_lo, g_part_hi));
+
+        __m128i r_lo = _mm_unpacklo_epi16(r, r);
+        __m128i r_hi = _mm_unpackhi_epi16(r, r);
+        __m128i g_lo = _mm_unpacklo_epi16(g, g);
+        __m128i g_hi = _mm_unpackhi_epi16(g, g);
+        __m128i b_lo = _mm_unpacklo_epi16(b, b);
+        __m128i b_hi = _mm_unpackhi_epi16(b, b);
+
+        convert_yuv_line_sse2(&y_line[2 * col], r_lo, r_hi, g_lo, g_hi, b_lo, b_hi, &dest_line[2 * col]);
+        convert_yuv_line_sse2(&y_line[y_stride + 2 * col], r_lo, r_hi, g_lo, g_hi, b_lo, b_hi,
+            &dest_line[dest_width + 2 * col]);
+    }
+    return col;
+}
+#endif
+
+void video_convert_yuv_frame(const uint8_t *y, int y_stride, const uint8_t *cb, const uint8_t *cr, int c_stride,
+    int width, int height, color_t *dest, int dest_width)
+{
+    int cols = width >> 1;
+    int rows = height >> 1;
+    for (int row = 0; row < rows; row++) {
+        const uint8_t *y_line = &y[row * 2 * y_stride];
+        const uint8_t *cb_line = &cb[row * c_stride];
+        const uint8_t *cr_line = &cr[row * c_stride];
+        color_t *dest_line = &dest[row * 2 * dest_width];
+        int col = 0;
+#ifdef USE_SSE2
+        col = convert_yuv_lines_sse2(y_line, y_stride, cb_line, cr_line, dest_line, dest_width, cols);
+#endif
+        convert_yuv_pixels(y_line, cb_line, cr_line, dest_line, col, cols);
+        convert_yuv_pixels(y_line + y_stride, cb_line, cr_line, dest_line + dest_width, col, cols);
+    }
+}
@@ -0,0 +1,43 @@
+#ifndef GRAPHICS_VIDEO_CONVERT_H
+#define GRAPHICS_VIDEO_CONVERT_H
+
+#include "graphics/color.h"
+
+#include <stdint.h>
+
+/**
+ * @file
+ * Conversion of decoded video frames to the pixel format of the renderer.
+ * The YUV conversion uses SSE2 when available and produces exactly the same
+ * pixels as the scalar code on every platform.
+ */
+
+/**
+ * Converts a palette based frame to opaque pixels
+ * @param frame Frame data, one palette index per pixel
+ * @param width Frame width
+ * @param height Frame height
+ * @param double_lines Whether every frame line should be drawn twice
+ * @param palette Palette of 256 colors
+ * @param dest Destination pixels
+ * @param dest_width Width of a destination line in pixels
+ */
+void video_convert_palette_frame(const uint8_t *frame, int width, int height, int double_lines,
+    const color_t *palette, color_t *dest, int dest_width);
+
+/**
+ * Converts a YCbCr 4:2:0 frame to opaque pixels, using the BT.601 coefficients of pl_mpeg
+ * @param y Luma plane
+ * @param y_stride Width of a luma line in bytes
+ * @param cb Blue chroma plane
+ * @param cr Red chroma plane
+ * @param c_stride Width of a chroma line in bytes
+ * @param width Frame width
+ * @param height Frame height
+ * @param dest Destination pixels
+ * @param dest_width Width of a destination line in pixels
+ */
+void video_convert_yuv_frame(const uint8_t *y, int y_stride, const uint8_t *cb, const uint8_t *cr, int c_stride,
+    int width, int height, color_t *dest, int dest_width);
+
+#endif // GRAPHICS_VIDEO_CONVERT_H
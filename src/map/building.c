@@ -4,10 +4,44 @@
 #include "core/config.h"
 #include "map/grid.h"
 
+#define SERVICE_AREA_RADIUS 2
+#define SERVICE_AREA_POOL_SIZE 65536
+
 static grid_u16 buildings_grid;
 static grid_u8 damage_grid;
 static grid_u8 rubble_type_grid;
 
+static struct {
+    grid_u32 generation;
+    grid_u32 start;
+    grid_u8 count;
+    uint32_t current_generation;
+    uint16_t pool[SERVICE_AREA_POOL_SIZE];
+    int pool_size;
+} service_area = { .current_generation = 1 };
+
+static void invalidate_all_service_areas(void)
+{
+    service_area.current_generation++;
+    if (!service_area.current_generation) {
+        map_grid_clear_u32(service_area.generation.items);
+        service_area.current_generation = 1;
+    }
+    service_area.pool_size = 0;
+}
+
+static void invalidate_service_areas_around(int grid_offset)
+{
+    int x_min, y_min, x_max, y_max;
+    map_grid_get_area(map_grid_offset_to_x(grid_offset), map_grid_offset_to_y(grid_offset), 1,
+        SERVICE_AREA_RADIUS, &x_min, &y_min, &x_max, &y_max);
+    for (int yy = y_min; yy <= y_max; yy++) {
+        for (int xx = x_min; xx <= x_max; xx++) {
+            service_area.generation.items[map_grid_offset(xx, yy)] = 0;
+        }
+    }
+}
+
 int map_building_at(int grid_offset)
 {
     return map_grid_is_valid_offset(grid_offset) ? buildings_grid.items[grid_offset] : 0;
@@ -21,7 +55,37 @@ int map_building_from_buffer(buffer *buildings, int grid_offset)
 
 void map_building_set(int grid_offset, int building_id)
 {
-    buildings_grid.items[grid_offset] = building_id;
+    if (buildings_grid.items[grid_offset] != building_id) {
+        buildings_grid.items[grid_offset] = building_id;
+        invalidate_service_areas_around(grid_offset);
+    }
+}
+
+int map_building_service_area(int x, int y, const uint16_t **building_ids)
+{
+    int grid_offset = map_grid_offset(x, y);
+    if (service_area.generation.items[grid_offset] != service_area.current_generation) {
+        if (service_area.pool_size + (2 * SERVICE_AREA_RADIUS + 1) * (2 * SERVICE_AREA_RADIUS + 1) >
+            SERVICE_AREA_POOL_SIZE) {
+            invalidate_all_service_areas();
+        }
+        int x_min, y_min, x_max, y_max;
+        map_grid_get_area(x, y, 1, SERVICE_AREA_RADIUS, &x_min, &y_min, &x_max, &y_max);
+        int start = service_area.pool_size;
+        for (int yy = y_min; yy <= y_max; yy++) {
+            for (int xx = x_min; xx <= x_max; xx++) {
+                int building_id = buildings_grid.items[map_grid_offset(xx, yy)];
+                if (building_id) {
+                    service_area.pool[service_area.pool_size++] = building_id;
+                }
+            }
+        }
+        service_area.start.items[grid_offset] = start;
+        service_area.count.items[grid_offset] = service_area.pool_size - start;
+        service_area.generation.items[grid_offset] = service_area.current_generation;
+    }
+    *building_ids = &service_area.pool[service_area.start.items[grid_offset]];
+    return service_area.count.items[grid_offset];
 }
 
 void map_building_damage_clear(int grid_offset)
@@ -49,6 +113,7 @@ void map_building_clear(void)
     map_grid_clear_u16(buildings_grid.items);
     map_grid_clear_u8(damage_grid.items);
     map_grid_clear_u8(rubble_type_grid.items);
+    invalidate_all_service_areas();
 }
 
 void map_building_save_state(buffer *buildings, buffer *damage)
@@ -61,6 +126,7 @@ void map_building_load_state(buffer *buildings, buffer *damage)
 {
     map_grid_load_state_u16(buildings_grid.items, buildings);
     map_grid_load_state_u8(damage_grid.items, damage);
+    invalidate_all_service_areas();
 }
 
 int map_building_is_reservoir(int x, int y)
@@ -4,6 +4,8 @@
 #include "building/type.h"
 #include "core/buffer.h"
 
+#include <stdint.h>
+
 /**
  * Returns the building at the given offset
  * @param grid_offset Map offset
@@ -15,6 +17,17 @@ int map_building_from_buffer(buffer *buildings, int grid_offset);
 
 void map_building_set(int grid_offset, int building_id);
 
+/**
+ * Gets the buildings within two tiles of the given tile, which is the area that walkers provide their services to.
+ * A building is listed once for every tile it occupies in the area, in row order, just like a scan of the area would find it.
+ * The list is cached per tile until a building is added or removed nearby.
+ * @param x X of the tile
+ * @param y Y of the tile
+ * @param building_ids Gets the building ids. The list is only valid until the next call.
+ * @return The number of building tiles in the area
+ */
+int map_building_service_area(int x, int y, const uint16_t **building_ids);
+
 /**
  * Increases building damage by 1
  * @param grid_offset Map offset
@@ -4,21 +4,59 @@
 #include "building/model.h"
 #include "building/monument.h"
 #include "core/calc.h"
+#include "core/job.h"
+#include "core/log.h"
 #include "map/data.h"
 #include "map/grid.h"
 #include "map/property.h"
 #include "map/ring.h"
 #include "map/terrain.h"
 
+#include <stdlib.h>
+
+#define MAX_RANGE 6
+#define MIN_ROWS_PER_BAND 8
+
+typedef struct {
+    int min_y;
+    int max_y;
+} row_band;
+
+typedef struct {
+    int x;
+    int y;
+    int size;
+    int value;
+    int step;
+    int step_size;
+    int range;
+} desirability_source;
+
 static grid_i8 desirability_grid;
 
+static struct {
+    desirability_source *sources;
+    int num_sources;
+    int capacity;
+    int *band_sources;
+    int band_sources_capacity;
+    int band_start[JOB_MAX_CHUNKS + 1];
+    int num_rows;
+    int num_bands;
+    int out_of_memory;
+} data;
+
 void map_desirability_clear(void)
 {
     map_grid_clear_i8(desirability_grid.items);
 }
 
-static void add_desirability_at_distance(int x, int y, int size, int distance, int desirability)
+static void add_desirability_at_distance(int x, int y, int size, int distance, int desirability,
+    const row_band *band)
 {
+    if (y - distance > band->max_y || y + distance + size - 1 < band->min_y) {
+        return;
+    }
     int partially_outside_map = 0;
     if (x - distance < -1 || x + distance + size - 1 > map_data.width) {
         partially_outside_map = 1;
@@ -26,6 +64,10 @@ static void add_desirability_at_distance(int x, int y, int size, int distance, i
     if (y - distance < -1 || y + distance + size - 1 > map_data.height) {
         partially_outside_map = 1;
     }
+    // tiles of other bands are handled by their own job
+    if (y - distance < band->min_y || y + distance + size - 1 > band->max_y) {
+        partially_outside_map = 1;
+    }
     int base_offset = map_grid_offset(x, y);
     int start = map_ring_start(size, distance);
     int end = map_ring_end(size, distance);
@@ -33,7 +75,8 @@ static void add_desirability_at_distance(int x, int y, int size, int distance, i
     if (partially_outside_map) {
         for (int i = start; i < end; i++) {
             const ring_tile *tile = map_ring_tile(i);
-            if (map_ring_is_inside_map(x + tile->x, y + tile->y)) {
+            int tile_y = y + tile->y;
+            if (tile_y >= band->min_y && tile_y <= band->max_y && map_ring_is_inside_map(x + tile->x, tile_y)) {
                 desirability_grid.items[base_offset + tile->grid_offset] =
                     calc_bound(desirability_grid.items[base_offset + tile->grid_offset] + desirability, -100, 100);
             }
@@ -47,28 +90,37 @@ static void add_desirability_at_distance(int x, int y, int size, int distance, i
     }
 }
 
-static void add_to_terrain(int x, int y, int size, int desirability, int step, int step_size, int range)
+static void add_to_terrain(const desirability_source *source, const row_band *band)
 {
-    if (size > 0) {
-        if (range > 6) {
-            range = 6;
-        }
-        int tiles_within_step = 0;
-        int distance = 1;
-        while (range > 0) {
-            add_desirability_at_distance(x, y, size, distance, desirability);
-            distance++;
-            range--;
-            tiles_within_step++;
-            if (tiles_within_step >= step) {
-                desirability += step_size;
-                tiles_within_step = 0;
-            }
+    int desirability = source->value;
+    int range = source->range;
+    int tiles_within_step = 0;
+    int distance = 1;
+    while (range > 0) {
+        add_desirability_at_distance(source->x, source->y, source->size, distance, desirability, band);
+        distance++;
+        range--;
+        tiles_within_step++;
+        if (tiles_within_step >= source->step) {
+            desirability += source->step_size;
+            tiles_within_step = 0;
         }
     }
 }
 
-static void update_buildings(void)
+static void visit_source(int x, int y, int size, int value, int step, int step_size, int range,
+    void (*visit)(const desirability_source *source))
+{
+    if (size <= 0 || range <= 0) {
+        return;
+    }
+    desirability_source source = {
+        x, y, size, value, step, step_size, range > MAX_RANGE ? MAX_RANGE : range
+    };
+    visit(&source);
+}
+
+static void visit_buildings(void (*visit)(const desirability_source *source))
 {
     int value;
     int value_bonus;
@@ -77,7 +129,8 @@ static void update_buildings(void)
     int range;
     int venus_module2 = building_monument_gt_module_is_active(VENUS_MODULE_2_DESIRABILITY_ENTERTAINMENT);
     int venus_gt = building_monument_working(BUILDING_GRAND_TEMPLE_VENUS);
-    for (int i = 1; i < building_count(); i++) {
+    for (int i = building_index_next(BUILDING_INDEX_DESIRABILITY, 0); i;
+        i = building_index_next(BUILDING_INDEX_DESIRABILITY, i)) {
         building *b = building_get(i);
         if (b->state == BUILDING_STATE_IN_USE) {
 
@@ -117,66 +170,166 @@ static void update_buildings(void)
                 range += 1;
             }
 
-            add_to_terrain(
-                b->x, b->y, b->size,
-                value,
-                step,
-                step_size,
-                range);
+            visit_source(b->x, b->y, b->size, value, step, step_size, range, visit);
+        }
+    }
+}
+
+static void clear_invalid_plaza_flags(void)
+{
+    int grid_offset = map_data.start_offset;
+    for (int y = 0; y < map_data.height; y++, grid_offset += map_data.border_size) {
+        for (int x = 0; x < map_data.width; x++, grid_offset++) {
+            if (map_property_is_plaza_or_earthquake(grid_offset) &&
+                !map_terrain_is(grid_offset, TERRAIN_ROAD | TERRAIN_ROCK)) {
+                map_property_clear_plaza_or_earthquake(grid_offset);
+            }
         }
     }
 }
 
-static void update_terrain(void)
+static void visit_terrain(void (*visit)(const desirability_source *source))
 {
     int grid_offset = map_data.start_offset;
     for (int y = 0; y < map_data.height; y++, grid_offset += map_data.border_size) {
         for (int x = 0; x < map_data.width; x++, grid_offset++) {
             int terrain = map_terrain_get(grid_offset);
+            const model_building *model = 0;
             if (map_property_is_plaza_or_earthquake(grid_offset)) {
-                int type;
                 if (terrain & TERRAIN_ROAD) {
-                    type = BUILDING_PLAZA;
+                    model = model_get_building(BUILDING_PLAZA);
                 } else if (terrain & TERRAIN_ROCK) {
                     // earthquake fault line: slight negative
-                    type = BUILDING_HOUSE_VACANT_LOT;
+                    model = model_get_building(BUILDING_HOUSE_VACANT_LOT);
                 } else {
-                    // invalid plaza/earthquake flag
-                    map_property_clear_plaza_or_earthquake(grid_offset);
+                    // invalid plaza/earthquake flag, cleared by clear_invalid_plaza_flags
                     continue;
                 }
-                const model_building *model = model_get_building(type);
-                add_to_terrain(x, y, 1,
-                    model->desirability_value,
-                    model->desirability_step,
-                    model->desirability_step_size,
-                    model->desirability_range);
             } else if (terrain & TERRAIN_GARDEN) {
-                const model_building *model = model_get_building(BUILDING_GARDENS);
-                add_to_terrain(x, y, 1,
-                    model->desirability_value,
-                    model->desirability_step,
-                    model->desirability_step_size,
-                    model->desirability_range);
+                model = model_get_building(BUILDING_GARDENS);
             } else if (terrain & TERRAIN_RUBBLE) {
-                add_to_terrain(x, y, 1, -2, 1, 1, 2);
+                visit_source(x, y, 1, -2, 1, 1, 2, visit);
             } else if (terrain & TERRAIN_HIGHWAY) {
-                const model_building *model = model_get_building(BUILDING_HIGHWAY);
-                add_to_terrain(x, y, 1,
-                    model->desirability_value,
-                    model->desirability_step,
-                    model->desirability_step_size,
-                    model->desirability_range);
+                model = model_get_building(BUILDING_HIGHWAY);
+            }
+            if (model) {
+                visit_source(x, y, 1, model->desirability_value, model->desirability_step,
+                    model->desirability_step_size, model->desirability_range, visit);
             }
         }
     }
 }
 
+static void visit_all_sources(void (*visit)(const desirability_source *source))
+{
+    visit_buildings(visit);
+    visit_terrain(visit);
+}
+
+static void add_to_all_rows(const desirability_source *source)
+{
+    row_band band = { -1, map_data.height };
+    add_to_terrain(source, &band);
+}
+
+static void add_source(const desirability_source *source)
+{
+    if (data.out_of_memory) {
+        return;
+    }
+    if (data.num_sources >= data.capacity) {
+        int capacity = data.capacity ? data.capacity * 2 : 256;
+        desirability_source *sources = realloc(data.sources, sizeof(desirability_source) * capacity);
+        if (!sources) {
+            data.out_of_memory = 1;
+            return;
+        }
+        data.sources = sources;
+        data.capacity = capacity;
+    }
+    data.sources[data.num_sources++] = *source;
+}
+
+static int band_of_row(int row)
+{
+    // inverse of the chunk boundaries used by job_parallel_for
+    row = calc_bound(row + 1, 0, data.num_rows - 1);
+    return ((row + 1) * data.num_bands - 1) / data.num_rows;
+}
+
+static void get_source_bands(const desirability_source *source, int *first, int *last)
+{
+    *first = band_of_row(source->y - source->range);
+    *last = band_of_row(source->y + source->size - 1 + source->range);
+}
+
+static int assign_sources_to_bands(void)
+{
+    int counts[JOB_MAX_CHUNKS] = { 0 };
+    int total = 0;
+    for (int i = 0; i < data.num_sources; i++) {
+        int first, last;
+        get_source_bands(&data.sources[i], &first, &last);
+        for (int band = first; band <= last; band++) {
+            counts[band]++;
+        }
+        total += last - first + 1;
+    }
+    if (total > data.band_sources_capacity) {
+        int *band_sources = realloc(data.band_sources, sizeof(int) * total);
+        if (!band_sources) {
+            return 0;
+        }
+        data.band_sources = band_sources;
+        data.band_sources_capacity = total;
+    }
+    data.band_start[0] = 0;
+    for (int band = 0; band < data.num_bands; band++) {
+        data.band_start[band + 1] = data.band_start[band] + counts[band];
+        counts[band] = data.band_start[band];
+    }
+    // sources are added in order, so every band applies them in the same order as a single pass would
+    for (int i = 0; i < data.num_sources; i++) {
+        int first, last;
+        get_source_bands(&data.sources[i], &first, &last);
+        for (int band = first; band <= last; band++) {
+            data.band_sources[counts[band]++] = i;
+        }
+    }
+    return 1;
+}
+
+static void update_band(int chunk, int start, int end, void *unused)
+{
+    // bands cover the rows from -1 to map height, as desirability also spreads to the map edge
+    row_band band = { start - 1, end - 2 };
+    for (int i = data.band_start[chunk]; i < data.band_start[chunk + 1]; i++) {
+        add_to_terrain(&data.sources[data.band_sources[i]], &band);
+    }
+}
+
 void map_desirability_update(void)
 {
     map_desirability_clear();
-    update_buildings();
-    update_terrain();
+    clear_invalid_plaza_flags();
+
+    data.num_sources = 0;
+    data.out_of_memory = 0;
+    visit_all_sources(add_source);
+
+    // a single thread applies all sources in one band, so that no source is visited more than once
+    data.num_rows = map_data.height + 2;
+    int rows_per_band = job_system_num_threads() > 1 ? MIN_ROWS_PER_BAND : data.num_rows;
+    data.num_bands = job_parallel_for_num_chunks(data.num_rows, rows_per_band);
+
+    if (data.out_of_memory || !assign_sources_to_bands()) {
+        log_error("Out of memory for the desirability sources, updating desirability without them", 0, 0);
+        visit_all_sources(add_to_all_rows);
+        return;
+    }
+    // every band applies its sources in the same order as a single pass would, but only to its own rows,
+    // so the result does not depend on how the rows are split
+    job_parallel_for(data.num_rows, rows_per_band, update_band, 0);
 }
 
 int map_desirability_get(int grid_offset)
@@ -1,9 +1,41 @@
 #include "figure.h"
 
+#include "core/calc.h"
+#include "map/data.h"
 #include "map/grid.h"
 
+#include <string.h>
+
+#define BLOCK_SHIFT 3
+#define BLOCK_SIZE (1 << BLOCK_SHIFT)
+#define BLOCKS_PER_ROW ((GRID_SIZE + BLOCK_SIZE - 1) / BLOCK_SIZE)
+
 static grid_u16 figures;
 
+static struct {
+    uint16_t figures[BLOCKS_PER_ROW * BLOCKS_PER_ROW];
+    int valid;
+} blocks;
+
+static int block_for_offset(int grid_offset)
+{
+    int x = grid_offset % GRID_SIZE;
+    int y = grid_offset / GRID_SIZE;
+    return (y >> BLOCK_SHIFT) * BLOCKS_PER_ROW + (x >> BLOCK_SHIFT);
+}
+
+static void count_blocks(void)
+{
+    memset(blocks.figures, 0, sizeof(blocks.figures));
+    for (int grid_offset = 0; grid_offset < GRID_SIZE * GRID_SIZE; grid_offset++) {
+        for (int figure_id = figures.items[grid_offset]; figure_id;
+            figure_id = figure_get(figure_id)->next_figure_id_on_same_tile) {
+            blocks.figures[block_for_offset(grid_offset)]++;
+        }
+    }
+    blocks.valid = 1;
+}
+
 int map_has_figure_at(int grid_offset)
 {
     return map_grid_is_valid_offset(grid_offset) && figures.items[grid_offset] > 0;
@@ -41,6 +73,9 @@ void map_figure_add(figure *f)
     } else {
         figures.items[f->grid_offset] = f->id;
     }
+    if (blocks.valid) {
+        blocks.figures[block_for_offset(f->grid_offset)]++;
+    }
 }
 
 void map_figure_update(figure *f)
@@ -68,6 +103,7 @@ void map_figure_delete(figure *f)
         f->next_figure_id_on_same_tile = 0;
         return;
     }
+    int removed = 1;
     if (figures.items[f->grid_offset] == f->id) {
         figures.items[f->grid_offset] = f->next_figure_id_on_same_tile;
     } else {
@@ -75,9 +111,13 @@ void map_figure_delete(figure *f)
         while (prev->id && prev->next_figure_id_on_same_tile != f->id) {
             prev = figure_get(prev->next_figure_id_on_same_tile);
         }
+        removed = prev->id != 0;
         prev->next_figure_id_on_same_tile = f->next_figure_id_on_same_tile;
     }
     f->next_figure_id_on_same_tile = 0;
+    if (blocks.valid && removed) {
+        blocks.figures[block_for_offset(f->grid_offset)]--;
+    }
 }
 
 int map_figure_foreach_until(int grid_offset, int (*callback)(figure *f))
@@ -96,9 +136,140 @@ int map_figure_foreach_until(int grid_offset, int (*callback)(figure *f))
     return 0;
 }
 
+static int visit_block(int block_x, int block_y, int x, int y, int max_distance,
+    int (*callback)(figure *f, int distance))
+{
+    if (!blocks.figures[block_y * BLOCKS_PER_ROW + block_x]) {
+        return 0;
+    }
+    int grid_x = map_data.start_offset % GRID_SIZE;
+    int grid_y = map_data.start_offset / GRID_SIZE;
+    int x_min = block_x << BLOCK_SHIFT;
+    int y_min = block_y << BLOCK_SHIFT;
+    int x_max = calc_bound(x_min + BLOCK_SIZE, 0, GRID_SIZE);
+    int y_max = calc_bound(y_min + BLOCK_SIZE, 0, GRID_SIZE);
+    for (int tile_y = y_min; tile_y < y_max; tile_y++) {
+        for (int tile_x = x_min; tile_x < x_max; tile_x++) {
+            int figure_id = figures.items[tile_y * GRID_SIZE + tile_x];
+            if (!figure_id || calc_maximum_distance(x, y, tile_x - grid_x, tile_y - grid_y) > max_distance) {
+                continue;
+            }
+            while (figure_id) {
+                figure *f = figure_get(figure_id);
+                int next_figure_id = f->next_figure_id_on_same_tile;
+                int result = callback(f, calc_maximum_distance(x, y, f->x, f->y));
+                if (result) {
+                    return result;
+                }
+                figure_id = next_figure_id;
+            }
+        }
+    }
+    return 0;
+}
+
+/**
+ * Visits the blocks around the tile ring by ring, so that closer figures are visited first.
+ * Stops when a callback returns non-zero, or when the rings get further away than what
+ * the max_distance callback allows.
+ */
+static int visit_rings(int x, int y, int (*max_distance)(void), int (*callback)(figure *f, int distance))
+{
+    if (!blocks.valid) {
+        count_blocks();
+    }
+    int center_x = calc_bound(map_data.start_offset % GRID_SIZE + x, 0, GRID_SIZE - 1) >> BLOCK_SHIFT;
+    int center_y = calc_bound(map_data.start_offset / GRID_SIZE + y, 0, GRID_SIZE - 1) >> BLOCK_SHIFT;
+    for (int ring = 0; ring < BLOCKS_PER_ROW; ring++) {
+        int distance = max_distance();
+        if (ring && ((ring - 1) << BLOCK_SHIFT) + 1 > distance) {
+            break;
+        }
+        for (int block_y = center_y - ring; block_y <= center_y + ring; block_y++) {
+            if (block_y < 0 || block_y >= BLOCKS_PER_ROW) {
+                continue;
+            }
+            int step = (block_y == center_y - ring || block_y == center_y + ring) ? 1 : 2 * ring;
+            for (int block_x = center_x - ring; block_x <= center_x + ring; block_x += step) {
+                if (block_x < 0 || block_x >= BLOCKS_PER_ROW) {
+                    continue;
+                }
+                int result = visit_block(block_x, block_y, x, y, max_distance(), callback);
+                if (result) {
+                    return result;
+                }
+            }
+        }
+    }
+    return 0;
+}
+
+static struct {
+    int (*get_score)(figure *f, int distance);
+    int limit;
+    int best_id;
+    int best_score;
+} nearest;
+
+static int nearest_max_distance(void)
+{
+    return nearest.best_id ? nearest.best_score : nearest.limit - 1;
+}
+
+static int check_nearest(figure *f, int distance)
+{
+    int score = nearest.get_score(f, distance);
+    if (score < 0) {
+        return 0;
+    }
+    if (nearest.best_id) {
+        if (score < nearest.best_score || (score == nearest.best_score && f->id < nearest.best_id)) {
+            nearest.best_id = f->id;
+            nearest.best_score = score;
+        }
+    } else if (score < nearest.limit) {
+        nearest.best_id = f->id;
+        nearest.best_score = score;
+    }
+    return 0;
+}
+
+int map_figure_find_nearest(int x, int y, int limit, int (*get_score)(figure *f, int distance))
+{
+    nearest.get_score = get_score;
+    nearest.limit = limit;
+    nearest.best_id = 0;
+    nearest.best_score = limit;
+    visit_rings(x, y, nearest_max_distance, check_nearest);
+    return nearest.best_id;
+}
+
+static struct {
+    int radius;
+    int (*callback)(figure *f);
+} area;
+
+static int area_max_distance(void)
+{
+    return area.radius;
+}
+
+static int check_area(figure *f, int distance)
+{
+    return distance <= area.radius ? area.callback(f) : 0;
+}
+
+int map_figure_foreach_in_area_until(int x, int y, int radius, int (*callback)(figure *f))
+{
+    area.radius = radius;
+    area.callback = callback;
+    return visit_rings(x, y, area_max_distance, check_area);
+}
+
 void map_figure_clear(void)
 {
     map_grid_clear_u16(figures.items);
+    blocks.valid = 0;
 }
 
 void map_figure_save_state(buffer *buf)
@@ -109,4 +280,5 @@ void map_figure_save_state(buffer *buf)
 void map_figure_load_state(buffer *buf)
 {
     map_grid_load_state_u16(figures.items, buf);
+    blocks.valid = 0;
 }
@@ -26,6 +26,31 @@ void map_figure_delete(figure *f);
 
 int map_figure_foreach_until(int grid_offset, int (*callback)(figure *f));
 
+/**
+ * Finds the figure with the lowest score around a tile. Nearby figures are visited first,
+ * and the search stops once no figure further away can have a lower score.
+ * Ties are resolved in favour of the figure with the lowest id.
+ * Only figures linked into the figure grid are found, and the order in which the callback is called
+ * differs from the figure order, so the callback must not have side effects.
+ * @param x X tile to search from
+ * @param y Y tile to search from
+ * @param limit Only figures with a score below this limit are returned
+ * @param get_score Callback that returns the score of a figure given its distance to the tile,
+ *        or -1 to skip the figure. The score may never be lower than the distance.
+ * @return Figure ID of the figure with the lowest score, or 0 if none was found
+ */
+int map_figure_find_nearest(int x, int y, int limit, int (*get_score)(figure *f, int distance));
+
+/**
+ * Calls the callback for all figures within a radius around a tile, until the callback returns non-zero
+ * @param x X tile
+ * @param y Y tile
+ * @param radius Maximum distance of the figures to the tile
+ * @param callback Callback to call for each figure
+ * @return The first non-zero value returned by the callback, or 0
+ */
+int map_figure_foreach_in_area_until(int x, int y, int radius, int (*callback)(figure *f));
+
 /**
  * Clears the map
  */
@@ -2,12 +2,19 @@
 
 #include "map/data.h"
 
+#include <stdlib.h>
 #include <string.h>
 
 #define OFFSET(x,y) (x + GRID_SIZE * y)
 
 struct map_data_t map_data;
 
+static struct {
+    int grid_size;
+    int x_shift;
+    int y_shift;
+} saved_layout = { GRID_SIZE, 0, 0 };
+
 static const int DIRECTION_DELTA[] = {
     -OFFSET(0,1), OFFSET(1,-1), 1, OFFSET(1,1), OFFSET(0,1), OFFSET(-1,1), -1, -OFFSET(1,1)
 };
@@ -225,6 +232,11 @@ void map_grid_clear_i16(int16_t *grid)
     memset(grid, 0, GRID_SIZE * GRID_SIZE * sizeof(int16_t));
 }
 
+void map_grid_clear_i32(int32_t *grid)
+{
+    memset(grid, 0, GRID_SIZE * GRID_SIZE * sizeof(int32_t));
+}
+
 void map_grid_init_i8(int8_t *grid, int8_t value)
 {
     memset(grid, value, GRID_SIZE * GRID_SIZE * sizeof(int8_t));
@@ -271,23 +283,17 @@ void map_grid_save_state_i8(const int8_t *grid, buffer *buf)
 
 void map_grid_save_state_u16(const uint16_t *grid, buffer *buf)
 {
-    for (int i = 0; i < GRID_SIZE * GRID_SIZE; i++) {
-        buffer_write_u16(buf, grid[i]);
-    }
+    buffer_write_u16_array(buf, grid, GRID_SIZE * GRID_SIZE);
 }
 
 void map_grid_save_state_u32_to_u16(const uint32_t *grid, buffer *buf)
 {
-    for (int i = 0; i < GRID_SIZE * GRID_SIZE; i++) {
-        buffer_write_u16(buf, (uint16_t) grid[i]);
-    }
+    buffer_write_u32_array_as_u16(buf, grid, GRID_SIZE * GRID_SIZE);
 }
 
 void map_grid_save_state_u32(const uint32_t *grid, buffer *buf)
 {
-    for (int i = 0; i < GRID_SIZE * GRID_SIZE; i++) {
-        buffer_write_u32(buf, grid[i]);
-    }
+    buffer_write_u32_array(buf, grid, GRID_SIZE * GRID_SIZE);
 }
 
 void map_grid_load_state_u8(uint8_t *grid, buffer *buf)
@@ -302,21 +308,80 @@ void map_grid_load_state_i8(int8_t *grid, buffer *buf)
 
 void map_grid_load_state_u16(uint16_t *grid, buffer *buf)
 {
-    for (int i = 0; i < GRID_SIZE * GRID_SIZE; i++) {
-        grid[i] = buffer_read_u16(buf);
-    }
+    buffer_read_u16_array(buf, grid, GRID_SIZE * GRID_SIZE);
 }
 
 void map_grid_load_state_u16_to_u32(uint32_t *grid, buffer *buf)
 {
-    for (int i = 0; i < GRID_SIZE * GRID_SIZE; i++) {
-        grid[i] = buffer_read_u16(buf);
-    }
+    buffer_read_u16_array_as_u32(buf, grid, GRID_SIZE * GRID_SIZE);
 }
 
 void map_grid_load_state_u32(uint32_t *grid, buffer *buf)
 {
-    for (int i = 0; i < GRID_SIZE * GRID_SIZE; i++) {
-        grid[i] = buffer_read_u32(buf);
+    buffer_read_u32_array(buf, grid, GRID_SIZE * GRID_SIZE);
+}
+
+void map_grid_set_saved_layout(int grid_size, int start_offset, int width, int height)
+{
+    saved_layout.grid_size = grid_size;
+    if (grid_size == GRID_SIZE) {
+        saved_layout.x_shift = 0;
+        saved_layout.y_shift = 0;
+    } else {
+        int new_start_offset = map_grid_centered_start_offset(width, height);
+        saved_layout.x_shift = new_start_offset % GRID_SIZE - start_offset % grid_size;
+        saved_layout.y_shift = new_start_offset / GRID_SIZE - start_offset / grid_size;
+    }
+}
+
+int map_grid_centered_start_offset(int width, int height)
+{
+    return (GRID_SIZE - height) / 2 * GRID_SIZE + (GRID_SIZE - width) / 2;
+}
+
+int map_grid_saved_layout_differs(void)
+{
+    return saved_layout.grid_size != GRID_SIZE || saved_layout.x_shift || saved_layout.y_shift;
+}
+
+int map_grid_offset_from_saved(int grid_offset)
+{
+    if (grid_offset <= 0 || !map_grid_saved_layout_differs()) {
+        return grid_offset;
+    }
+    int x = grid_offset % saved_layout.grid_size + saved_layout.x_shift;
+    int y = grid_offset / saved_layout.grid_size + saved_layout.y_shift;
+    if (x < 0 || x >= GRID_SIZE || y < 0 || y >= GRID_SIZE) {
+        return 0;
+    }
+    return x + y * GRID_SIZE;
+}
+
+int map_grid_convert_saved_buffer(buffer *buf)
+{
+    int saved_size = saved_layout.grid_size;
+    int element_size = buf->size / (saved_size * saved_size);
+    int size = GRID_SIZE * GRID_SIZE * element_size;
+    uint8_t *data = malloc(size);
+    if (!data) {
+        return 0;
+    }
+    memset(data, 0, size);
+
+    int x_start = saved_layout.x_shift < 0 ? -saved_layout.x_shift : 0;
+    int x_end = saved_size;
+    if (x_end + saved_layout.x_shift > GRID_SIZE) {
+        x_end = GRID_SIZE - saved_layout.x_shift;
+    }
+    for (int y = 0; y < saved_size && x_start < x_end; y++) {
+        int new_y = y + saved_layout.y_shift;
+        if (new_y < 0 || new_y >= GRID_SIZE) {
+            continue;
+        }
+        memcpy(&data[(new_y * GRID_SIZE + x_start + saved_layout.x_shift) * element_size],
+            &buf->data[(y * saved_size + x_start) * element_size], (x_end - x_start) * element_size);
     }
+    free(buf->data);
+    buffer_init(buf, data, size);
+    return 1;
 }
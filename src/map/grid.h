@@ -5,10 +5,30 @@
 
 #include <stdint.h>
 
+#ifndef MAP_GRID_SIZE
+#define MAP_GRID_SIZE 162
+#endif
+
+#if MAP_GRID_SIZE < 162 || MAP_GRID_SIZE > 512
+#error "MAP_GRID_SIZE must be between 162 and 512"
+#endif
+
 enum {
-    GRID_SIZE = 162
+    GRID_SIZE = MAP_GRID_SIZE,
+    LEGACY_GRID_SIZE = 162
 };
 
+/**
+ * Scales a number of tiles that was tuned for the legacy grid to the area of the current grid
+ */
+#define MAP_GRID_SCALE_TILES(tiles) \
+    ((int) ((int64_t) (tiles) * GRID_SIZE * GRID_SIZE / (LEGACY_GRID_SIZE * LEGACY_GRID_SIZE)))
+
+/**
+ * Scales a distance in tiles that was tuned for the legacy grid to the width of the current grid
+ */
+#define MAP_GRID_SCALE_DISTANCE(tiles) ((tiles) * GRID_SIZE / LEGACY_GRID_SIZE)
+
 typedef struct {
     uint8_t items[GRID_SIZE * GRID_SIZE];
 } grid_u8;
@@ -29,6 +49,10 @@ typedef struct {
     uint32_t items[GRID_SIZE * GRID_SIZE];
 } grid_u32;
 
+typedef struct {
+    int32_t items[GRID_SIZE * GRID_SIZE];
+} grid_i32;
+
 void map_grid_init(int width, int height, int start_offset, int border_size);
 
 int map_grid_is_valid_offset(int grid_offset);
@@ -81,6 +105,8 @@ void map_grid_clear_i16(int16_t *grid);
 
 void map_grid_clear_u32(uint32_t *grid);
 
+void map_grid_clear_i32(int32_t *grid);
+
 void map_grid_init_i8(int8_t *grid, int8_t value);
 
 void map_grid_and_u8(uint8_t *grid, uint8_t mask);
@@ -114,4 +140,43 @@ void map_grid_load_state_u16_to_u32(uint32_t *grid, buffer *buf);
 
 void map_grid_load_state_u32(uint32_t *grid, buffer *buf);
 
+/**
+ * Sets the layout of the grid the map being loaded was saved with, so saved grids and grid offsets
+ * can be converted when it differs from the current grid
+ * @param grid_size Size of the saved grid
+ * @param start_offset Offset of the first map tile in the saved grid
+ * @param width Map width
+ * @param height Map height
+ */
+void map_grid_set_saved_layout(int grid_size, int start_offset, int width, int height);
+
+/**
+ * Gets the offset of the first tile of a map centered in the current grid
+ * @param width Map width
+ * @param height Map height
+ * @return Grid offset of the map's first tile
+ */
+int map_grid_centered_start_offset(int width, int height);
+
+/**
+ * Checks whether the map being loaded was saved with a grid layout different from the current one
+ * @return True if saved grids and grid offsets need to be converted
+ */
+int map_grid_saved_layout_differs(void);
+
+/**
+ * Converts a grid offset saved with the saved layout to the current grid
+ * @param grid_offset Saved grid offset. Offsets of zero or less are returned as-is.
+ * @return Grid offset in the current grid, or 0 if the tile falls outside of it
+ */
+int map_grid_offset_from_saved(int grid_offset);
+
+/**
+ * Converts a saved grid buffer to the current grid, moving every tile so it keeps its map coordinates
+ * @param buf Buffer holding a full saved grid. Its data must be allocated with malloc,
+ *            as it is replaced with a newly allocated block of the current grid's size.
+ * @return 1 on success, 0 if out of memory
+ */
+int map_grid_convert_saved_buffer(buffer *buf);
+
 #endif // MAP_GRID_H
@@ -40,6 +40,7 @@ void map_image_restore_at(int grid_offset)
 void map_image_clear(void)
 {
     map_grid_clear_u32(images.items);
+    map_tiles_reset_changed_terrain_images();
 }
 
 void map_image_init_edges(void)
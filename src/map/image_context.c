@@ -291,6 +291,8 @@ static struct {
     {terrain_images_aqueduct, 16}
 };
 
+static image_context_variant variant_mode = IMAGE_CONTEXT_VARIANT_NEXT;
+
 static void clear_current_offset(struct terrain_image_context *items, int num_items)
 {
     for (int i = 0; i < num_items; i++) {
@@ -305,6 +307,11 @@ void map_image_context_init(void)
     }
 }
 
+void map_image_context_set_variant(image_context_variant variant)
+{
+    variant_mode = variant;
+}
+
 void map_image_context_reset_water(void)
 {
     clear_current_offset(context_pointers[CONTEXT_WATER].context, context_pointers[CONTEXT_WATER].size);
@@ -334,13 +341,20 @@ static const terrain_image *get_image(int group, int tiles[MAX_TILES])
     int size = context_pointers[group].size;
     for (int i = 0; i < size; i++) {
         if (context_matches_tiles(&context[i], tiles)) {
-            context[i].current_item_offset++;
-            if (context[i].current_item_offset >= context[i].max_item_offset) {
-                context[i].current_item_offset = 0;
+            if (variant_mode == IMAGE_CONTEXT_VARIANT_NEXT) {
+                context[i].current_item_offset++;
+                if (context[i].current_item_offset >= context[i].max_item_offset) {
+                    context[i].current_item_offset = 0;
+                }
+                result.item_offset = context[i].current_item_offset;
+            } else if (variant_mode == IMAGE_CONTEXT_VARIANT_LAST && context[i].max_item_offset > 0) {
+                // fixed variants do not advance the round-robin offset
+                result.item_offset = context[i].max_item_offset - 1;
+            } else {
+                result.item_offset = 0;
             }
             result.is_valid = 1;
             result.group_offset = context[i].offset_for_orientation[city_view_orientation() / 2];
-            result.item_offset = context[i].current_item_offset;
             result.aqueduct_offset = context[i].aqueduct_offset;
             break;
         }
@@ -8,7 +8,14 @@ typedef struct {
     int aqueduct_offset;
 } terrain_image;
 
+typedef enum {
+    IMAGE_CONTEXT_VARIANT_NEXT,
+    IMAGE_CONTEXT_VARIANT_FIRST,
+    IMAGE_CONTEXT_VARIANT_LAST
+} image_context_variant;
+
 void map_image_context_init(void);
+void map_image_context_set_variant(image_context_variant variant);
 void map_image_context_reset_water(void);
 void map_image_context_reset_elevation(void);
 
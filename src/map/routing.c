@@ -1,7 +1,8 @@
 #include "routing.h"
 
 #include "building/building.h"
-#include "core/time.h"
+#include "core/trace.h"
+#include "game/tick.h"
 #include "map/building.h"
 #include "map/figure.h"
 #include "map/grid.h"
@@ -13,7 +14,7 @@
 #include <stdlib.h>
 
 #define MAX_QUEUE GRID_SIZE * GRID_SIZE
-#define GUARD 50000
+#define GUARD MAP_GRID_SCALE_TILES(50000)
 
 #define UNTIL_STOP 0
 #define UNTIL_CONTINUE 1
@@ -23,7 +24,9 @@ typedef enum {
     DIRECTIONS_DIAGONALS = 8
 } max_directions;
 
-static const int ROUTE_OFFSETS[] = { -162, 1, 162, -1, -161, 163, 161, -163 };
+static const int ROUTE_OFFSETS[] = {
+    -GRID_SIZE, 1, GRID_SIZE, -1, -GRID_SIZE + 1, GRID_SIZE + 1, GRID_SIZE - 1, -GRID_SIZE - 1
+};
 static const int ROUTE_OFFSETS_X[] = { 0, 1, 0, -1,  1, 1, -1, -1 };
 static const int ROUTE_OFFSETS_Y[] = { -1, 0, 1,  0, -1, 1,  1, -1 };
 static const int HIGHWAY_DIRECTIONS[] = { 
@@ -54,7 +57,7 @@ static grid_u8 water_drag;
 
 static struct {
     grid_u8 status;
-    time_millis last_check;
+    unsigned int last_check;
 } fighting_data;
 
 static struct {
@@ -64,10 +67,10 @@ static struct {
 
 static void reset_fighting_status(void)
 {
-    time_millis current_time = time_get_millis();
-    if (current_time != fighting_data.last_check) {
+    unsigned int current_tick = game_tick_id();
+    if (current_tick != fighting_data.last_check) {
         map_grid_clear_u8(fighting_data.status.items);
-        fighting_data.last_check = current_time;
+        fighting_data.last_check = current_tick;
     }
 }
 
@@ -79,8 +82,8 @@ const map_routing_distance_grid *map_routing_get_distance_grid(void)
 static void clear_data(void)
 {
     reset_fighting_status();
-    map_grid_clear_i16(distance.possible.items);
-    map_grid_clear_i16(distance.determined.items);
+    map_grid_clear_i32(distance.possible.items);
+    map_grid_clear_i32(distance.determined.items);
     queue.head = 0;
     queue.tail = 0;
 }
@@ -123,7 +126,7 @@ void ordered_queue_reorder(int start_index)
     }
     int right_child = left_child + 1;
     int smallest = start_index;
-    int16_t *offset_smallest = &distance.possible.items[queue.items[smallest]];
+    int32_t *offset_smallest = &distance.possible.items[queue.items[smallest]];
     if (distance.possible.items[queue.items[left_child]] < *offset_smallest) {
         smallest = left_child;
         offset_smallest = &distance.possible.items[queue.items[smallest]];
@@ -202,6 +205,7 @@ static int receive_highway_bonus(int offset, int direction)
 static void route_queue_from_to(int src_x, int src_y, int dst_x, int dst_y, int num_directions, int max_tiles,
     int (*callback)(int offset, int next_offset, int direction))
 {
+    TRACE_BEGIN("route to destination");
     clear_data();
     distance.dst_x = dst_x;
     distance.dst_y = dst_y;
@@ -228,10 +232,12 @@ static void route_queue_from_to(int src_x, int src_y, int dst_x, int dst_y, int
             }
         }
     }
+    TRACE_END();
 }
 
 static void route_queue_all_from(int source, max_directions directions, int (*callback)(int next_offset, int dist, int direction), int is_boat, int step_size)
 {
+    TRACE_BEGIN("route distances");
     clear_data();
     map_grid_clear_u8(water_drag.items);
     enqueue(source, 1);
@@ -261,6 +267,7 @@ static void route_queue_all_from(int source, max_directions directions, int (*ca
             }
         }
     }
+    TRACE_END();
 }
 
 static int callback_calc_distance(int next_offset, int dist, int direction)
@@ -697,7 +704,8 @@ void map_routing_block(int x, int y, int size)
 
 int map_routing_distance(int grid_offset)
 {
-    return distance.determined.items[grid_offset];
+    int dist = distance.determined.items[grid_offset];
+    return dist > INT16_MAX ? INT16_MAX : dist;
 }
 
 void map_routing_save_state(buffer *buf)
@@ -13,8 +13,8 @@ typedef enum {
 } routed_building_type;
 
 typedef struct map_routing_distance_grid {
-    grid_i16 possible;
-    grid_i16 determined;
+    grid_i32 possible;
+    grid_i32 determined;
     int dst_x;
     int dst_y;
 } map_routing_distance_grid;
@@ -29,6 +29,11 @@ int map_routing_calculate_distances_for_building(routed_building_type type, int
 
 void map_routing_delete_first_wall_or_aqueduct(int x, int y);
 
+/**
+ * Gets the distance of a tile from the start of the last route calculation
+ * @param grid_offset Tile
+ * @return Distance, 0 when the tile cannot be reached. Capped at INT16_MAX so that it fits in building fields.
+ */
 int map_routing_distance(int grid_offset);
 
 int map_routing_citizen_can_travel_over_land(int src_x, int src_y, int dst_x, int dst_y, int num_directions);
@@ -7,9 +7,10 @@
 #include "map/routing.h"
 #include "map/terrain.h"
 
-#define MAX_PATH 500
+// Routing distances from this value on are too far away for a path
+#define MAX_DISTANCE MAP_GRID_SCALE_DISTANCE(998)
 
-static int direction_path[MAX_PATH];
+static int direction_path[MAP_ROUTING_PATH_MAX_LENGTH];
 
 static void adjust_tile_in_direction(int direction, int *x, int *y, int *grid_offset)
 {
@@ -90,7 +91,7 @@ int map_routing_get_path(uint8_t *path, int src_x, int src_y, int dst_x, int dst
 {
     int dst_grid_offset = map_grid_offset(dst_x, dst_y);
     int distance = map_routing_distance(dst_grid_offset);
-    if (distance <= 0 || distance >= 998) {
+    if (distance <= 0 || distance >= MAX_DISTANCE) {
         return 0;
     }
 
@@ -125,7 +126,7 @@ int map_routing_get_path(uint8_t *path, int src_x, int src_y, int dst_x, int dst
         int forward_direction = (direction + 4) % 8;
         direction_path[num_tiles++] = forward_direction;
         last_direction = forward_direction;
-        if (num_tiles >= MAX_PATH) {
+        if (num_tiles >= MAP_ROUTING_PATH_MAX_LENGTH) {
             return 0;
         }
     }
@@ -140,7 +141,7 @@ int map_routing_get_path_on_water(uint8_t *path, int dst_x, int dst_y, int is_fl
     int rand = random_byte() & 3;
     int dst_grid_offset = map_grid_offset(dst_x, dst_y);
     int distance = map_routing_distance(dst_grid_offset);
-    if (distance <= 0 || distance >= 998) {
+    if (distance <= 0 || distance >= MAX_DISTANCE) {
         return 0;
     }
 
@@ -179,7 +180,7 @@ int map_routing_get_path_on_water(uint8_t *path, int dst_x, int dst_y, int is_fl
         int forward_direction = (direction + 4) % 8;
         direction_path[num_tiles++] = forward_direction;
         last_direction = forward_direction;
-        if (num_tiles >= MAX_PATH) {
+        if (num_tiles >= MAP_ROUTING_PATH_MAX_LENGTH) {
             return 0;
         }
     }
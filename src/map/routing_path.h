@@ -1,8 +1,15 @@
 #ifndef MAP_ROUTING_PATH_H
 #define MAP_ROUTING_PATH_H
 
+#include "map/grid.h"
+
 #include <stdint.h>
 
+/**
+ * Maximum number of tiles in a path. Routes across larger grids get longer, so it grows with the grid width.
+ */
+#define MAP_ROUTING_PATH_MAX_LENGTH MAP_GRID_SCALE_DISTANCE(500)
+
 int map_routing_get_path(uint8_t *path, int src_x, int src_y, int dst_x, int dst_y, int num_directions);
 
 int map_routing_get_path_on_water(uint8_t *path, int dst_x, int dst_y, int is_flotsam);
@@ -13,6 +13,15 @@
 #include "map/sprite.h"
 #include "map/terrain.h"
 
+#define CHANGE_BLOCK_SIZE 8
+#define CHANGE_BLOCKS_PER_ROW ((GRID_SIZE + CHANGE_BLOCK_SIZE - 1) / CHANGE_BLOCK_SIZE)
+
+static struct {
+    grid_u32 signature;
+    unsigned int version;
+    unsigned int block_version[CHANGE_BLOCKS_PER_ROW * CHANGE_BLOCKS_PER_ROW];
+} citizen_changes;
+
 static void map_routing_update_land_noncitizen(void);
 
 void map_routing_update_all(void)
@@ -118,9 +127,35 @@ static int get_land_type_citizen_aqueduct(int grid_offset)
     }
 }
 
+static int change_block_index(int grid_offset)
+{
+    return (grid_offset / GRID_SIZE / CHANGE_BLOCK_SIZE) * CHANGE_BLOCKS_PER_ROW +
+        (grid_offset % GRID_SIZE) / CHANGE_BLOCK_SIZE;
+}
+
+static void track_citizen_change(int grid_offset, int *has_changes)
+{
+    // everything roaming figures look at: passability, road terrain and the building on the tile
+    int terrain = map_terrain_get(grid_offset);
+    uint32_t signature = (terrain_land_citizen.items[grid_offset] + 8) |
+        ((terrain & (TERRAIN_ROAD | TERRAIN_ACCESS_RAMP)) ? 0x10 : 0);
+    if (terrain & (TERRAIN_BUILDING | TERRAIN_GATEHOUSE)) {
+        signature |= map_building_at(grid_offset) << 8;
+    }
+    if (citizen_changes.signature.items[grid_offset] != signature) {
+        citizen_changes.signature.items[grid_offset] = signature;
+        if (!*has_changes) {
+            citizen_changes.version++;
+            *has_changes = 1;
+        }
+        citizen_changes.block_version[change_block_index(grid_offset)] = citizen_changes.version;
+    }
+}
+
 void map_routing_update_land_citizen(void)
 {
     map_grid_init_i8(terrain_land_citizen.items, -1);
+    int has_changes = 0;
     int grid_offset = map_data.start_offset;
     for (int y = 0; y < map_data.height; y++, grid_offset += map_data.border_size) {
         for (int x = 0; x < map_data.width; x++, grid_offset++) {
@@ -139,6 +174,7 @@ void map_routing_update_land_citizen(void)
                     map_image_set(grid_offset, (map_random_get(grid_offset) & 7) + image_group(GROUP_TERRAIN_GRASS_1));
                     map_property_mark_draw_tile(grid_offset);
                     map_property_set_multi_tile_size(grid_offset, 1);
+                    track_citizen_change(grid_offset, &has_changes);
                     continue;
                 }
                 terrain_land_citizen.items[grid_offset] = get_land_type_citizen_building(grid_offset);
@@ -149,10 +185,41 @@ void map_routing_update_land_citizen(void)
             } else {
                 terrain_land_citizen.items[grid_offset] = CITIZEN_4_CLEAR_TERRAIN;
             }
+            track_citizen_change(grid_offset, &has_changes);
         }
     }
 }
 
+unsigned int map_routing_citizen_version(void)
+{
+    return citizen_changes.version;
+}
+
+void map_routing_citizen_mark_changed(int grid_offset)
+{
+    if (map_grid_is_valid_offset(grid_offset)) {
+        citizen_changes.version++;
+        citizen_changes.block_version[change_block_index(grid_offset)] = citizen_changes.version;
+    }
+}
+
+int map_routing_citizen_changed_since(int x_min, int y_min, int x_max, int y_max, unsigned int version)
+{
+    map_grid_bound_area(&x_min, &y_min, &x_max, &y_max);
+    int block_min = change_block_index(map_grid_offset(x_min, y_min));
+    int block_max = change_block_index(map_grid_offset(x_max, y_max));
+    int block_x_min = block_min % CHANGE_BLOCKS_PER_ROW;
+    int block_x_max = block_max % CHANGE_BLOCKS_PER_ROW;
+    for (int row = block_min - block_x_min; row <= block_max - block_x_max; row += CHANGE_BLOCKS_PER_ROW) {
+        for (int block_x = block_x_min; block_x <= block_x_max; block_x++) {
+            if (citizen_changes.block_version[row + block_x] > version) {
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
+
 static int get_land_type_noncitizen(int grid_offset)
 {
     int type = NONCITIZEN_1_BUILDING;
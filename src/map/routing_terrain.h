@@ -15,6 +15,31 @@ int map_routing_citizen_is_road(int grid_offset);
 int map_routing_citizen_is_highway(int grid_offset);
 int map_routing_citizen_is_passable_terrain(int grid_offset);
 
+/**
+ * Gets the version of the citizen routing terrain. The version increases whenever
+ * a tile that affects citizen movement changes.
+ * @return Current version
+ */
+unsigned int map_routing_citizen_version(void);
+
+/**
+ * Marks a tile as changed for citizen movement, for changes that are not visible in the terrain,
+ * such as roadblock permissions
+ * @param grid_offset Tile that changed
+ */
+void map_routing_citizen_mark_changed(int grid_offset);
+
+/**
+ * Checks whether any tile in the area affecting citizen movement changed after the given version
+ * @param x_min Minimum X of the area
+ * @param y_min Minimum Y of the area
+ * @param x_max Maximum X of the area
+ * @param y_max Maximum Y of the area
+ * @param version Version as returned by map_routing_citizen_version
+ * @return 1 if any tile in the area changed, 0 otherwise
+ */
+int map_routing_citizen_changed_since(int x_min, int y_min, int x_max, int y_max, unsigned int version);
+
 int map_routing_noncitizen_is_passable(int grid_offset);
 int map_routing_is_destroyable(int grid_offset);
 
@@ -6,8 +6,12 @@
 #include "map/ring.h"
 #include "map/routing.h"
 
+#define WATER_SUPPLY_TERRAIN (TERRAIN_WATER | TERRAIN_AQUEDUCT | TERRAIN_HIGHWAY | \
+    TERRAIN_RESERVOIR_RANGE | TERRAIN_FOUNTAIN_RANGE)
+
 static grid_u32 terrain_grid;
 static grid_u32 terrain_grid_backup;
+static unsigned int water_supply_version;
 
 int map_terrain_is(int grid_offset, int terrain)
 {
@@ -38,16 +42,25 @@ int map_terrain_get_from_buffer_32(buffer *buf, int grid_offset)
 
 void map_terrain_set(int grid_offset, int terrain)
 {
+    if ((terrain_grid.items[grid_offset] ^ terrain) & WATER_SUPPLY_TERRAIN) {
+        water_supply_version++;
+    }
     terrain_grid.items[grid_offset] = terrain;
 }
 
 void map_terrain_add(int grid_offset, int terrain)
 {
+    if (~terrain_grid.items[grid_offset] & terrain & WATER_SUPPLY_TERRAIN) {
+        water_supply_version++;
+    }
     terrain_grid.items[grid_offset] |= terrain;
 }
 
 void map_terrain_remove(int grid_offset, int terrain)
 {
+    if (terrain_grid.items[grid_offset] & terrain & WATER_SUPPLY_TERRAIN) {
+        water_supply_version++;
+    }
     terrain_grid.items[grid_offset] &= ~terrain;
 }
 
@@ -77,9 +90,17 @@ void map_terrain_remove_with_radius(int x, int y, int size, int radius, int terr
 
 void map_terrain_remove_all(int terrain)
 {
+    if (terrain & WATER_SUPPLY_TERRAIN) {
+        water_supply_version++;
+    }
     map_grid_and_u32(terrain_grid.items, ~terrain);
 }
 
+unsigned int map_terrain_water_supply_version(void)
+{
+    return water_supply_version;
+}
+
 int map_terrain_count_directly_adjacent_with_type(int grid_offset, int terrain)
 {
     int count = 0;
@@ -396,11 +417,13 @@ void map_terrain_backup(void)
 void map_terrain_restore(void)
 {
     map_grid_copy_u32(terrain_grid_backup.items, terrain_grid.items);
+    water_supply_version++;
 }
 
 void map_terrain_clear(void)
 {
     map_grid_clear_u32(terrain_grid.items);
+    water_supply_version++;
 }
 
 void map_terrain_init_outside_map(void)
@@ -417,6 +440,7 @@ void map_terrain_init_outside_map(void)
             }
         }
     }
+    water_supply_version++;
 }
 
 void map_terrain_save_state(buffer *buf)
@@ -472,5 +496,6 @@ void map_terrain_load_state(buffer *buf, int expanded_terrain_data, buffer *imag
     } else {
         map_grid_load_state_u16_to_u32(terrain_grid.items, buf);
     }
+    water_supply_version++;
     determine_original_trees(images, legacy_image_buffer);
 }
@@ -61,6 +61,13 @@ void map_terrain_remove_with_radius(int x, int y, int size, int radius, int terr
 
 void map_terrain_remove_all(int terrain);
 
+/**
+ * Gets a counter that changes whenever water, aqueduct, highway or water range terrain changes,
+ * so the water supply can skip its update when the network is unchanged
+ * @return Water supply terrain version
+ */
+unsigned int map_terrain_water_supply_version(void);
+
 /**
  * Check orthogonal neighbours of a tile if they contain a terrain.
  * @param grid_offset Tile which neighbours will be checked.
@@ -6,6 +6,7 @@
 #include "city/view.h"
 #include "core/direction.h"
 #include "core/image.h"
+#include "core/log.h"
 #include "map/aqueduct.h"
 #include "map/building.h"
 #include "map/building_tiles.h"
@@ -29,9 +30,32 @@
 #define FORBIDDEN_TERRAIN_RUBBLE (TERRAIN_AQUEDUCT | TERRAIN_ELEVATION | TERRAIN_ACCESS_RAMP |\
             TERRAIN_ROAD | TERRAIN_BUILDING | TERRAIN_GARDEN)
 
+// the paved road check looks for highways within three tiles
+#define TERRAIN_IMAGE_INPUT_RANGE 3
+#define MAX_LOGGED_TERRAIN_IMAGE_MISMATCHES 10
+
+enum {
+    IMAGE_INPUT_DESIRABLE = 1,
+    IMAGE_INPUT_VERY_DESIRABLE = 2,
+    IMAGE_INPUT_PLAZA_OR_EARTHQUAKE = 4,
+    IMAGE_INPUT_CONSTRUCTING = 8,
+    IMAGE_INPUT_WATER_ACCESS = 16
+};
+
 static int aqueduct_include_construction = 0;
 static int highway_top_tile_offsets[4] = { 0, -GRID_SIZE, -1, -GRID_SIZE - 1 };
 
+static struct {
+    int valid;
+    int check_updates;
+    int mismatches;
+    grid_u32 terrain;
+    grid_u32 image;
+    grid_u16 building_id;
+    grid_u8 inputs;
+    grid_u8 needs_update;
+} terrain_image_inputs;
+
 static int is_clear(int x, int y, int size, int disallowed_terrain, int check_image)
 {
     if (!map_grid_is_inside(x, y, size)) {
@@ -698,85 +722,94 @@ int map_tiles_highway_get_aqueduct_image(int grid_offset)
     return aqueduct_image_id;
 }
 
-static void set_aqueduct_image(int grid_offset, int is_road, const terrain_image *img)
+static int get_aqueduct_image(int grid_offset, int is_road, const terrain_image *img)
 {
-    int new_image_id = 0;
     if (map_terrain_is(grid_offset, TERRAIN_HIGHWAY)) {
-        new_image_id = map_tiles_highway_get_aqueduct_image(grid_offset);
-    } else {
-        int group_offset = img->group_offset;
-        if (is_road) {
-            if (!img->aqueduct_offset || (group_offset != 2 && group_offset != 3)) {
-                if (map_terrain_is(grid_offset + map_grid_delta(0, -1), TERRAIN_ROAD)) {
-                    group_offset = 3;
-                } else {
-                    group_offset = 2;
-                }
-            }
-            if (map_tiles_is_paved_road(grid_offset)) {
-                group_offset -= 2;
+        return map_tiles_highway_get_aqueduct_image(grid_offset);
+    }
+    int group_offset = img->group_offset;
+    if (is_road) {
+        if (!img->aqueduct_offset || (group_offset != 2 && group_offset != 3)) {
+            if (map_terrain_is(grid_offset + map_grid_delta(0, -1), TERRAIN_ROAD)) {
+                group_offset = 3;
             } else {
-                group_offset += 6;
+                group_offset = 2;
             }
         }
-        int image_aqueduct = image_group(GROUP_BUILDING_AQUEDUCT);
-        int water_offset;
-        int image_id = map_image_at(grid_offset);
-        if (image_id >= image_aqueduct && image_id < image_aqueduct + 15) {
-            water_offset = 0;
+        if (map_tiles_is_paved_road(grid_offset)) {
+            group_offset -= 2;
         } else {
-            water_offset = 15;
+            group_offset += 6;
         }
-        new_image_id = image_aqueduct + water_offset + group_offset;
     }
-    map_image_set(grid_offset, new_image_id);
-    map_property_set_multi_tile_size(grid_offset, 1);
-    map_property_mark_draw_tile(grid_offset);
+    int image_aqueduct = image_group(GROUP_BUILDING_AQUEDUCT);
+    int water_offset;
+    int image_id = map_image_at(grid_offset);
+    if (image_id >= image_aqueduct && image_id < image_aqueduct + 15) {
+        water_offset = 0;
+    } else {
+        water_offset = 15;
+    }
+    return image_aqueduct + water_offset + group_offset;
 }
 
-static void set_road_with_aqueduct_image(int grid_offset)
+static void set_aqueduct_image(int grid_offset, int is_road, const terrain_image *img)
 {
-    set_aqueduct_image(grid_offset, 1, map_image_context_get_aqueduct(grid_offset, 0));
+    map_image_set(grid_offset, get_aqueduct_image(grid_offset, is_road, img));
+    map_property_set_multi_tile_size(grid_offset, 1);
+    map_property_mark_draw_tile(grid_offset);
 }
 
-static void set_road_image(int x, int y, int grid_offset)
+static int get_road_image(int grid_offset)
 {
     if (!map_terrain_is(grid_offset, TERRAIN_ROAD) ||
         map_terrain_is(grid_offset, TERRAIN_WATER | TERRAIN_BUILDING)) {
-        return;
+        return 0;
     }
     if (map_terrain_is(grid_offset, TERRAIN_AQUEDUCT)) {
-        set_road_with_aqueduct_image(grid_offset);
-        return;
+        return get_aqueduct_image(grid_offset, 1, map_image_context_get_aqueduct(grid_offset, 0));
     }
     if (map_property_is_plaza_or_earthquake(grid_offset)) {
-        return;
+        return 0;
     }
     if (map_tiles_is_paved_road(grid_offset)) {
         const terrain_image *img = map_image_context_get_paved_road(grid_offset);
-        map_image_set(grid_offset, image_group(GROUP_TERRAIN_ROAD) +
-            img->group_offset + img->item_offset);
+        return image_group(GROUP_TERRAIN_ROAD) + img->group_offset + img->item_offset;
     } else {
         const terrain_image *img = map_image_context_get_dirt_road(grid_offset);
-        map_image_set(grid_offset, image_group(GROUP_TERRAIN_ROAD) +
-            img->group_offset + img->item_offset + 49);
+        return image_group(GROUP_TERRAIN_ROAD) + img->group_offset + img->item_offset + 49;
     }
+}
+
+static void set_road_image(int x, int y, int grid_offset)
+{
+    int image_id = get_road_image(grid_offset);
+    if (!image_id) {
+        return;
+    }
+    map_image_set(grid_offset, image_id);
     map_property_set_multi_tile_size(grid_offset, 1);
     map_property_mark_draw_tile(grid_offset);
 }
 
-static void set_highway_image(int x, int y, int grid_offset)
+static int get_highway_image(int grid_offset)
 {
     if (!map_terrain_is(grid_offset, TERRAIN_HIGHWAY) || map_terrain_is(grid_offset, TERRAIN_GATEHOUSE)) {
-        return;
+        return 0;
     }
     if (map_terrain_is(grid_offset, TERRAIN_AQUEDUCT)) {
-        const terrain_image *img = map_image_context_get_aqueduct(grid_offset, 0);
-        set_aqueduct_image(grid_offset, 0, img);
-    } else {
-        int highway_base = assets_lookup_image_id(ASSET_HIGHWAY_BASE_START);
-        map_image_set(grid_offset, highway_base);
+        return get_aqueduct_image(grid_offset, 0, map_image_context_get_aqueduct(grid_offset, 0));
+    }
+    return assets_lookup_image_id(ASSET_HIGHWAY_BASE_START);
+}
+
+static void set_highway_image(int x, int y, int grid_offset)
+{
+    int image_id = get_highway_image(grid_offset);
+    if (!image_id) {
+        return;
     }
+    map_image_set(grid_offset, image_id);
     map_property_set_multi_tile_size(grid_offset, 1);
     map_property_mark_draw_tile(grid_offset);
 }
@@ -988,33 +1021,43 @@ void map_tiles_update_region_meadow(int x_min, int y_min, int x_max, int y_max)
     foreach_region_tile(x_min, y_min, x_max, y_max, update_meadow_tile);
 }
 
-static void set_water_image(int x, int y, int grid_offset)
+static int get_water_image(int x, int y, int grid_offset)
 {
-    if ((map_terrain_get(grid_offset) & (TERRAIN_WATER | TERRAIN_BUILDING)) == TERRAIN_WATER) {
-        const terrain_image *img = map_image_context_get_shore(grid_offset);
-        int image_id = image_group(GROUP_TERRAIN_WATER) + img->group_offset + img->item_offset;
-        if (map_terrain_exists_tile_in_radius_with_type(x, y, 1, 2, TERRAIN_BUILDING)) {
-            // fortified shore
-            int base = image_group(GROUP_TERRAIN_WATER_SHORE);
-            switch (img->group_offset) {
-                case 8: image_id = base + 10; break;
-                case 12: image_id = base + 11; break;
-                case 16: image_id = base + 9; break;
-                case 20: image_id = base + 8; break;
-                case 24: image_id = base + 18; break;
-                case 28: image_id = base + 16; break;
-                case 32: image_id = base + 19; break;
-                case 36: image_id = base + 17; break;
-                case 50: image_id = base + 12; break;
-                case 51: image_id = base + 14; break;
-                case 52: image_id = base + 13; break;
-                case 53: image_id = base + 15; break;
-            }
+    if ((map_terrain_get(grid_offset) & (TERRAIN_WATER | TERRAIN_BUILDING)) != TERRAIN_WATER) {
+        return 0;
+    }
+    const terrain_image *img = map_image_context_get_shore(grid_offset);
+    int image_id = image_group(GROUP_TERRAIN_WATER) + img->group_offset + img->item_offset;
+    if (map_terrain_exists_tile_in_radius_with_type(x, y, 1, 2, TERRAIN_BUILDING)) {
+        // fortified shore
+        int base = image_group(GROUP_TERRAIN_WATER_SHORE);
+        switch (img->group_offset) {
+            case 8: image_id = base + 10; break;
+            case 12: image_id = base + 11; break;
+            case 16: image_id = base + 9; break;
+            case 20: image_id = base + 8; break;
+            case 24: image_id = base + 18; break;
+            case 28: image_id = base + 16; break;
+            case 32: image_id = base + 19; break;
+            case 36: image_id = base + 17; break;
+            case 50: image_id = base + 12; break;
+            case 51: image_id = base + 14; break;
+            case 52: image_id = base + 13; break;
+            case 53: image_id = base + 15; break;
         }
-        map_image_set(grid_offset, image_id);
-        map_property_set_multi_tile_size(grid_offset, 1);
-        map_property_mark_draw_tile(grid_offset);
     }
+    return image_id;
+}
+
+static void set_water_image(int x, int y, int grid_offset)
+{
+    int image_id = get_water_image(x, y, grid_offset);
+    if (!image_id) {
+        return;
+    }
+    map_image_set(grid_offset, image_id);
+    map_property_set_multi_tile_size(grid_offset, 1);
+    map_property_mark_draw_tile(grid_offset);
 }
 
 static void update_water_tile(int x, int y, int grid_offset)
@@ -1331,8 +1374,145 @@ void map_tiles_remove_entry_exit_flags(void)
     remove_entry_exit_flag(city_map_exit_flag());
 }
 
+static int get_terrain_image_inputs(int grid_offset)
+{
+    int inputs = 0;
+    int desirability = map_desirability_get(grid_offset);
+    if (desirability > 0) {
+        inputs |= IMAGE_INPUT_DESIRABLE;
+    }
+    if (desirability > 4) {
+        inputs |= IMAGE_INPUT_VERY_DESIRABLE;
+    }
+    if (map_property_is_plaza_or_earthquake(grid_offset)) {
+        inputs |= IMAGE_INPUT_PLAZA_OR_EARTHQUAKE;
+    }
+    if (map_property_is_constructing(grid_offset)) {
+        inputs |= IMAGE_INPUT_CONSTRUCTING;
+    }
+    if (map_aqueduct_has_water_access_at(grid_offset)) {
+        inputs |= IMAGE_INPUT_WATER_ACCESS;
+    }
+    return inputs;
+}
+
+static unsigned int get_tracked_image(int grid_offset)
+{
+    int terrain = map_terrain_get(grid_offset);
+    if ((terrain & (TERRAIN_ROAD | TERRAIN_HIGHWAY)) || (terrain & (TERRAIN_WATER | TERRAIN_BUILDING)) == TERRAIN_WATER) {
+        return map_image_at(grid_offset);
+    }
+    return 0;
+}
+
+static void store_terrain_image_inputs(int x, int y, int grid_offset)
+{
+    terrain_image_inputs.terrain.items[grid_offset] = map_terrain_get(grid_offset);
+    terrain_image_inputs.building_id.items[grid_offset] = map_building_at(grid_offset);
+    terrain_image_inputs.inputs.items[grid_offset] = get_terrain_image_inputs(grid_offset);
+    terrain_image_inputs.image.items[grid_offset] = get_tracked_image(grid_offset);
+}
+
+static void mark_for_image_update(int x, int y, int grid_offset)
+{
+    terrain_image_inputs.needs_update.items[grid_offset] = 1;
+}
+
+static void find_terrain_image_changes(int x, int y, int grid_offset)
+{
+    if (terrain_image_inputs.terrain.items[grid_offset] != map_terrain_get(grid_offset) ||
+        terrain_image_inputs.building_id.items[grid_offset] != map_building_at(grid_offset) ||
+        terrain_image_inputs.inputs.items[grid_offset] != get_terrain_image_inputs(grid_offset)) {
+        foreach_region_tile(x - TERRAIN_IMAGE_INPUT_RANGE, y - TERRAIN_IMAGE_INPUT_RANGE,
+            x + TERRAIN_IMAGE_INPUT_RANGE, y + TERRAIN_IMAGE_INPUT_RANGE, mark_for_image_update);
+    } else if (terrain_image_inputs.image.items[grid_offset] != get_tracked_image(grid_offset)) {
+        // the image was replaced by something else, only the tile itself needs to be fixed
+        terrain_image_inputs.needs_update.items[grid_offset] = 1;
+    }
+}
+
+static void update_changed_terrain_image(int x, int y, int grid_offset)
+{
+    if (!terrain_image_inputs.needs_update.items[grid_offset]) {
+        return;
+    }
+    terrain_image_inputs.needs_update.items[grid_offset] = 0;
+    set_road_image(x, y, grid_offset);
+    set_highway_image(x, y, grid_offset);
+    set_water_image(x, y, grid_offset);
+    store_terrain_image_inputs(x, y, grid_offset);
+}
+
+static int get_full_update_image(int x, int y, int grid_offset)
+{
+    // same result as the last of the full road, highway and water updates that changes the tile
+    int image_id = get_water_image(x, y, grid_offset);
+    if (!image_id) {
+        image_id = get_highway_image(grid_offset);
+    }
+    if (!image_id) {
+        image_id = get_road_image(grid_offset);
+    }
+    return image_id;
+}
+
+static void check_terrain_image(int x, int y, int grid_offset)
+{
+    // a full update may pick any variant of an image, so only images outside the variant range differ
+    map_image_context_set_variant(IMAGE_CONTEXT_VARIANT_FIRST);
+    unsigned int first_variant = get_full_update_image(x, y, grid_offset);
+    map_image_context_set_variant(IMAGE_CONTEXT_VARIANT_LAST);
+    unsigned int last_variant = get_full_update_image(x, y, grid_offset);
+    map_image_context_set_variant(IMAGE_CONTEXT_VARIANT_NEXT);
+
+    unsigned int image_id = map_image_at(grid_offset);
+    if (!first_variant || (image_id >= first_variant && image_id <= last_variant)) {
+        return;
+    }
+    if (++terrain_image_inputs.mismatches <= MAX_LOGGED_TERRAIN_IMAGE_MISMATCHES) {
+        log_error("Terrain image differs from a full update at grid offset", 0, grid_offset);
+    }
+}
+
+static void check_changed_terrain_images(void)
+{
+    terrain_image_inputs.mismatches = 0;
+    foreach_map_tile(check_terrain_image);
+    if (terrain_image_inputs.mismatches) {
+        log_error("Terrain images that differ from a full update:", 0, terrain_image_inputs.mismatches);
+    }
+}
+
+void map_tiles_update_changed_terrain_images(void)
+{
+    if (!terrain_image_inputs.valid) {
+        map_tiles_update_all_roads();
+        map_tiles_update_all_highways();
+        map_tiles_update_all_water();
+        foreach_map_tile(store_terrain_image_inputs);
+        terrain_image_inputs.valid = 1;
+        return;
+    }
+    foreach_map_tile(find_terrain_image_changes);
+    foreach_map_tile(update_changed_terrain_image);
+    if (terrain_image_inputs.check_updates) {
+        check_changed_terrain_images();
+    }
+}
+
+void map_tiles_set_check_changed_terrain_images(int check)
+{
+    terrain_image_inputs.check_updates = check;
+}
+
+void map_tiles_reset_changed_terrain_images(void)
+{
+    terrain_image_inputs.valid = 0;
+}
+
 void map_tiles_update_all(void)
 {
+    map_tiles_reset_changed_terrain_images();
     map_tiles_remove_entry_exit_flags();
 
     map_tiles_update_all_elevation();
@@ -54,4 +54,23 @@ void map_tiles_remove_entry_exit_flags(void);
 
 void map_tiles_update_all(void);
 
+/**
+ * Updates the images of roads, highways and water on the tiles where anything that affects those images
+ * has changed since the last update, and on the tiles around them.
+ * The first update after the map was loaded or reset updates all tiles.
+ */
+void map_tiles_update_changed_terrain_images(void);
+
+/**
+ * Enables comparing every changed terrain image update with what a full update would set.
+ * Tiles that differ are logged. The images and the image variants are not changed by the comparison.
+ * @param check Whether to compare the updates
+ */
+void map_tiles_set_check_changed_terrain_images(int check);
+
+/**
+ * Forgets the tracked terrain, so that the next changed terrain image update updates all tiles
+ */
+void map_tiles_reset_changed_terrain_images(void);
+
 #endif // MAP_TILES_H
@@ -5,6 +5,7 @@
 #include "building/image.h"
 #include "building/monument.h"
 #include "building/list.h"
+#include "core/hash.h"
 #include "core/image.h"
 #include "map/aqueduct.h"
 #include "map/building_tiles.h"
@@ -35,6 +36,13 @@ static struct {
     int tail;
 } queue;
 
+static struct {
+    int valid;
+    unsigned int terrain_version;
+    uint64_t reservoir_signature;
+    uint64_t fountain_signature;
+} network;
+
 static void mark_well_access(int well_id, int radius)
 {
     building *well = building_get(well_id);
@@ -151,10 +159,29 @@ static void fill_aqueducts_from_offset(int grid_offset)
     } while (next_offset > -1);
 }
 
-void map_water_supply_update_reservoir_fountain(void)
+static uint64_t hash_int(uint64_t hash, int value)
 {
-    map_terrain_remove_all(TERRAIN_FOUNTAIN_RANGE | TERRAIN_RESERVOIR_RANGE);
-    // reservoirs
+    return hash_bytes(&value, sizeof(int), hash);
+}
+
+static uint64_t get_reservoir_signature(void)
+{
+    uint64_t hash = 0;
+    for (building *b = building_first_of_type(BUILDING_RESERVOIR); b; b = b->next_of_type) {
+        hash = hash_int(hash, b->id);
+        hash = hash_int(hash, b->grid_offset);
+        hash = hash_int(hash, b->state);
+    }
+    hash = hash_int(hash, map_water_supply_reservoir_radius());
+    if (building_monument_gt_module_is_active(NEPTUNE_MODULE_2_CAPACITY_AND_WATER)) {
+        hash = hash_int(hash, building_monument_get_neptune_gt());
+    }
+    return hash;
+}
+
+static void update_reservoirs_and_aqueducts(void)
+{
+    map_terrain_remove_all(TERRAIN_RESERVOIR_RANGE);
     set_all_aqueducts_to_no_water();
     for (building *b = building_first_of_type(BUILDING_RESERVOIR); b; b = b->next_of_type) {
         if (b->state != BUILDING_STATE_IN_USE) {
@@ -196,8 +223,33 @@ void map_water_supply_update_reservoir_fountain(void)
         building *b = building_get(building_monument_get_neptune_gt());
         map_terrain_add_with_radius(b->x, b->y, 7, map_water_supply_reservoir_radius(), TERRAIN_RESERVOIR_RANGE);
     }
+}
+
+static void update_fountain_ranges(void)
+{
+    map_terrain_remove_all(TERRAIN_FOUNTAIN_RANGE);
+    for (building *b = building_first_of_type(BUILDING_FOUNTAIN); b; b = b->next_of_type) {
+        if (b->state == BUILDING_STATE_IN_USE && b->has_water_access) {
+            map_terrain_add_with_radius(b->x, b->y, 1,
+                map_water_supply_fountain_radius(), TERRAIN_FOUNTAIN_RANGE);
+        }
+    }
+}
+
+void map_water_supply_update_reservoir_fountain(void)
+{
+    // The aqueduct network and the water ranges are only rebuilt when the terrain,
+    // the reservoirs or the working fountains changed since the previous update
+    int terrain_changed = !network.valid || network.terrain_version != map_terrain_water_supply_version();
+
+    uint64_t reservoir_signature = get_reservoir_signature();
+    if (terrain_changed || reservoir_signature != network.reservoir_signature) {
+        update_reservoirs_and_aqueducts();
+        network.reservoir_signature = reservoir_signature;
+    }
 
     // fountains
+    uint64_t fountain_signature = hash_int(0, map_water_supply_fountain_radius());
     for (building *b = building_first_of_type(BUILDING_FOUNTAIN); b; b = b->next_of_type) {
         if (b->state != BUILDING_STATE_IN_USE) {
             continue;
@@ -214,12 +266,16 @@ void map_water_supply_update_reservoir_fountain(void)
         map_building_tiles_add(b->id, b->x, b->y, 1, building_image_get(b), TERRAIN_BUILDING);
         if (map_terrain_is(b->grid_offset, TERRAIN_RESERVOIR_RANGE) && b->num_workers) {
             b->has_water_access = 1;
-            map_terrain_add_with_radius(b->x, b->y, 1,
-                map_water_supply_fountain_radius(), TERRAIN_FOUNTAIN_RANGE);
+            fountain_signature = hash_int(fountain_signature, b->grid_offset);
         } else {
             b->has_water_access = 0;
         }
     }
+    if (terrain_changed || fountain_signature != network.fountain_signature) {
+        update_fountain_ranges();
+        network.fountain_signature = fountain_signature;
+    }
+
     // Ponds
     static const building_type ponds[] = { BUILDING_SMALL_POND, BUILDING_LARGE_POND };
     for (int i = 0; i < 2; i++) {
@@ -258,6 +314,9 @@ void map_water_supply_update_reservoir_fountain(void)
             b->has_water_access = 0;
         }
     }
+
+    network.terrain_version = map_terrain_water_supply_version();
+    network.valid = 1;
 }
 
 int map_water_supply_is_well_unnecessary(int well_id, int radius)
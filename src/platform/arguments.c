@@ -2,8 +2,16 @@
 
 #include "SDL.h"
 
+#define DEFAULT_HASH_LOG_INTERVAL 50
+
 #define CURSOR_SCALE_ERROR_MESSAGE "Option --cursor-scale must be followed by a scale value of 1, 1.5 or 2"
 #define DISPLAY_SCALE_ERROR_MESSAGE "Option --display-scale must be followed by a scale value between 0.5 and 5"
+#define RECORD_REPLAY_ERROR_MESSAGE "Option --record-replay must be followed by a file name"
+#define REPLAY_ERROR_MESSAGE "Option --replay must be followed by a file name"
+#define HASH_LOG_ERROR_MESSAGE "Option --hash-log must be followed by a file name"
+#define HASH_INTERVAL_ERROR_MESSAGE "Option --hash-interval must be followed by a positive number of ticks"
+#define COMPARE_HASH_LOGS_ERROR_MESSAGE "Option --compare-hash-logs must be followed by two file names"
+#define TRACE_ERROR_MESSAGE "Option --trace must be followed by a file name"
 #define UNKNOWN_OPTION_ERROR_MESSAGE "Option %s not recognized"
 
 static int parse_decimal_as_percentage(const char *str)
@@ -54,6 +62,14 @@ int platform_parse_arguments(int argc, char **argv, augustus_args *output_args)
     output_args->cursor_scale_percentage = 0;
     output_args->force_windowed = 0;
     output_args->launch_asset_previewer = 0;
+    output_args->record_replay_file = 0;
+    output_args->replay_file = 0;
+    output_args->hash_log_file = 0;
+    output_args->hash_log_interval = DEFAULT_HASH_LOG_INTERVAL;
+    output_args->compare_hash_logs[0] = 0;
+    output_args->compare_hash_logs[1] = 0;
+    output_args->trace_file = 0;
+    output_args->check_terrain_images = 0;
 
     for (int i = 1; i < argc; i++) {
         // we ignore "-psn" arguments, this is needed to launch the app
@@ -94,6 +110,58 @@ int platform_parse_arguments(int argc, char **argv, augustus_args *output_args)
             output_args->force_windowed = 1;
         } else if (SDL_strcmp(argv[i], "--asset-previewer") == 0) {
             output_args->launch_asset_previewer = 1;
+        } else if (SDL_strcmp(argv[i], "--record-replay") == 0) {
+            if (i + 1 < argc) {
+                output_args->record_replay_file = argv[i + 1];
+                i++;
+            } else {
+                SDL_Log(RECORD_REPLAY_ERROR_MESSAGE);
+                ok = 0;
+            }
+        } else if (SDL_strcmp(argv[i], "--replay") == 0) {
+            if (i + 1 < argc) {
+                output_args->replay_file = argv[i + 1];
+                i++;
+            } else {
+                SDL_Log(REPLAY_ERROR_MESSAGE);
+                ok = 0;
+            }
+        } else if (SDL_strcmp(argv[i], "--hash-log") == 0) {
+            if (i + 1 < argc) {
+                output_args->hash_log_file = argv[i + 1];
+                i++;
+            } else {
+                SDL_Log(HASH_LOG_ERROR_MESSAGE);
+                ok = 0;
+            }
+        } else if (SDL_strcmp(argv[i], "--hash-interval") == 0) {
+            int interval = i + 1 < argc ? SDL_atoi(argv[i + 1]) : 0;
+            if (interval > 0) {
+                output_args->hash_log_interval = interval;
+                i++;
+            } else {
+                SDL_Log(HASH_INTERVAL_ERROR_MESSAGE);
+                ok = 0;
+            }
+        } else if (SDL_strcmp(argv[i], "--compare-hash-logs") == 0) {
+            if (i + 2 < argc) {
+                output_args->compare_hash_logs[0] = argv[i + 1];
+                output_args->compare_hash_logs[1] = argv[i + 2];
+                i += 2;
+            } else {
+                SDL_Log(COMPARE_HASH_LOGS_ERROR_MESSAGE);
+                ok = 0;
+            }
+        } else if (SDL_strcmp(argv[i], "--trace") == 0) {
+            if (i + 1 < argc) {
+                output_args->trace_file = argv[i + 1];
+                i++;
+            } else {
+                SDL_Log(TRACE_ERROR_MESSAGE);
+                ok = 0;
+            }
+        } else if (SDL_strcmp(argv[i], "--check-terrain-images") == 0) {
+            output_args->check_terrain_images = 1;
         } else if (SDL_strcmp(argv[i], "--help") == 0) {
             ok = 0;
         } else if (SDL_strncmp(argv[i], "--", 2) == 0) {
@@ -113,6 +181,20 @@ int platform_parse_arguments(int argc, char **argv, augustus_args *output_args)
         SDL_Log("          Scales the mouse cursor by a factor of NUMBER. Number can be 1, 1.5 or 2");
         SDL_Log("--windowed");
         SDL_Log("          Forces the game to start in windowed mode");
+        SDL_Log("--record-replay FILE");
+        SDL_Log("          Records the next game that is started or loaded as a replay to FILE");
+        SDL_Log("--replay FILE");
+        SDL_Log("          Plays back the replay in FILE as fast as possible, verifies it and exits");
+        SDL_Log("--hash-log FILE");
+        SDL_Log("          Writes hashes of the game state to FILE, to compare games with --compare-hash-logs");
+        SDL_Log("--hash-interval NUMBER");
+        SDL_Log("          Writes the state hashes every NUMBER ticks instead of every 50 ticks, which is one game day");
+        SDL_Log("--compare-hash-logs FILE1 FILE2");
+        SDL_Log("          Compares two state hash logs, reports the first tick where they differ and exits");
+        SDL_Log("--trace FILE");
+        SDL_Log("          Writes timing spans to FILE in the Chrome trace format, if compiled with TRACING");
+        SDL_Log("--check-terrain-images");
+        SDL_Log("          Compares the monthly road, highway and water image updates with a full update and logs differences");
         SDL_Log("The last argument, if present, is interpreted as data directory for the Caesar 3 installation");
     }
     return ok;
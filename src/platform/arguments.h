@@ -7,6 +7,13 @@ typedef struct {
     int cursor_scale_percentage;
     int force_windowed;
     int launch_asset_previewer;
+    const char *record_replay_file;
+    const char *replay_file;
+    const char *hash_log_file;
+    int hash_log_interval;
+    const char *compare_hash_logs[2];
+    const char *trace_file;
+    int check_terrain_images;
 } augustus_args;
 
 int platform_parse_arguments(int argc, char **argv, augustus_args *output_args);
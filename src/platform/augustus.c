@@ -6,13 +6,17 @@
 #include "core/lang.h"
 #include "core/log.h"
 #include "core/time.h"
+#include "core/trace.h"
 #include "game/game.h"
+#include "game/replay.h"
 #include "game/settings.h"
+#include "game/state_hash.h"
 #include "game/system.h"
 #include "graphics/screen.h"
 #include "graphics/window.h"
 #include "input/mouse.h"
 #include "input/touch.h"
+#include "map/tiles.h"
 #include "platform/arguments.h"
 #ifndef NDEBUG
 #include "platform/debug.h"
@@ -152,10 +156,18 @@ static void run_and_draw(void)
 #else
     time_set_millis(SDL_GetTicks());
 
+    TRACE_BEGIN("frame");
+    TRACE_BEGIN("run");
     game_run();
+    TRACE_END();
+    TRACE_BEGIN("draw");
     game_draw();
+    TRACE_END();
 
+    TRACE_BEGIN("render");
     platform_renderer_render();
+    TRACE_END();
+    TRACE_END();
 #endif
 }
 
@@ -535,11 +547,21 @@ static void setup(const augustus_args *args)
         exit_with_status(-1);
     }
 
+    // Tracing starts before pre-init, so that loading the language files is traced as well
+    if (args->trace_file) {
+        trace_start(args->trace_file);
+    }
+
     if (!pre_init(args->data_directory)) {
         SDL_Log("Exiting: game pre-init failed");
         exit_with_status(1);
     }
 
+    if (args->compare_hash_logs[0]) {
+        int equal = game_state_hash_compare_logs(args->compare_hash_logs[0], args->compare_hash_logs[1]);
+        exit_with_status(equal ? 0 : 4);
+    }
+
     if (args->force_windowed && setting_fullscreen()) {
         int w, h;
         setting_window(&w, &h);
@@ -578,6 +600,22 @@ static void setup(const augustus_args *args)
         exit_with_status(2);
     }
 
+    if (args->hash_log_file) {
+        game_state_hash_start_log(args->hash_log_file, args->hash_log_interval);
+    }
+    if (args->check_terrain_images) {
+        map_tiles_set_check_changed_terrain_images(1);
+    }
+    if (args->replay_file) {
+        int in_sync = game_replay_play(args->replay_file);
+        SDL_Log("Replay %s", in_sync ? "finished in sync" : "failed or went out of sync");
+        trace_stop();
+        exit_with_status(in_sync ? 0 : 3);
+    }
+    if (args->record_replay_file) {
+        game_replay_record_next_game(args->record_replay_file);
+    }
+
     data.quit = 0;
     data.active = 1;
 }
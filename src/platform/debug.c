@@ -25,7 +25,7 @@ static void draw_routing(int x, int y, int grid_offset)
     int tx = map_grid_offset_to_x(grid_offset);
     int ty = map_grid_offset_to_y(grid_offset);
     map_routing_distance_grid *distance = map_routing_get_distance_grid();
-    int16_t dist = distance->determined.items[grid_offset];
+    int32_t dist = distance->determined.items[grid_offset];
     if (!dist) {
         return;
     }
@@ -5,6 +5,7 @@
 #include "sound/device.h"
 #include "game/settings.h"
 #include "platform/platform.h"
+#include "platform/thread.h"
 #include "platform/vita/vita.h"
 
 #include "SDL.h"
@@ -23,6 +24,10 @@
 #define AUDIO_BUFFERS 1024
 
 #define MAX_CHANNELS 160
+// Channel files, plus the most recently used files played with sound_device_play_file_on_channel()
+#define MAX_SOUND_FILES (MAX_CHANNELS + 32)
+#define MAX_CACHED_BYTES (32 * 1024 * 1024)
+#define NO_PANNING -1
 
 #if SDL_VERSION_ATLEAST(2, 0, 7)
 #define USE_SDL_AUDIOSTREAM
@@ -37,17 +42,54 @@ static struct {
 } vita_music_data;
 #endif
 
+typedef enum {
+    SOUND_FILE_UNLOADED = 0,
+    SOUND_FILE_QUEUED = 1,
+    SOUND_FILE_LOADING = 2,
+    SOUND_FILE_LOADED = 3,
+    SOUND_FILE_INSTALLED = 4,
+    SOUND_FILE_FAILED = 5
+} sound_file_state;
+
 typedef struct {
     const char *filename;
+    sound_file_state state; // shared with the loader thread, only accessed with the loader lock held
+    Mix_Chunk *loaded_chunk; // shared with the loader thread, only accessed with the loader lock held
     Mix_Chunk *chunk;
+    unsigned int last_used;
+    int last_channel;
+} sound_file;
+
+typedef struct {
+    sound_file *file;
+    sound_file *playing;
+    sound_file *pending;
+    int pending_volume;
+    int pending_left;
+    int pending_right;
 } sound_channel;
 
 static struct {
     int initialized;
     Mix_Music *music;
     sound_channel channels[MAX_CHANNELS];
+    sound_file files[MAX_SOUND_FILES];
+    char file_names[MAX_SOUND_FILES - MAX_CHANNELS][2 * FILE_NAME_MAX];
+    unsigned int use_counter;
+    int cached_bytes;
 } data;
 
+static struct {
+    platform_thread *thread;
+    platform_mutex *lock;
+    platform_condition *wakeup;
+    sound_file *queue[MAX_SOUND_FILES];
+    int queue_start;
+    int queue_size;
+    int loaded;
+    int quit;
+} loader;
+
 static struct {
     SDL_AudioFormat format;
     SDL_AudioFormat dst_format;
@@ -68,14 +110,318 @@ static int percentage_to_volume(int percentage)
     return calc_adjust_with_percentage(percentage, master_percentage) * SDL_MIX_MAXVOLUME / 100;
 }
 
-static void init_channels(void)
+static Mix_Chunk *load_chunk(const char *filename)
+{
+    if (filename[0]) {
+#if defined(__vita__) || defined(__ANDROID__)
+        FILE *fp = file_open(filename, "rb");
+        if (!fp) {
+            return NULL;
+        }
+        SDL_RWops *sdl_fp = SDL_RWFromFP(fp, SDL_TRUE);
+        return Mix_LoadWAV_RW(sdl_fp, 1);
+#else
+        return Mix_LoadWAV(filename);
+#endif
+    } else {
+        return NULL;
+    }
+}
+
+static void lock_loader(void)
+{
+    if (loader.thread) {
+        platform_mutex_lock(loader.lock);
+    }
+}
+
+static void unlock_loader(void)
+{
+    if (loader.thread) {
+        platform_mutex_unlock(loader.lock);
+    }
+}
+
+static int run_loader(void *unused)
+{
+    platform_mutex_lock(loader.lock);
+    while (!loader.quit) {
+        if (!loader.queue_size) {
+            platform_condition_wait(loader.wakeup, loader.lock);
+            continue;
+        }
+        sound_file *file = loader.queue[loader.queue_start];
+        loader.queue_start = (loader.queue_start + 1) % MAX_SOUND_FILES;
+        loader.queue_size--;
+        file->state = SOUND_FILE_LOADING;
+        const char *filename = file->filename;
+        platform_mutex_unlock(loader.lock);
+
+        // Loading only reads the audio format of the mixer, so it can run while the mixer plays
+        Mix_Chunk *chunk = load_chunk(filename);
+
+        platform_mutex_lock(loader.lock);
+        file->loaded_chunk = chunk;
+        file->state = SOUND_FILE_LOADED;
+        loader.loaded++;
+    }
+    platform_mutex_unlock(loader.lock);
+    return 0;
+}
+
+static void start_loader(void)
+{
+    loader.quit = 0;
+    loader.queue_start = 0;
+    loader.queue_size = 0;
+    loader.loaded = 0;
+    loader.lock = platform_mutex_create();
+    loader.wakeup = platform_condition_create();
+    if (loader.lock && loader.wakeup) {
+        loader.thread = platform_thread_create(run_loader, "sound loader", 0);
+    }
+    if (!loader.thread) {
+        log_error("Unable to start sound loader thread, sounds are loaded when played", 0, 0);
+        if (loader.wakeup) {
+            platform_condition_destroy(loader.wakeup);
+            loader.wakeup = 0;
+        }
+        if (loader.lock) {
+            platform_mutex_destroy(loader.lock);
+            loader.lock = 0;
+        }
+    }
+}
+
+static void stop_loader(void)
+{
+    if (!loader.thread) {
+        return;
+    }
+    platform_mutex_lock(loader.lock);
+    loader.quit = 1;
+    platform_condition_broadcast(loader.wakeup);
+    platform_mutex_unlock(loader.lock);
+    platform_thread_wait(loader.thread);
+    loader.thread = 0;
+    platform_condition_destroy(loader.wakeup);
+    loader.wakeup = 0;
+    platform_mutex_destroy(loader.lock);
+    loader.lock = 0;
+}
+
+static void free_files(void)
+{
+    Mix_HaltChannel(-1);
+    for (int i = 0; i < MAX_SOUND_FILES; i++) {
+        if (data.files[i].chunk) {
+            Mix_FreeChunk(data.files[i].chunk);
+        }
+        if (data.files[i].loaded_chunk) {
+            Mix_FreeChunk(data.files[i].loaded_chunk);
+        }
+    }
+    memset(data.files, 0, sizeof(data.files));
+    memset(data.channels, 0, sizeof(data.channels));
+    data.cached_bytes = 0;
+}
+
+static int is_file_playing(const sound_file *file)
+{
+    return data.channels[file->last_channel].playing == file && Mix_Playing(file->last_channel);
+}
+
+static int is_file_pending(const sound_file *file)
 {
-    data.initialized = 1;
     for (int i = 0; i < MAX_CHANNELS; i++) {
-        data.channels[i].chunk = 0;
+        if (data.channels[i].pending == file) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static int is_file_loading(const sound_file *file)
+{
+    lock_loader();
+    int is_loading = file->state == SOUND_FILE_QUEUED || file->state == SOUND_FILE_LOADING ||
+        file->state == SOUND_FILE_LOADED;
+    unlock_loader();
+    return is_loading;
+}
+
+static void unload_file(sound_file *file)
+{
+    data.cached_bytes -= (int) file->chunk->alen;
+    Mix_FreeChunk(file->chunk);
+    file->chunk = 0;
+    lock_loader();
+    file->state = SOUND_FILE_UNLOADED;
+    unlock_loader();
+}
+
+static void evict_least_recently_used_files(void)
+{
+    while (data.cached_bytes > MAX_CACHED_BYTES) {
+        sound_file *oldest = 0;
+        for (int i = 0; i < MAX_SOUND_FILES; i++) {
+            sound_file *file = &data.files[i];
+            if (file->chunk && (!oldest || file->last_used < oldest->last_used) && !is_file_playing(file)) {
+                oldest = file;
+            }
+        }
+        if (!oldest) {
+            return;
+        }
+        unload_file(oldest);
     }
 }
 
+static void play_file(int channel, sound_file *file, int volume_pct, int left_pct, int right_pct);
+
+static void install_loaded_files(void)
+{
+    lock_loader();
+    if (!loader.loaded) {
+        unlock_loader();
+        return;
+    }
+    for (int i = 0; i < MAX_SOUND_FILES; i++) {
+        sound_file *file = &data.files[i];
+        if (file->state == SOUND_FILE_LOADED) {
+            file->chunk = file->loaded_chunk;
+            file->loaded_chunk = 0;
+            file->state = file->chunk ? SOUND_FILE_INSTALLED : SOUND_FILE_FAILED;
+            if (file->chunk) {
+                data.cached_bytes += (int) file->chunk->alen;
+            } else {
+                log_error("Unable to load sound file", file->filename, 0);
+            }
+        }
+    }
+    loader.loaded = 0;
+    unlock_loader();
+
+    for (int i = 0; i < MAX_CHANNELS; i++) {
+        sound_channel *ch = &data.channels[i];
+        if (ch->pending && ch->pending->chunk) {
+            play_file(i, ch->pending, ch->pending_volume, ch->pending_left, ch->pending_right);
+        } else if (ch->pending && !is_file_loading(ch->pending)) {
+            ch->pending = 0;
+        }
+    }
+    evict_least_recently_used_files();
+}
+
+static void request_file(sound_file *file, int is_urgent)
+{
+    if (file->chunk || !file->filename) {
+        return;
+    }
+    if (!loader.thread) {
+        if (file->state == SOUND_FILE_UNLOADED) {
+            file->loaded_chunk = load_chunk(file->filename);
+            file->state = SOUND_FILE_LOADED;
+            loader.loaded++;
+        }
+        return;
+    }
+    platform_mutex_lock(loader.lock);
+    if (file->state == SOUND_FILE_UNLOADED) {
+        file->state = SOUND_FILE_QUEUED;
+        if (is_urgent) {
+            loader.queue_start = (loader.queue_start + MAX_SOUND_FILES - 1) % MAX_SOUND_FILES;
+            loader.queue[loader.queue_start] = file;
+        } else {
+            loader.queue[(loader.queue_start + loader.queue_size) % MAX_SOUND_FILES] = file;
+        }
+        loader.queue_size++;
+        platform_condition_broadcast(loader.wakeup);
+    }
+    platform_mutex_unlock(loader.lock);
+}
+
+static void play_file(int channel, sound_file *file, int volume_pct, int left_pct, int right_pct)
+{
+    sound_channel *ch = &data.channels[channel];
+    file->last_used = ++data.use_counter;
+    if (!file->chunk) {
+        // Start playing as soon as the file has been loaded, instead of waiting for it
+        ch->pending = file;
+        ch->pending_volume = volume_pct;
+        ch->pending_left = left_pct;
+        ch->pending_right = right_pct;
+        request_file(file, 1);
+        if (!loader.thread) {
+            install_loaded_files();
+        }
+        if (!file->chunk && !is_file_loading(file)) {
+            // The file could not be loaded
+            ch->pending = 0;
+        }
+        return;
+    }
+    ch->pending = 0;
+    if (left_pct != NO_PANNING) {
+        Mix_SetPanning(channel, left_pct * 255 / 100, right_pct * 255 / 100);
+    }
+    Mix_VolumeChunk(file->chunk, percentage_to_volume(volume_pct));
+    Mix_PlayChannel(channel, file->chunk, 0);
+    ch->playing = file;
+    file->last_channel = channel;
+}
+
+static int is_file_reusable(const sound_file *file)
+{
+    return !(file->chunk && is_file_playing(file)) && !is_file_pending(file) && !is_file_loading(file);
+}
+
+static sound_file *get_named_file(const char *filename)
+{
+    if (strlen(filename) >= sizeof(data.file_names[0])) {
+        return 0;
+    }
+    for (int i = MAX_CHANNELS; i < MAX_SOUND_FILES; i++) {
+        sound_file *file = &data.files[i];
+        if (file->filename && strcmp(file->filename, filename) == 0) {
+            return file;
+        }
+    }
+    sound_file *oldest = 0;
+    for (int i = MAX_CHANNELS; i < MAX_SOUND_FILES; i++) {
+        sound_file *file = &data.files[i];
+        if (!is_file_reusable(file)) {
+            continue;
+        }
+        if (!file->filename) {
+            oldest = file;
+            break;
+        }
+        if (!oldest || file->last_used < oldest->last_used) {
+            oldest = file;
+        }
+    }
+    if (!oldest) {
+        return 0;
+    }
+    if (oldest->chunk) {
+        unload_file(oldest);
+    }
+    char *name = data.file_names[oldest - &data.files[MAX_CHANNELS]];
+    strcpy(name, filename);
+    lock_loader();
+    oldest->filename = name;
+    oldest->state = SOUND_FILE_UNLOADED;
+    unlock_loader();
+    return oldest;
+}
+
+static void init_channels(void)
+{
+    data.initialized = 1;
+    free_files();
+}
+
 void sound_device_open(void)
 {
 #ifdef USE_SDL_AUDIOSTREAM
@@ -117,55 +463,52 @@ void sound_device_close(void)
         for (int i = 0; i < MAX_CHANNELS; i++) {
             sound_device_stop_channel(i);
         }
+        stop_loader();
+        free_files();
         Mix_CloseAudio();
         data.initialized = 0;
     }
 }
 
-static Mix_Chunk *load_chunk(const char *filename)
+void sound_device_init_channels(int num_channels, char filenames[][CHANNEL_FILENAME_MAX])
 {
-    if (filename[0]) {
-#if defined(__vita__) || defined(__ANDROID__)
-        FILE *fp = file_open(filename, "rb");
-        if (!fp) {
-            return NULL;
+    if (data.initialized) {
+        if (num_channels > MAX_CHANNELS) {
+            num_channels = MAX_CHANNELS;
         }
-        SDL_RWops *sdl_fp = SDL_RWFromFP(fp, SDL_TRUE);
-        return Mix_LoadWAV_RW(sdl_fp, 1);
-#else
-        return Mix_LoadWAV(filename);
-#endif
-    } else {
-        return NULL;
+        Mix_AllocateChannels(num_channels);
+        stop_loader();
+        free_files();
+        for (int i = 0; i < num_channels; i++) {
+            data.files[i].filename = filenames[i][0] ? filenames[i] : 0;
+            data.channels[i].file = &data.files[i];
+        }
+        start_loader();
     }
 }
 
-static int load_channel(sound_channel *channel)
+void sound_device_preload_channel(int channel)
 {
-    if (!channel->chunk && channel->filename) {
-        channel->chunk = load_chunk(channel->filename);
+    if (data.initialized && loader.thread && config_get(CONFIG_GENERAL_ENABLE_AUDIO)) {
+        sound_file *file = data.channels[channel].file;
+        if (file) {
+            file->last_used = ++data.use_counter;
+            request_file(file, 0);
+        }
     }
-    return channel->chunk ? 1 : 0;
 }
 
-void sound_device_init_channels(int num_channels, char filenames[][CHANNEL_FILENAME_MAX])
+void sound_device_update(void)
 {
     if (data.initialized) {
-        if (num_channels > MAX_CHANNELS) {
-            num_channels = MAX_CHANNELS;
-        }
-        Mix_AllocateChannels(num_channels);
-        log_info("Loading audio files", 0, 0);
-        for (int i = 0; i < num_channels; i++) {
-            data.channels[i].chunk = 0;
-            data.channels[i].filename = filenames[i][0] ? filenames[i] : 0;
-        }
+        install_loaded_files();
     }
 }
 
 int sound_device_is_channel_playing(int channel)
 {
-    return data.channels[channel].chunk && Mix_Playing(channel);
+    const sound_channel *ch = &data.channels[channel];
+    return ch->pending || (ch->playing && Mix_Playing(channel));
 }
 
 void sound_device_set_music_volume(int volume_pct)
@@ -175,8 +518,11 @@ void sound_device_set_music_volume(int volume_pct)
 
 void sound_device_set_channel_volume(int channel, int volume_pct)
 {
-    if (data.channels[channel].chunk) {
-        Mix_VolumeChunk(data.channels[channel].chunk, percentage_to_volume(volume_pct));
+    sound_channel *ch = &data.channels[channel];
+    ch->pending_volume = volume_pct;
+    const sound_file *file = ch->playing ? ch->playing : ch->file;
+    if (file && file->chunk) {
+        Mix_VolumeChunk(file->chunk, percentage_to_volume(volume_pct));
     }
 }
 
@@ -248,10 +594,10 @@ void sound_device_play_file_on_channel(const char *filename, int channel, int vo
 {
     if (data.initialized && config_get(CONFIG_GENERAL_ENABLE_AUDIO)) {
         sound_device_stop_channel(channel);
-        data.channels[channel].chunk = load_chunk(filename);
-        if (data.channels[channel].chunk) {
-            sound_device_set_channel_volume(channel, volume_pct);
-            Mix_PlayChannel(channel, data.channels[channel].chunk, 0);
+        install_loaded_files();
+        sound_file *file = get_named_file(filename);
+        if (file) {
+            play_file(channel, file, volume_pct, NO_PANNING, NO_PANNING);
         }
     }
 }
@@ -259,10 +605,10 @@ void sound_device_play_file_on_channel(const char *filename, int channel, int vo
 void sound_device_play_channel(int channel, int volume_pct)
 {
     if (data.initialized && config_get(CONFIG_GENERAL_ENABLE_AUDIO)) {
-        sound_channel *ch = &data.channels[channel];
-        if (load_channel(ch)) {
-            sound_device_set_channel_volume(channel, volume_pct);
-            Mix_PlayChannel(channel, ch->chunk, 0);
+        install_loaded_files();
+        sound_file *file = data.channels[channel].file;
+        if (file && file->filename) {
+            play_file(channel, file, volume_pct, NO_PANNING, NO_PANNING);
         }
     }
 }
@@ -270,11 +616,10 @@ void sound_device_play_channel(int channel, int volume_pct)
 void sound_device_play_channel_panned(int channel, int volume_pct, int left_pct, int right_pct)
 {
     if (data.initialized && config_get(CONFIG_GENERAL_ENABLE_AUDIO)) {
-        sound_channel *ch = &data.channels[channel];
-        if (load_channel(ch)) {
-            Mix_SetPanning(channel, left_pct * 255 / 100, right_pct * 255 / 100);
-            sound_device_set_channel_volume(channel, volume_pct);
-            Mix_PlayChannel(channel, ch->chunk, 0);
+        install_loaded_files();
+        sound_file *file = data.channels[channel].file;
+        if (file && file->filename) {
+            play_file(channel, file, volume_pct, left_pct, right_pct);
         }
     }
 }
@@ -294,10 +639,10 @@ void sound_device_stop_channel(int channel)
 {
     if (data.initialized) {
         sound_channel *ch = &data.channels[channel];
-        if (ch->chunk) {
+        ch->pending = 0;
+        if (ch->playing) {
             Mix_HaltChannel(channel);
-            Mix_FreeChunk(ch->chunk);
-            ch->chunk = 0;
+            ch->playing = 0;
         }
     }
 }
@@ -0,0 +1,64 @@
+#include "thread.h"
+
+#include "SDL.h"
+
+int platform_thread_cpu_count(void)
+{
+    int count = SDL_GetCPUCount();
+    return count > 0 ? count : 1;
+}
+
+unsigned long platform_thread_current_id(void)
+{
+    return SDL_ThreadID();
+}
+
+platform_thread *platform_thread_create(int (*function)(void *data), const char *name, void *data)
+{
+    return (platform_thread *) SDL_CreateThread(function, name, data);
+}
+
+void platform_thread_wait(platform_thread *thread)
+{
+    SDL_WaitThread((SDL_Thread *) thread, 0);
+}
+
+platform_mutex *platform_mutex_create(void)
+{
+    return (platform_mutex *) SDL_CreateMutex();
+}
+
+void platform_mutex_destroy(platform_mutex *mutex)
+{
+    SDL_DestroyMutex((SDL_mutex *) mutex);
+}
+
+void platform_mutex_lock(platform_mutex *mutex)
+{
+    SDL_LockMutex((SDL_mutex *) mutex);
+}
+
+void platform_mutex_unlock(platform_mutex *mutex)
+{
+    SDL_UnlockMutex((SDL_mutex *) mutex);
+}
+
+platform_condition *platform_condition_create(void)
+{
+    return (platform_condition *) SDL_CreateCond();
+}
+
+void platform_condition_destroy(platform_condition *condition)
+{
+    SDL_DestroyCond((SDL_cond *) condition);
+}
+
+void platform_condition_wait(platform_condition *condition, platform_mutex *mutex)
+{
+    SDL_CondWait((SDL_cond *) condition, (SDL_mutex *) mutex);
+}
+
+void platform_condition_broadcast(platform_condition *condition)
+{
+    SDL_CondBroadcast((SDL_cond *) condition);
+}
@@ -0,0 +1,89 @@
+#ifndef PLATFORM_THREAD_H
+#define PLATFORM_THREAD_H
+
+/**
+ * @file
+ * Threads and synchronisation primitives provided by the platform
+ */
+
+typedef struct platform_thread platform_thread;
+typedef struct platform_mutex platform_mutex;
+typedef struct platform_condition platform_condition;
+
+/**
+ * Gets the number of logical CPU cores
+ * @return Number of CPU cores, at least 1
+ */
+int platform_thread_cpu_count(void);
+
+/**
+ * Gets an identifier of the calling thread
+ * @return Identifier that is unique among the running threads
+ */
+unsigned long platform_thread_current_id(void);
+
+/**
+ * Starts a new thread
+ * @param function Function to run in the thread
+ * @param name Name of the thread, for debugging
+ * @param data Data to pass to the function
+ * @return The thread, or 0 if the thread could not be created
+ */
+platform_thread *platform_thread_create(int (*function)(void *data), const char *name, void *data);
+
+/**
+ * Waits for a thread to finish and releases it
+ * @param thread Thread to wait for
+ */
+void platform_thread_wait(platform_thread *thread);
+
+/**
+ * Creates a mutex
+ * @return The mutex, or 0 if the mutex could not be created
+ */
+platform_mutex *platform_mutex_create(void);
+
+/**
+ * Destroys a mutex
+ * @param mutex Mutex to destroy
+ */
+void platform_mutex_destroy(platform_mutex *mutex);
+
+/**
+ * Locks a mutex, waiting until it is available
+ * @param mutex Mutex to lock
+ */
+void platform_mutex_lock(platform_mutex *mutex);
+
+/**
+ * Unlocks a mutex
+ * @param mutex Mutex to unlock
+ */
+void platform_mutex_unlock(platform_mutex *mutex);
+
+/**
+ * Creates a condition variable
+ * @return The condition, or 0 if the condition could not be created
+ */
+platform_condition *platform_condition_create(void);
+
+/**
+ * Destroys a condition variable
+ * @param condition Condition to destroy
+ */
+void platform_condition_destroy(platform_condition *condition);
+
+/**
+ * Waits for a condition to be signalled. The mutex must be locked and is locked again on return.
+ * @param condition Condition to wait for
+ * @param mutex Mutex that protects the condition
+ */
+void platform_condition_wait(platform_condition *condition, platform_mutex *mutex);
+
+/**
+ * Wakes up all threads waiting for a condition
+ * @param condition Condition to signal
+ */
+void platform_condition_broadcast(platform_condition *condition);
+
+#endif // PLATFORM_THREAD_H
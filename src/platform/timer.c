@@ -0,0 +1,14 @@
+#include "timer.h"
+
+#include "SDL.h"
+
+uint64_t platform_timer_microseconds(void)
+{
+    static uint64_t frequency;
+    if (!frequency) {
+        frequency = SDL_GetPerformanceFrequency();
+    }
+    uint64_t counter = SDL_GetPerformanceCounter();
+    // Split the division so that the multiplication does not overflow for high frequency counters
+    return counter / frequency * 1000000 + counter % frequency * 1000000 / frequency;
+}
@@ -0,0 +1,17 @@
+#ifndef PLATFORM_TIMER_H
+#define PLATFORM_TIMER_H
+
+#include <stdint.h>
+
+/**
+ * @file
+ * High resolution timer provided by the platform
+ */
+
+/**
+ * Gets the time from a high resolution clock. Use only for time difference calculations.
+ * @return Current time in microseconds
+ */
+uint64_t platform_timer_microseconds(void);
+
+#endif // PLATFORM_TIMER_H
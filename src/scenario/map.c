@@ -6,6 +6,12 @@
 
 void scenario_map_init(void)
 {
+    int saved_grid_size = scenario.map.width + scenario.map.grid_border_size;
+    map_grid_set_saved_layout(saved_grid_size, scenario.map.grid_start, scenario.map.width, scenario.map.height);
+    if (saved_grid_size != GRID_SIZE) {
+        scenario.map.grid_border_size = GRID_SIZE - scenario.map.width;
+        scenario.map.grid_start = map_grid_centered_start_offset(scenario.map.width, scenario.map.height);
+    }
     map_grid_init(scenario.map.width, scenario.map.height,
                   scenario.map.grid_start, scenario.map.grid_border_size);
 }
@@ -8,6 +8,7 @@
 #include "city/ratings.h"
 #include "city/resource.h"
 #include "core/random.h"
+#include "game/replay.h"
 #include "game/resource.h"
 #include "game/time.h"
 #include "game/tutorial.h"
@@ -104,6 +105,7 @@ void scenario_request_process(void)
 
 void scenario_request_dispatch(int id)
 {
+    game_replay_record_command(REPLAY_COMMAND_DISPATCH_REQUEST, id, 0);
     if (scenario.requests[id].state == REQUEST_STATE_NORMAL) {
         scenario.requests[id].state = REQUEST_STATE_DISPATCHED;
     } else {
@@ -224,6 +224,9 @@ void sound_city_mark_building_view(building_type type, int num_workers, int dire
         }
     }
 
+    if (!channels[channel].available) {
+        sound_device_preload_channel(channels[channel].channel + CITY_CHANNEL_OFFSET);
+    }
     channels[channel].available = 1;
     ++channels[channel].total_views;
     ++channels[channel].direction_views[direction];
@@ -236,6 +239,9 @@ void sound_city_mark_construction_site_view(int direction)
         return;
     }
 
+    if (!channels[channel].available) {
+        sound_device_preload_channel(channels[channel].channel + CITY_CHANNEL_OFFSET);
+    }
     channels[channel].available = 1;
     ++channels[channel].total_views;
     ++channels[channel].direction_views[direction];
@@ -7,6 +7,24 @@ void sound_device_open(void);
 void sound_device_close(void);
 
 void sound_device_init_channels(int num_channels, char filenames[][CHANNEL_FILENAME_MAX]);
+
+/**
+ * Starts loading the file of a channel in the background, so that it is ready when the channel is played.
+ * Loaded files are kept in a cache of limited size, from which the least recently used files are removed.
+ * @param channel Channel to load
+ */
+void sound_device_preload_channel(int channel);
+
+/**
+ * Makes the files loaded in the background available, and starts the channels that were waiting for them
+ */
+void sound_device_update(void);
+
+/**
+ * Checks whether a channel is playing, or waiting for its file to start playing
+ * @param channel Channel to check
+ * @return Boolean true if the channel is playing
+ */
 int sound_device_is_channel_playing(int channel);
 
 void sound_device_set_music_volume(int volume_pct);
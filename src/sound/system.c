@@ -191,6 +191,9 @@ void sound_system_init(void)
 
     sound_device_open();
     sound_device_init_channels(SOUND_CHANNEL_MAX, channel_filenames);
+    for (int i = SOUND_CHANNEL_EFFECTS_MIN; i <= SOUND_CHANNEL_EFFECTS_MAX; i++) {
+        sound_device_preload_channel(i);
+    }
 
     sound_city_set_volume(setting_sound(SOUND_CITY)->volume);
     sound_effect_set_volume(setting_sound(SOUND_EFFECTS)->volume);
@@ -198,6 +201,11 @@ void sound_system_init(void)
     sound_speech_set_volume(setting_sound(SOUND_SPEECH)->volume);
 }
 
+void sound_system_update(void)
+{
+    sound_device_update();
+}
+
 void sound_system_shutdown(void)
 {
     sound_device_close();
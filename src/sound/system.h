@@ -3,6 +3,11 @@
 
 void sound_system_init(void);
 
+/**
+ * Starts sounds that were waiting for their files to load, call once per frame
+ */
+void sound_system_update(void);
+
 void sound_system_shutdown(void);
 
 #endif // SOUND_SYSTEM_H
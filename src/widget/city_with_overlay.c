@@ -11,6 +11,7 @@
 #include "figure/roamer_preview.h"
 #include "game/resource.h"
 #include "game/state.h"
+#include "game/tick.h"
 #include "graphics/graphics.h"
 #include "graphics/image.h"
 #include "graphics/renderer.h"
@@ -35,10 +36,30 @@
 #include "widget/city_overlay_risks.h"
 #include "widget/city_without_overlay.h"
 #include "widget/city_draw_highway.h"
+#include "widget/minimap.h"
+
+#include <stdlib.h>
+
+#define BUILDING_SHOWN -2
+
+typedef struct {
+    unsigned int stamp;
+    building_type type;
+    int state;
+    int value;
+} overlay_value;
 
 static const city_overlay *overlay = 0;
 static float scale = SCALE_NONE;
 
+static struct {
+    overlay_value *buildings;
+    int capacity;
+    unsigned int stamp;
+    unsigned int tick_id;
+    int overlay_type;
+} values;
+
 #define OFFSET(x,y) (x + GRID_SIZE * y)
 
 static const int ADJACENT_OFFSETS[2][4][7] = {
@@ -136,9 +157,63 @@ static int select_city_overlay(void)
     return overlay != 0;
 }
 
+static void invalidate_values(void)
+{
+    values.stamp++;
+    if (!values.stamp) {
+        values.stamp++;
+    }
+}
+
+static void refresh_values(void)
+{
+    if (values.tick_id != game_tick_id() || values.overlay_type != overlay->type) {
+        values.tick_id = game_tick_id();
+        values.overlay_type = overlay->type;
+        invalidate_values();
+    }
+}
+
+static int calculate_value(building *b)
+{
+    if (overlay->type == OVERLAY_PROBLEMS) {
+        city_overlay_problems_prepare_building(b);
+    }
+    if (overlay->show_building(b)) {
+        return BUILDING_SHOWN;
+    }
+    return overlay->get_column_height(b);
+}
+
+static int get_building_value(building *b)
+{
+    if (b->id >= values.capacity) {
+        int capacity = building_count();
+        overlay_value *buildings = realloc(values.buildings, sizeof(overlay_value) * capacity);
+        if (!buildings) {
+            return calculate_value(b);
+        }
+        for (int i = values.capacity; i < capacity; i++) {
+            buildings[i].stamp = 0;
+        }
+        values.buildings = buildings;
+        values.capacity = capacity;
+    }
+    overlay_value *value = &values.buildings[b->id];
+    if (value->stamp != values.stamp || value->type != b->type || value->state != b->state) {
+        value->value = calculate_value(b);
+        value->stamp = values.stamp;
+        value->type = b->type;
+        value->state = b->state;
+    }
+    return value->value;
+}
+
 void city_with_overlay_update(void)
 {
     select_city_overlay();
+    invalidate_values();
+    widget_minimap_invalidate();
 }
 
 static int is_drawable_farmhouse(int grid_offset, int map_orientation)
@@ -329,10 +404,7 @@ void city_with_overlay_draw_building_footprint(int x, int y, int grid_offset, in
         return;
     }
     building *b = building_get(building_id);
-    if (overlay->type == OVERLAY_PROBLEMS) {
-        city_overlay_problems_prepare_building(b);
-    }
-    if (overlay->show_building(b)) {
+    if (get_building_value(b) == BUILDING_SHOWN) {
         if (building_is_farm(b->type)) {
             if (is_drawable_farmhouse(grid_offset, city_view_orientation())) {
                 image_draw_isometric_footprint_from_draw_tile(map_image_at(grid_offset), x, y, 0, scale);
@@ -493,10 +565,10 @@ static void draw_building_top(int grid_offset, building *b, int x, int y)
 void city_with_overlay_draw_building_top(int x, int y, int grid_offset)
 {
     building *b = building_get(map_building_at(grid_offset));
-    if (overlay->show_building(b)) {
+    int column_height = get_building_value(b);
+    if (column_height == BUILDING_SHOWN) {
         draw_building_top(grid_offset, b, x, y);
     } else {
-        int column_height = overlay->get_column_height(b);
         if (column_height != NO_COLUMN) {
             int draw = 1;
             if (building_is_farm(b->type)) {
@@ -663,6 +735,7 @@ void city_with_overlay_draw(const map_tile *tile)
     }
 
     scale = city_view_get_scale() / 100.0f;
+    refresh_values();
 
     int x, y, width, height;
     city_view_get_viewport(&x, &y, &width, &height);
@@ -689,6 +762,42 @@ void city_with_overlay_draw(const map_tile *tile)
     }
 }
 
+int city_with_overlay_get_minimap_color(building *b, color_t *color)
+{
+    if (!select_city_overlay()) {
+        return 0;
+    }
+    refresh_values();
+    int column_height = get_building_value(b);
+    if (column_height == BUILDING_SHOWN) {
+        return 0;
+    }
+    if (column_height == NO_COLUMN) {
+        *color = COLOR_MINIMAP_OVERLAY_NONE;
+        return 1;
+    }
+    if (column_height > 10) {
+        column_height = 10;
+    }
+    // match the column colors used by draw_overlay_column
+    color_t alpha = column_height * 0xff / 10;
+    switch (overlay->column_type) {
+        case COLUMN_COLOR_RED:
+            *color = COLOR_MINIMAP_OVERLAY_RED;
+            break;
+        case COLUMN_COLOR_GREEN_TO_RED:
+            *color = COLOR_BLEND_ALPHA_TO_OPAQUE(COLOR_MINIMAP_OVERLAY_GREEN, COLOR_MINIMAP_OVERLAY_RED, alpha);
+            break;
+        case COLUMN_COLOR_RED_TO_GREEN:
+            *color = COLOR_BLEND_ALPHA_TO_OPAQUE(COLOR_MINIMAP_OVERLAY_RED, COLOR_MINIMAP_OVERLAY_GREEN, alpha);
+            break;
+        default:
+            *color = COLOR_MINIMAP_OVERLAY_GREEN;
+            break;
+    }
+    return 1;
+}
+
 int city_with_overlay_get_tooltip_text(tooltip_context *c, int grid_offset)
 {
     int overlay_type = overlay->type;
@@ -1,6 +1,8 @@
 #ifndef WIDGET_CITY_WITH_OVERLAY_H
 #define WIDGET_CITY_WITH_OVERLAY_H
 
+#include "building/building.h"
+#include "graphics/color.h"
 #include "graphics/tooltip.h"
 #include "map/point.h"
 
@@ -13,4 +15,13 @@ void city_with_overlay_draw(const map_tile *tile);
 
 int city_with_overlay_get_tooltip_text(tooltip_context *c, int grid_offset);
 
+/**
+ * Gets the color of a building on the minimap for the current overlay.
+ * Uses the same per-tick overlay values as the city view.
+ * @param b Building to get the color for
+ * @param color Color of the building, only set if the overlay colors the building
+ * @return Boolean true if the overlay colors the building, false if it should be drawn as usual
+ */
+int city_with_overlay_get_minimap_color(building *b, color_t *color);
+
 #endif // WIDGET_CITY_WITH_OVERLAY_H
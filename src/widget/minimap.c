@@ -16,6 +16,7 @@
 #include "map/property.h"
 #include "map/random.h"
 #include "map/terrain.h"
+#include "widget/city_with_overlay.h"
 
 #include <stdlib.h>
 #include <string.h>
@@ -61,7 +62,8 @@ static minimap_functions default_functions = {
     .offset.tile_size = map_property_multi_tile_size,
     .offset.random = map_random_get,
     .building = building_get,
-    .viewport = get_viewport
+    .viewport = get_viewport,
+    .overlay_color = city_with_overlay_get_minimap_color
 };
 
 static const tile_color_climate_variants CLIMATE_VARIANTS[3] = {
@@ -349,18 +351,22 @@ static void draw_building(int x_offset, int y_offset, int grid_offset)
     }
 
     const building_tile_color *colors = &minimap_colors.building;
+    building_tile_color overlay_colors;
     int size = data.functions->offset.tile_size(grid_offset);
 
     if (data.functions->building) {
         building *b = data.functions->building(data.functions->offset.building_id(grid_offset));
-
-        // Palisades are drawn like walls
-        if (b->type == BUILDING_PALISADE) {
+        color_t overlay_color;
+
+        if (data.functions->overlay_color && data.functions->overlay_color(b, &overlay_color)) {
+            overlay_colors.edges.left = overlay_colors.edges.right = overlay_color;
+            overlay_colors.center.left = overlay_colors.center.right = overlay_color;
+            colors = &overlay_colors;
+        } else if (b->type == BUILDING_PALISADE) {
+            // Palisades are drawn like walls
             draw_tile(x_offset, y_offset, &minimap_colors.wall);
             return;
-        }
-
-        if (b->house_size) {
+        } else if (b->house_size) {
             colors = &minimap_colors.house;
         } else if (building_is_water_structure(b->type)) {
             colors = &minimap_colors.water_structure;
@@ -3,6 +3,7 @@
 
 #include "building/building.h"
 #include "figure/figure.h"
+#include "graphics/color.h"
 #include "input/mouse.h"
 #include "scenario/property.h"
 
@@ -22,6 +23,7 @@ typedef struct {
         int (*random)(int grid_offset);
     } offset;
     void (*viewport)(int *x, int *y, int *width, int *height);
+    int (*overlay_color)(building *b, color_t *color);
 } minimap_functions;
 
 void widget_minimap_invalidate(void);
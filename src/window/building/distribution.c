@@ -19,6 +19,7 @@
 #include "empire/city.h"
 #include "empire/object.h"
 #include "figure/figure.h"
+#include "game/replay.h"
 #include "graphics/generic_button.h"
 #include "graphics/image.h"
 #include "graphics/image_button.h"
@@ -1286,6 +1287,8 @@ static void market_orders(int index, int param2)
 {
     building *b = building_get(data.building_id);
     if (index == 0) {
+        // Construction also clears the goods, so the command is recorded here instead of in the building code
+        game_replay_record_command(REPLAY_COMMAND_MARKET_ACCEPT_NONE, b->id, 0);
         building_distribution_unaccept_all_goods(b);
     }
     window_invalidate();
@@ -1322,6 +1325,7 @@ static void button_stockpiling(int param1, int param2)
 
 static void dock_toggle_route(int route_id, int city_id)
 {
+    game_replay_record_unsupported_command("dock trade route");
     int can_trade = building_dock_can_trade_with_route(route_id, data.building_id);
     building_dock_set_can_trade_with_route(route_id, data.building_id, !can_trade);
     window_invalidate();
@@ -1333,6 +1337,7 @@ static void granary_orders(int index, int param2)
     if (index == 0) {
         building_storage_toggle_empty_all(storage_id);
     } else if (index == 1) {
+        game_replay_record_command(REPLAY_COMMAND_STORAGE_ACCEPT_NONE, storage_id, 0);
         building_storage_accept_none(storage_id);
     }
     window_invalidate();
@@ -1345,6 +1350,7 @@ static void warehouse_orders(int index, int param2)
         building_storage_toggle_empty_all(storage_id);
     } else if (index == 1) {
         int storage_id = building_get(data.building_id)->storage_id;
+        game_replay_record_command(REPLAY_COMMAND_STORAGE_ACCEPT_NONE, storage_id, 0);
         building_storage_accept_none(storage_id);
     }
     window_invalidate();
@@ -445,7 +445,7 @@ static void button_ok_cancel(int is_ok, int param2)
             if (!file_has_extension(filename, saved_game_data_expanded.extension)) {
                 file_append_extension(filename, saved_game_data_expanded.extension);
             }
-            if (!game_file_write_saved_game(filename)) {
+            if (!game_file_write_saved_game(filename, SAVED_GAME_COMPRESSION_SMALL)) {
                 window_plain_message_dialog_show(TR_SAVEGAME_NOT_ABLE_TO_SAVE_TITLE,
                     TR_SAVEGAME_NOT_ABLE_TO_SAVE_MESSAGE, 1);
                 return;
@@ -4,6 +4,7 @@
 #include "city/finance.h"
 #include "city/ratings.h"
 #include "city/victory.h"
+#include "game/replay.h"
 #include "game/resource.h"
 #include "graphics/generic_button.h"
 #include "graphics/graphics.h"
@@ -101,6 +102,7 @@ static void button_cancel(int param1, int param2)
 static void button_set_salary(int rank, int param2)
 {
     if (!city_victory_has_won()) {
+        game_replay_record_command(REPLAY_COMMAND_SET_SALARY, rank, 0);
         city_emperor_set_salary_rank(rank);
         city_finance_update_salary();
         city_ratings_update_favor_explanation();
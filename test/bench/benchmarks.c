@@ -0,0 +1,238 @@
+#include "city/labor.h"
+#include "core/job.h"
+#include "game/file.h"
+#include "game/file_io.h"
+#include "game/game.h"
+#include "game/tick.h"
+#include "map/data.h"
+#include "map/desirability.h"
+#include "map/grid.h"
+#include "map/routing.h"
+#include "map/terrain.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define LOAD_RUNS 5
+#define SAVE_RUNS 3
+#define PHASE_RUNS 20
+#define ROUTE_QUERIES 200
+#define TICK_WINDOWS 5
+#define TICKS_PER_WINDOW 200
+
+#define BENCHMARK_SAVE_FILE "benchmark-output.sav"
+
+typedef struct {
+    double load_ms;
+    double save_ms[2];
+    long save_bytes[2];
+    double desirability_update_ms;
+    double labor_update_ms;
+    double route_queries_per_second;
+    double ticks_per_second[TICK_WINDOWS];
+} benchmark_result;
+
+static double now_ms(void)
+{
+#ifdef _WIN32
+    LARGE_INTEGER frequency, counter;
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+    return counter.QuadPart * 1000.0 / frequency.QuadPart;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+#endif
+}
+
+static long file_size(const char *filename)
+{
+    FILE *fp = fopen(filename, "rb");
+    if (!fp) {
+        return 0;
+    }
+    fseek(fp, 0, SEEK_END);
+    long size = ftell(fp);
+    fclose(fp);
+    return size;
+}
+
+static int benchmark_load(const char *saved_game, benchmark_result *result)
+{
+    double start = now_ms();
+    for (int i = 0; i < LOAD_RUNS; i++) {
+        if (game_file_load_saved_game(saved_game) != 1) {
+            return 0;
+        }
+    }
+    result->load_ms = (now_ms() - start) / LOAD_RUNS;
+    return 1;
+}
+
+static void benchmark_save(benchmark_result *result)
+{
+    const saved_game_compression compressions[] = { SAVED_GAME_COMPRESSION_FAST, SAVED_GAME_COMPRESSION_SMALL };
+    for (int c = 0; c < 2; c++) {
+        double start = now_ms();
+        for (int i = 0; i < SAVE_RUNS; i++) {
+            game_file_io_write_saved_game(BENCHMARK_SAVE_FILE, compressions[c]);
+        }
+        result->save_ms[c] = (now_ms() - start) / SAVE_RUNS;
+        result->save_bytes[c] = file_size(BENCHMARK_SAVE_FILE);
+    }
+    remove(BENCHMARK_SAVE_FILE);
+}
+
+static double time_phase(void (*phase)(void))
+{
+    double start = now_ms();
+    for (int i = 0; i < PHASE_RUNS; i++) {
+        phase();
+    }
+    return (now_ms() - start) / PHASE_RUNS;
+}
+
+// Routes start from roads spread over the whole map, or from the middle of a map without roads
+static void benchmark_routing(benchmark_result *result)
+{
+    static int road_offsets[ROUTE_QUERIES];
+    int num_roads = 0;
+    int num_tiles = 0;
+    for (int y = 0; y < map_data.height; y++) {
+        for (int x = 0; x < map_data.width; x++) {
+            if (map_terrain_is(map_grid_offset(x, y), TERRAIN_ROAD)) {
+                num_tiles++;
+            }
+        }
+    }
+    int step = num_tiles / ROUTE_QUERIES + 1;
+    int tile = 0;
+    for (int y = 0; y < map_data.height; y++) {
+        for (int x = 0; x < map_data.width && num_roads < ROUTE_QUERIES; x++) {
+            int grid_offset = map_grid_offset(x, y);
+            if (map_terrain_is(grid_offset, TERRAIN_ROAD) && tile++ % step == 0) {
+                road_offsets[num_roads++] = grid_offset;
+            }
+        }
+    }
+    double start = now_ms();
+    for (int i = 0; i < ROUTE_QUERIES; i++) {
+        if (num_roads) {
+            int grid_offset = road_offsets[i % num_roads];
+            map_routing_calculate_distances(map_grid_offset_to_x(grid_offset), map_grid_offset_to_y(grid_offset));
+        } else {
+            map_routing_calculate_distances(map_data.width / 2, map_data.height / 2);
+        }
+    }
+    double elapsed = now_ms() - start;
+    result->route_queries_per_second = elapsed > 0 ? ROUTE_QUERIES * 1000.0 / elapsed : 0;
+}
+
+static void benchmark_ticks(benchmark_result *result)
+{
+    for (int window = 0; window < TICK_WINDOWS; window++) {
+        double start = now_ms();
+        for (int i = 0; i < TICKS_PER_WINDOW; i++) {
+            game_tick_run();
+        }
+        double elapsed = now_ms() - start;
+        result->ticks_per_second[window] = elapsed > 0 ? TICKS_PER_WINDOW * 1000.0 / elapsed : 0;
+    }
+}
+
+static int run_benchmarks(const char *saved_game, benchmark_result *result)
+{
+    if (!benchmark_load(saved_game, result)) {
+        return 0;
+    }
+    benchmark_save(result);
+    result->desirability_update_ms = time_phase(map_desirability_update);
+    result->labor_update_ms = time_phase(city_labor_update);
+    benchmark_routing(result);
+
+    // The phases above changed the city, so the ticks start from the saved game again
+    if (game_file_load_saved_game(saved_game) != 1) {
+        return 0;
+    }
+    benchmark_ticks(result);
+    return 1;
+}
+
+static void write_json_string(FILE *fp, const char *str)
+{
+    fputc('"', fp);
+    for (const unsigned char *c = (const unsigned char *) str; *c; c++) {
+        if (*c == '"' || *c == '\\') {
+            fprintf(fp, "\\%c", *c);
+        } else if (*c < 0x20) {
+            fprintf(fp, "\\u%04x", *c);
+        } else {
+            fputc(*c, fp);
+        }
+    }
+    fputc('"', fp);
+}
+
+static void write_result(FILE *fp, const char *saved_game, const benchmark_result *result, int ok)
+{
+    fprintf(fp, "    {\n      \"saved_game\": ");
+    write_json_string(fp, saved_game);
+    fprintf(fp, ",\n");
+    if (!ok) {
+        fprintf(fp, "      \"error\": \"Unable to load saved game\"\n    }");
+        return;
+    }
+    fprintf(fp, "      \"load_ms\": %.3f,\n", result->load_ms);
+    fprintf(fp, "      \"save_fast_ms\": %.3f,\n", result->save_ms[0]);
+    fprintf(fp, "      \"save_fast_bytes\": %ld,\n", result->save_bytes[0]);
+    fprintf(fp, "      \"save_small_ms\": %.3f,\n", result->save_ms[1]);
+    fprintf(fp, "      \"save_small_bytes\": %ld,\n", result->save_bytes[1]);
+    fprintf(fp, "      \"desirability_update_ms\": %.3f,\n", result->desirability_update_ms);
+    fprintf(fp, "      \"labor_update_ms\": %.3f,\n", result->labor_update_ms);
+    fprintf(fp, "      \"route_queries_per_second\": %.1f,\n", result->route_queries_per_second);
+    fprintf(fp, "      \"ticks_per_window\": %d,\n", TICKS_PER_WINDOW);
+    fprintf(fp, "      \"ticks_per_second\": [");
+    for (int i = 0; i < TICK_WINDOWS; i++) {
+        fprintf(fp, "%s%.1f", i ? ", " : "", result->ticks_per_second[i]);
+    }
+    fprintf(fp, "]\n    }");
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 3) {
+        printf("Usage: %s OUTPUT.json SAVED_GAME...\n", argv[0]);
+        printf("The jobs run on one thread per CPU, or on the number of threads in TEST_THREADS\n");
+        return 1;
+    }
+    if (!game_pre_init() || !game_init()) {
+        printf("Unable to initialize the game\n");
+        return 1;
+    }
+    FILE *fp = fopen(argv[1], "w");
+    if (!fp) {
+        printf("Unable to write %s\n", argv[1]);
+        return 1;
+    }
+    int failed = 0;
+    fprintf(fp, "{\n  \"threads\": %d,\n  \"benchmarks\": [\n", job_system_num_threads());
+    for (int i = 2; i < argc; i++) {
+        benchmark_result result = { 0 };
+        printf("Running benchmarks for %s\n", argv[i]);
+        int ok = run_benchmarks(argv[i], &result);
+        failed |= !ok;
+        write_result(fp, argv[i], &result, ok);
+        fprintf(fp, i + 1 < argc ? ",\n" : "\n");
+    }
+    fprintf(fp, "  ]\n}\n");
+    fclose(fp);
+    game_exit();
+    return failed;
+}
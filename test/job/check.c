@@ -0,0 +1,128 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "core/job.h"
+
+#define NUM_ITEMS 100000
+#define MIN_ITEMS_PER_CHUNK 1000
+#define NUM_DATA_SETS 4
+#define NUM_STEPS 24
+#define STEP_ITERATIONS 20000
+#define BATCH_RUNS 50
+#define SKIPPED 77
+
+typedef struct {
+    int index;
+    int read_set;
+    int write_set;
+} step;
+
+static uint32_t items[NUM_ITEMS];
+static uint64_t chunk_sums[JOB_MAX_CHUNKS];
+static uint64_t values[NUM_DATA_SETS];
+
+static uint32_t item_value(int index)
+{
+    return (uint32_t) index * 2654435761u;
+}
+
+static void fill_chunk(int chunk, int start, int end, void *data)
+{
+    for (int i = start; i < end; i++) {
+        items[i] += item_value(i);
+        chunk_sums[chunk] += items[i];
+    }
+}
+
+static int check_parallel_for(void)
+{
+    memset(items, 0, sizeof(items));
+    memset(chunk_sums, 0, sizeof(chunk_sums));
+    job_parallel_for(NUM_ITEMS, MIN_ITEMS_PER_CHUNK, fill_chunk, 0);
+
+    uint64_t expected_sum = 0;
+    for (int i = 0; i < NUM_ITEMS; i++) {
+        if (items[i] != item_value(i)) {
+            printf("Item %d was not visited exactly once\n", i);
+            return 0;
+        }
+        expected_sum += item_value(i);
+    }
+    uint64_t sum = 0;
+    for (int chunk = 0; chunk < job_parallel_for_num_chunks(NUM_ITEMS, MIN_ITEMS_PER_CHUNK); chunk++) {
+        sum += chunk_sums[chunk];
+    }
+    if (sum != expected_sum) {
+        printf("Sum of the chunks is different: %llu <--> %llu\n",
+            (unsigned long long) sum, (unsigned long long) expected_sum);
+        return 0;
+    }
+    return 1;
+}
+
+// Each step mixes one data set into another, long enough for the steps of a batch to overlap
+static void run_step(void *data)
+{
+    const step *s = data;
+    uint64_t value = values[s->write_set];
+    for (int i = 0; i < STEP_ITERATIONS; i++) {
+        value = value * 6364136223846793005u + values[s->read_set] + s->index;
+    }
+    values[s->write_set] = value;
+}
+
+static int check_batch(int run)
+{
+    step steps[NUM_STEPS];
+    job jobs[NUM_STEPS];
+    for (int i = 0; i < NUM_STEPS; i++) {
+        steps[i].index = i;
+        steps[i].read_set = (i * 3 + run) % NUM_DATA_SETS;
+        steps[i].write_set = (i * 5 + run / 2) % NUM_DATA_SETS;
+        jobs[i].function = run_step;
+        jobs[i].data = &steps[i];
+        jobs[i].reads = 1u << steps[i].read_set;
+        jobs[i].writes = 1u << steps[i].write_set;
+    }
+
+    for (int i = 0; i < NUM_DATA_SETS; i++) {
+        values[i] = i + 1;
+    }
+    for (int i = 0; i < NUM_STEPS; i++) {
+        run_step(&steps[i]);
+    }
+    uint64_t expected[NUM_DATA_SETS];
+    memcpy(expected, values, sizeof(values));
+
+    for (int i = 0; i < NUM_DATA_SETS; i++) {
+        values[i] = i + 1;
+    }
+    job_run_batch(jobs, NUM_STEPS);
+    for (int i = 0; i < NUM_DATA_SETS; i++) {
+        if (values[i] != expected[i]) {
+            printf("Batch %d: data set %d is different from the serial run\n", run, i);
+            return 0;
+        }
+    }
+    return 1;
+}
+
+int main(void)
+{
+    job_system_init();
+    int threads = job_system_num_threads();
+    printf("Job system threads: %d\n", threads);
+    if (threads <= 1) {
+        printf("Only one thread available, nothing to compare with the serial run\n");
+        job_system_shutdown();
+        return SKIPPED;
+    }
+    int ok = check_parallel_for();
+    for (int run = 0; ok && run < BATCH_RUNS; run++) {
+        ok = check_batch(run);
+    }
+    job_system_shutdown();
+    printf("%s\n", ok ? "Done" : "Failed");
+    return ok ? 0 : 1;
+}
@@ -1,4 +1,4 @@
-#include "core/backtrace.h"
+#include "core/random.h"
 #include "core/time.h"
 #include "game/file.h"
 #include "game/game.h"
@@ -15,12 +15,12 @@
 #include <signal.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 #include "sav_compare.h"
 
 static void handler(int sig)
 {
     fprintf(stderr, "Oops, crashed with signal %d :(", sig);
-    backtrace_print();
     exit(1);
 }
 
@@ -58,9 +58,14 @@ static int run_autopilot(const char *input_saved_game, const char *output_saved_
         }
         return 3;
     }
+    // Walkers that pick random destinations must do the same in every run for the saves to match
+    random_set_stdlib_seed(12345);
     run_ticks(ticks_to_run);
     printf("Saving game to %s\n", output_saved_game);
-    game_file_write_saved_game(output_saved_game);
+    if (!game_file_write_saved_game(output_saved_game, SAVED_GAME_COMPRESSION_SMALL)) {
+        printf("Unable to save game\n");
+        return 4;
+    }
     printf("Done\n");
 
     game_exit();
@@ -79,6 +84,10 @@ int main(int argc, char **argv)
     const char *expected = argv[3];
     int ticks = atoi(argv[4]);
     if (run_autopilot(input, output, ticks) == 0) {
+        if (strcmp(expected, "-") == 0) {
+            // Nothing to compare against: the run only has to load, tick and save
+            return 0;
+        }
         return compare_files(expected, output);
     } else {
         return 1;
@@ -1,14 +1,35 @@
+#include "../src/core/rle.h"
 #include "../src/core/zip.h"
+#include "../src/core/zlib_helper.h"
 #include "../src/figure/type.h"
 #include "../src/map/grid.h"
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
 #define SAVEGAME_PARTS 300
 #define COMPRESS_BUFFER_SIZE 600000
 #define UNCOMPRESSED 0x80000000
 
+// Newer saved games start with four pieces of four bytes, followed by a table with the position of every piece
+#define LAST_SEQUENTIAL_PIECES_VERSION 0x93
+#define PIECE_TABLE_OFFSET 16
+#define PIECE_TABLE_ENTRY_SIZE 24
+#define MAX_PIECES 100
+
+enum {
+    PIECE_STORED_RAW = 0,
+    PIECE_STORED_ZLIB = 1,
+    PIECE_STORED_RLE = 2
+};
+
+typedef struct {
+    int num_pieces;
+    unsigned char *data[MAX_PIECES];
+    int size[MAX_PIECES];
+} piece_file;
+
 struct game_file_part {
     int compressed;
     int length_in_bytes;
@@ -235,6 +256,29 @@ static struct game_file_part save_game_parts[] = {
     {0, 0, ""},
 };
 
+// Names of the pieces of the current piece table layout, in saving order.
+// Saved games with another number of pieces are reported by piece index only.
+static const char *piece_names[] = {
+    "scenario_campaign_mission", "file_version", "resource_version", "scenario_version", "edge_grid",
+    "building_grid", "terrain_grid", "aqueduct_grid", "figure_grid", "bitfields_grid", "sprite_grid", "random_grid",
+    "desirability_grid", "elevation_grid", "building_damage_grid", "aqueduct_backup_grid", "sprite_backup_grid",
+    "figures", "route_figures", "route_paths", "formations", "formation_totals", "city_data", "player_name",
+    "buildings", "city_view_orientation", "game_time", "building_extra_highest_id_ever", "random_iv", "camera",
+    "city_graph_order", "emperor_change_time", "empire", "empire_cities", "trade_prices", "figure_names",
+    "culture_coverage", "scenario", "max_game_year", "earthquake", "emperor_change_state", "messages",
+    "message_extra", "population_messages", "message_counts", "message_delays", "building_list_burning_totals",
+    "figure_sequence", "scenario_settings", "invasion_warnings", "scenario_is_custom", "city_sounds",
+    "building_extra_highest_id", "figure_traders", "building_list_burning", "building_list_small",
+    "building_list_large", "tutorial_part1", "enemy_army_totals", "building_storages", "tutorial_part2",
+    "gladiator_revolt", "trade_route_limit", "trade_route_traded", "building_extra_sequence", "routing_counters",
+    "enemy_armies", "city_entry_exit_xy", "last_invasion_id", "building_extra_corrupt_houses", "scenario_name",
+    "bookmarks", "tutorial_part3", "city_entry_exit_grid_offset", "end_marker", "deliveries", "custom_empire",
+    "visited_buildings",
+};
+
+// Pieces that start with the size of each of their records
+static const char *piece_names_with_records[] = { "figures", "buildings", "building_storages" };
+
 static char compress_buffer[COMPRESS_BUFFER_SIZE];
 static unsigned char file1_data[1300000];
 static unsigned char file2_data[1300000];
@@ -465,15 +509,16 @@ static int is_exception_figures(int global_offset, int part_offset)
     return 1;
 }
 
+// Parts that are skipped entirely, in both the old and the piece table layouts
+static int is_ignored_part(const char *name)
+{
+    return strcmp(name, "city_sounds") == 0 || strcmp(name, "sprite_backup_grid") == 0 ||
+        strcmp(name, "camera") == 0;
+}
+
 static int is_exception(int index, int global_offset, int part_offset)
 {
-    if (index == index_of_part("city_sounds")) {
-        return 1;
-    }
-    if (index == index_of_part("sprite_backup_grid")) {
-        return 1;
-    }
-    if (index == index_of_part("camera")) {
+    if (is_ignored_part(save_game_parts[index].name)) {
         return 1;
     }
     if (index == index_of_part("image_grid")) {
@@ -576,8 +621,169 @@ static int compare(void)
     return different;
 }
 
+static int get_file_version(const char *filename)
+{
+    FILE *fp = fopen(filename, "rb");
+    if (!fp) {
+        return 0;
+    }
+    unsigned char header[8];
+    int version = fread(header, 1, 8, fp) == 8 ? (int) to_uint(&header[4]) : 0;
+    fclose(fp);
+    return version;
+}
+
+static int decode_piece(const unsigned char *stored, int stored_size, int storage, unsigned char *data, int size)
+{
+    int output_size = 0;
+    switch (storage) {
+        case PIECE_STORED_RAW:
+            memcpy(data, stored, size);
+            return stored_size == size;
+        case PIECE_STORED_ZLIB:
+            return zlib_helper_decompress((void *) stored, stored_size, data, size, &output_size);
+        case PIECE_STORED_RLE:
+            return rle_decompress(stored, stored_size, data, size);
+        default:
+            return 0;
+    }
+}
+
+static void free_pieces(piece_file *file)
+{
+    for (int i = 0; i < file->num_pieces; i++) {
+        free(file->data[i]);
+        file->data[i] = 0;
+    }
+    file->num_pieces = 0;
+}
+
+// The checksums in the piece table are not verified: a corrupt piece fails to decompress or shows up as a difference
+static int unpack_pieces(const char *filename, piece_file *file)
+{
+    file->num_pieces = 0;
+    FILE *fp = fopen(filename, "rb");
+    if (!fp) {
+        printf("Unable to open file %s\n", filename);
+        return 0;
+    }
+    fseek(fp, 0, SEEK_END);
+    long length = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    unsigned char *contents = malloc(length);
+    int result = contents && fread(contents, 1, length, fp) == length && length >= PIECE_TABLE_OFFSET + 4;
+    fclose(fp);
+    int num_pieces = result ? (int) to_uint(&contents[PIECE_TABLE_OFFSET]) : 0;
+    if (num_pieces <= 0 || num_pieces > MAX_PIECES ||
+        PIECE_TABLE_OFFSET + 4 + num_pieces * PIECE_TABLE_ENTRY_SIZE > length) {
+        result = 0;
+    }
+    for (int i = 0; result && i < num_pieces; i++) {
+        const unsigned char *entry = &contents[PIECE_TABLE_OFFSET + 4 + i * PIECE_TABLE_ENTRY_SIZE];
+        unsigned int offset = to_uint(&entry[0]);
+        unsigned int stored_size = to_uint(&entry[4]);
+        unsigned int size = to_uint(&entry[8]);
+        unsigned int storage = to_uint(&entry[12]);
+        if (offset > length || stored_size > length - offset) {
+            result = 0;
+            break;
+        }
+        file->data[i] = malloc(size ? size : 1);
+        file->size[i] = size;
+        file->num_pieces++;
+        result = file->data[i] && decode_piece(&contents[offset], stored_size, storage, file->data[i], size);
+    }
+    free(contents);
+    if (!result) {
+        printf("Error while loading file %s\n", filename);
+        free_pieces(file);
+    }
+    return result;
+}
+
+static const char *piece_name(const piece_file *file, int index)
+{
+    int num_names = sizeof(piece_names) / sizeof(piece_names[0]);
+    return file->num_pieces == num_names ? piece_names[index] : "";
+}
+
+static int piece_record_length(const piece_file *file, int index)
+{
+    const char *name = piece_name(file, index);
+    for (int i = 0; i < sizeof(piece_names_with_records) / sizeof(piece_names_with_records[0]); i++) {
+        if (strcmp(name, piece_names_with_records[i]) == 0) {
+            return file->size[index] >= 4 ? (int) to_uint(file->data[index]) : 0;
+        }
+    }
+    return 0;
+}
+
+static int compare_piece(const piece_file *file1, const piece_file *file2, int index)
+{
+    const char *name = piece_name(file1, index);
+    if (is_ignored_part(name)) {
+        return 0;
+    }
+    if (file1->size[index] != file2->size[index]) {
+        printf("Piece %d [%s]: sizes are different: %d <--> %d\n", index, name, file1->size[index], file2->size[index]);
+        return 1;
+    }
+    int record_length = piece_record_length(file1, index);
+    int different = 0;
+    for (int i = 0; i < file1->size[index]; i++) {
+        if (file1->data[index][i] == file2->data[index][i]) {
+            continue;
+        }
+        different = 1;
+        printf("Piece %d [%s] (%d) ", index, name, i);
+        if (record_length > 0 && i >= 4) {
+            printf("record %d offset 0x%X", (i - 4) / record_length, (i - 4) % record_length);
+        } else {
+            printf("offset %d", i);
+        }
+        printf(": %d <-> %d\n", file1->data[index][i], file2->data[index][i]);
+    }
+    return different;
+}
+
+static int compare_pieces(const piece_file *file1, const piece_file *file2)
+{
+    if (file1->num_pieces != file2->num_pieces) {
+        printf("WARN: number of pieces is different: %d <--> %d\n", file1->num_pieces, file2->num_pieces);
+        return 1;
+    }
+    int different = 0;
+    for (int i = 0; i < file1->num_pieces; i++) {
+        different |= compare_piece(file1, file2, i);
+    }
+    return different;
+}
+
+static int compare_piece_files(const char *file1, const char *file2)
+{
+    static piece_file pieces1;
+    static piece_file pieces2;
+    int different = 1;
+    if (unpack_pieces(file1, &pieces1) && unpack_pieces(file2, &pieces2)) {
+        different = compare_pieces(&pieces1, &pieces2);
+    }
+    free_pieces(&pieces1);
+    free_pieces(&pieces2);
+    return different;
+}
+
 int compare_files(const char *file1, const char *file2)
 {
+    int version1 = get_file_version(file1);
+    int version2 = get_file_version(file2);
+    if (version1 > LAST_SEQUENTIAL_PIECES_VERSION && version2 > LAST_SEQUENTIAL_PIECES_VERSION) {
+        return compare_piece_files(file1, file2);
+    }
+    if (version1 > LAST_SEQUENTIAL_PIECES_VERSION || version2 > LAST_SEQUENTIAL_PIECES_VERSION) {
+        printf("WARN: cannot compare a saved game with a piece table to an older one: 0x%X <--> 0x%X\n",
+            version1, version2);
+        return 1;
+    }
     int length1 = unpack(file1, file1_data);
     int length2 = unpack(file2, file2_data);
     if (length1 && length1 == length2) {
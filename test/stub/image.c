@@ -38,7 +38,7 @@ int image_init(void)
     return 1;
 }
 
-int image_load_climate(int climate_id, int is_editor, int force_reload)
+int image_load_climate(int climate_id, int is_editor, int force_reload, int keep_atlas_buffers)
 {
     return 1;
 }
@@ -55,10 +55,44 @@ int image_load_enemy(int enemy_id)
 
 int image_group(int group)
 {
+    if (group >= (int) (sizeof(groups) / sizeof(groups[0]))) {
+        return 0;
+    }
     return groups[group];
 }
 
+static image dummy_image;
+
 const image *image_get(int id)
+{
+    return &dummy_image;
+}
+
+const image *image_get_enemy(int id)
+{
+    return &dummy_image;
+}
+
+int image_is_external(const image *img)
+{
+    return 0;
+}
+
+int image_load_external_pixels(color_t *dst, const image *img, int row_width)
 {
     return 0;
 }
+
+int image_get_external_dimensions(const image *img, int *width, int *height)
+{
+    return 0;
+}
+
+void image_crop(image *img, const color_t *pixels)
+{}
+
+void image_copy(const image_copy_info *copy)
+{}
+
+void image_copy_isometric_footprint(const image_copy_info *copy)
+{}
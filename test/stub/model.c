@@ -162,6 +162,9 @@ int model_load(void)
 
 const model_building *model_get_building(building_type type)
 {
+    if (type >= sizeof(buildings) / sizeof(buildings[0])) {
+        return &buildings[0];
+    }
     return &buildings[type];
 }
 
@@ -169,3 +172,8 @@ const model_house *model_get_house(house_level level)
 {
     return &houses[level];
 }
+
+int model_house_uses_inventory(house_level level, resource_type inventory)
+{
+    return 0;
+}
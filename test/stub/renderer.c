@@ -0,0 +1,38 @@
+#include "graphics/renderer.h"
+
+// Only the functions that the game logic uses are implemented, nothing is ever drawn
+
+static int has_image_atlas(atlas_type type)
+{
+    return 0;
+}
+
+static void free_image_atlas(atlas_type type)
+{}
+
+static const image_atlas_data *get_image_atlas(atlas_type type)
+{
+    return 0;
+}
+
+static void get_max_image_size(int *width, int *height)
+{
+    *width = 4096;
+    *height = 4096;
+}
+
+static void update_scale(int city_scale)
+{}
+
+static const graphics_renderer_interface renderer = {
+    .get_image_atlas = get_image_atlas,
+    .has_image_atlas = has_image_atlas,
+    .free_image_atlas = free_image_atlas,
+    .get_max_image_size = get_max_image_size,
+    .update_scale = update_scale
+};
+
+const graphics_renderer_interface *graphics_renderer(void)
+{
+    return &renderer;
+}
@@ -0,0 +1,172 @@
+#include "platform/thread.h"
+
+#include <stdlib.h>
+
+#ifdef _WIN32
+
+// Without pthreads everything runs on the main thread, so the primitives only need to be valid handles
+static int dummy_primitive;
+
+int platform_thread_cpu_count(void)
+{
+    return 1;
+}
+
+unsigned long platform_thread_current_id(void)
+{
+    return 1;
+}
+
+platform_thread *platform_thread_create(int (*function)(void *data), const char *name, void *data)
+{
+    return 0;
+}
+
+void platform_thread_wait(platform_thread *thread)
+{}
+
+platform_mutex *platform_mutex_create(void)
+{
+    return (platform_mutex *) &dummy_primitive;
+}
+
+void platform_mutex_destroy(platform_mutex *mutex)
+{}
+
+void platform_mutex_lock(platform_mutex *mutex)
+{}
+
+void platform_mutex_unlock(platform_mutex *mutex)
+{}
+
+platform_condition *platform_condition_create(void)
+{
+    return (platform_condition *) &dummy_primitive;
+}
+
+void platform_condition_destroy(platform_condition *condition)
+{}
+
+void platform_condition_wait(platform_condition *condition, platform_mutex *mutex)
+{}
+
+void platform_condition_broadcast(platform_condition *condition)
+{}
+
+#else
+
+#include <pthread.h>
+#include <unistd.h>
+
+typedef struct {
+    pthread_t thread;
+    int (*function)(void *data);
+    void *data;
+} thread_start;
+
+// The number of threads can be forced with the TEST_THREADS environment variable,
+// so that tests can check that the job system gives the same results with any number of workers
+static int threads_from_environment(void)
+{
+    const char *value = getenv("TEST_THREADS");
+    int threads = value ? atoi(value) : 0;
+    return threads > 0 ? threads : 0;
+}
+
+int platform_thread_cpu_count(void)
+{
+    int threads = threads_from_environment();
+    if (threads) {
+        return threads;
+    }
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return count > 0 ? (int) count : 1;
+}
+
+unsigned long platform_thread_current_id(void)
+{
+    return (unsigned long) pthread_self();
+}
+
+static void *run_thread(void *arg)
+{
+    thread_start *start = arg;
+    start->function(start->data);
+    return 0;
+}
+
+platform_thread *platform_thread_create(int (*function)(void *data), const char *name, void *data)
+{
+    thread_start *start = malloc(sizeof(thread_start));
+    if (!start) {
+        return 0;
+    }
+    start->function = function;
+    start->data = data;
+    if (pthread_create(&start->thread, 0, run_thread, start) != 0) {
+        free(start);
+        return 0;
+    }
+    return (platform_thread *) start;
+}
+
+void platform_thread_wait(platform_thread *thread)
+{
+    thread_start *start = (thread_start *) thread;
+    pthread_join(start->thread, 0);
+    free(start);
+}
+
+platform_mutex *platform_mutex_create(void)
+{
+    pthread_mutex_t *mutex = malloc(sizeof(pthread_mutex_t));
+    if (mutex && pthread_mutex_init(mutex, 0) != 0) {
+        free(mutex);
+        return 0;
+    }
+    return (platform_mutex *) mutex;
+}
+
+void platform_mutex_destroy(platform_mutex *mutex)
+{
+    pthread_mutex_destroy((pthread_mutex_t *) mutex);
+    free(mutex);
+}
+
+void platform_mutex_lock(platform_mutex *mutex)
+{
+    pthread_mutex_lock((pthread_mutex_t *) mutex);
+}
+
+void platform_mutex_unlock(platform_mutex *mutex)
+{
+    pthread_mutex_unlock((pthread_mutex_t *) mutex);
+}
+
+platform_condition *platform_condition_create(void)
+{
+    pthread_cond_t *condition = malloc(sizeof(pthread_cond_t));
+    if (condition && pthread_cond_init(condition, 0) != 0) {
+        free(condition);
+        return 0;
+    }
+    return (platform_condition *) condition;
+}
+
+void platform_condition_destroy(platform_condition *condition)
+{
+    pthread_cond_destroy((pthread_cond_t *) condition);
+    free(condition);
+}
+
+void platform_condition_wait(platform_condition *condition, platform_mutex *mutex)
+{
+    pthread_cond_wait((pthread_cond_t *) condition, (pthread_mutex_t *) mutex);
+}
+
+void platform_condition_broadcast(platform_condition *condition)
+{
+    pthread_cond_broadcast((pthread_cond_t *) condition);
+}
+
+#endif